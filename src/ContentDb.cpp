@@ -1,25 +1,61 @@
 
 #include "ContentDb.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <vector>
 
+#include "gas/FuelReader.hpp"
 #include "io/IFileSys.hpp"
 #include "io/StringTool.hpp"
+#include "io/ThreadPool.hpp"
 
+#include <spdlog/fmt/fmt.h>
 #include <spdlog/spdlog.h>
 
 namespace ehb
 {
-    void ContentDb::init(IFileSys& fileSys, const std::string& directory)
+    void ContentDb::init(IFileSys& fileSys, const std::string& directory, unsigned int threads)
     {
         auto log = spdlog::get("log");
         // log->set_level(spdlog::level::debug);
         log->debug("Starting init of ContentDb");
 
-        std::vector<std::unique_ptr<Fuel>> docs;
         std::unordered_map<std::string, FuelBlock*> tmplMap;
 
-        fileSys.eachGasFile(directory, [&docs, &tmplMap](const std::string& filename, auto doc) {
+        attributeIndex.reset();
+        db.clear();
+        docs.clear();
+
+        lazyFileSys = nullptr;
+        pending.clear();
+        lazySources.clear();
+
+        const auto started = std::chrono::steady_clock::now();
+
+        // the snapshot is only worth it when the gas files can be checked for changes more cheaply than parsing them
+        std::string snapshot;
+        std::vector<SourceCrc> sources;
+
+        if (const FuelCache* cache = fileSys.gasCache())
+        {
+            sources = fileSys.gasSourceCrcs(directory);
+            snapshot = (fs::path(cache->directory()) / fmt::format("contentdb-{:08x}.snapshot", FuelCache::checksum(directory))).string();
+
+            if (loadSnapshot(snapshot, sources))
+            {
+                log->info("ContentDb loaded {} templates from {} in {:.3f} ms", db.size(), snapshot, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+
+                return;
+            }
+        }
+
+        // parsed in parallel, but the first definition of a template has to win so they are handed over in filename order
+        fileSys.eachGasFile(directory, GasFileOrder::Sorted, [this, &tmplMap](const std::string& filename, auto doc) {
+            // templates are queried over and over once resolved, the layers point straight at the decoded attributes
+            doc->decodeValues();
+
             for (auto node : doc->eachChild())
             {
                 const auto result = tmplMap.emplace(stringtool::convertToLowerCase(node->name()), node);
@@ -33,74 +69,383 @@ namespace ehb
             docs.emplace_back(std::move(doc));
         });
 
-        log->debug("ContentDb is resolving {} templates", tmplMap.size());
+        // every template hangs off the one it specializes, resolving them level by level from the roots down means
+        // the base of a template is always done before it and everything within a level can go in parallel
+        struct Node
+        {
+            std::string_view name; //! the lowercase key in tmplMap
+            const FuelBlock* block = nullptr;
+            int32_t parent = -1;
+            int32_t depth = -1; //! stays negative for templates that can't be resolved
+        };
 
-        std::function<void(const std::string&)> resolve;
+        std::vector<Node> nodes;
+        std::unordered_map<std::string_view, int32_t> indices;
 
-        resolve = [&resolve, &tmplMap, this](const std::string& name) {
-            auto log = spdlog::get("log");
+        nodes.reserve(tmplMap.size());
+        indices.reserve(tmplMap.size());
+
+        for (const auto& [name, block] : tmplMap)
+        {
+            indices.emplace(name, static_cast<int32_t>(nodes.size()));
+            nodes.push_back({name, block});
+        }
 
-            if (db.count(name) == 0)
+        for (Node& node : nodes)
+        {
+            const std::string specializes = stringtool::convertToLowerCase(node.block->valueOf("specializes"));
+
+            if (specializes.empty()) { continue; }
+
+            if (const auto itr = indices.find(specializes); itr != indices.end()) { node.parent = itr->second; }
+            else
             {
-                if (const auto itr = tmplMap.find(name); itr != tmplMap.end())
+                // resolved on its own like it always has been
+                log->error("{} specializes {} which could not be found", node.block->name(), specializes);
+            }
+        }
+
+        // the depth of every template is its distance from the root of its chain, walking up until a known depth is found
+        enum : int32_t
+        {
+            Unvisited = -1,
+            Visiting = -2,
+            Broken = -3 //! part of a cycle or specializing something that is
+        };
+
+        std::vector<int32_t> chain;
+        std::vector<std::vector<int32_t>> levels;
+        size_t broken = 0;
+
+        for (int32_t first = 0; first < static_cast<int32_t>(nodes.size()); ++first)
+        {
+            int32_t index = first;
+
+            while (index != -1 && nodes[index].depth == Unvisited)
+            {
+                nodes[index].depth = Visiting;
+                chain.push_back(index);
+                index = nodes[index].parent;
+            }
+
+            int32_t depth = index == -1 ? -1 : nodes[index].depth;
+
+            if (depth == Visiting)
+            {
+                std::string cycle(nodes[index].block->name());
+
+                for (auto itr = std::find(chain.begin(), chain.end(), index) + 1; itr != chain.end(); ++itr)
                 {
-                    FuelBlock* node = itr->second;
+                    cycle += " -> ";
+                    cycle += nodes[*itr].block->name();
+                }
 
-                    const std::string specializes = stringtool::convertToLowerCase(node->valueOf("specializes"));
+                log->error("templates specialize each other in a cycle and can't be resolved: {} -> {}", cycle, nodes[index].block->name());
 
-                    FuelBlock* super = nullptr;
+                depth = Broken;
+            }
 
-                    if (!specializes.empty())
-                    {
-                        resolve(specializes);
+            for (auto itr = chain.rbegin(); itr != chain.rend(); ++itr)
+            {
+                if (depth == Broken)
+                {
+                    nodes[*itr].depth = Broken;
+                    ++broken;
 
-                        if (const auto itr = db.find(specializes); itr != db.end())
-                        {
-                            super = itr->second.get();
-                        }
-                    }
+                    continue;
+                }
 
-                    FuelBlock* newNode = super ? super->clone() : node->clone();
+                nodes[*itr].depth = ++depth;
 
-                    if (super)
+                if (levels.size() <= static_cast<size_t>(depth)) { levels.resize(depth + 1); }
+
+                levels[depth].push_back(*itr);
+            }
+
+            chain.clear();
+        }
+
+        if (broken != 0) { log->error("{} templates were left out because of cycles in their specializes chains", broken); }
+
+        log->debug("ContentDb is resolving {} templates in {} levels", nodes.size() - broken, levels.size());
+
+        // the map is filled up front, the workers only write to the template they are resolving
+        std::vector<Template*> templates(nodes.size(), nullptr);
+
+        for (size_t index = 0; index < nodes.size(); ++index)
+        {
+            if (nodes[index].depth >= 0) { templates[index] = &db[std::string(nodes[index].name)]; }
+        }
+
+        if (threads == 0) { threads = std::thread::hardware_concurrency(); }
+
+        for (size_t depth = 0; depth < levels.size(); ++depth)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const std::vector<int32_t>& level = levels[depth];
+
+            // the layers of the parent are only read, so a whole level can be built at once
+            const unsigned int workers = std::max(1u, std::min<unsigned int>(threads, static_cast<unsigned int>(level.size() / MinTemplatesPerThread)));
+
+            parallelFor(level.size(), workers, [&](unsigned int, size_t i) {
+                const Node& node = nodes[level[i]];
+                const FuelLayer* super = node.parent != -1 ? templates[node.parent]->root : nullptr;
+
+                Template& tmpl = *templates[level[i]];
+                tmpl.root = FuelLayer::create(node.block, super, tmpl.layers);
+            });
+
+            log->debug("ContentDb resolved level {} with {} templates in {:.3f} ms", depth, level.size(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        log->debug("ContentDB has finished loading and resolving {} templates in {:.3f} ms", db.size(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+
+        if (!snapshot.empty() && !saveSnapshot(snapshot, sources)) { log->warn("unable to write ContentDb snapshot {}", snapshot); }
+    }
+
+    void ContentDb::initLazy(IFileSys& fileSys, const std::string& directory)
+    {
+        auto log = spdlog::get("log");
+
+        attributeIndex.reset();
+        db.clear();
+        docs.clear();
+
+        lazyFileSys = &fileSys;
+        pending.clear();
+        lazySources.clear();
+        materializedCount = 0;
+        parsedCount = 0;
+
+        const auto started = std::chrono::steady_clock::now();
+
+        // the files come sorted so the first definition of a template still wins
+        for (const auto& filename : fileSys.getFiles())
+        {
+            if (vsg::lowerCaseFileExtension(filename) != ".gas" || filename.find(directory) != 0) { continue; }
+
+            const auto index = static_cast<uint32_t>(lazySources.size());
+            Source& source = *lazySources.emplace_back(std::make_unique<Source>());
+
+            source.filename = filename;
+
+            std::vector<std::string> names;
+
+            // only the names at the top level are read, everything inside the templates is skipped over
+            FuelReader reader;
+            reader.beginBlock = [&names](std::string_view name, std::string_view) {
+                names.emplace_back(name);
+
+                return FuelReader::Next::Skip;
+            };
+
+            bool scanned = false;
+
+            if (auto stream = fileSys.createInputStream(filename)) { scanned = reader.read(*stream); }
+
+            if (!scanned)
+            {
+                // the reader gives up on a syntax error where the parser recovers, so the file is parsed and kept instead
+                names.clear();
+
+                std::call_once(source.parsed, [this, &source]() { parseSource(source); });
+
+                if (source.doc)
+                {
+                    for (const FuelBlock* node : source.doc->eachChild())
                     {
-                        node->merge(newNode);
+                        names.emplace_back(node->name());
                     }
-
-                    db.emplace(name, newNode);
                 }
+            }
+
+            for (const auto& name : names)
+            {
+                if (const auto result = pending.try_emplace(stringtool::convertToLowerCase(name)); result.second) { result.first->second.source = index; }
                 else
                 {
-                    log->error("could not find {}", name);
+                    log->warn("{}: duplicate entry {} found", filename, name);
                 }
             }
-        };
+        }
 
-        for (const auto& entry : tmplMap)
+        log->debug("ContentDb found {} templates in {} files in {:.3f} ms", pending.size(), lazySources.size(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+    }
+
+    ContentDb::Counters ContentDb::counters() const
+    {
+        if (lazyFileSys) { return {pending.size(), materializedCount.load(), lazySources.size(), parsedCount.load()}; }
+
+        return {db.size(), db.size(), docs.size(), docs.size()};
+    }
+
+    std::string_view ContentDb::queryString(const std::string& query, std::string_view defaultValue) const
+    {
+        if (const auto colon = query.find(':'); colon != std::string::npos)
         {
-            resolve(entry.first);
+            if (const Template* tmpl = find(query.substr(0, colon)))
+            {
+                return tmpl->root->valueOf(std::string_view(query).substr(colon + 1), defaultValue);
+            }
         }
 
-        log->debug("ContentDB has finished loading and resolving {} templates", db.size());
+        return defaultValue;
     }
 
-    const std::string& ContentDb::queryString(const std::string& query, const std::string& defaultValue) const
+    ContentDb::Query ContentDb::compile(const std::string& query) const
     {
         if (const auto colon = query.find(':'); colon != std::string::npos)
         {
-            if (const auto itr = db.find(query.substr(0, colon)); itr != db.end())
+            if (const Template* tmpl = find(query.substr(0, colon)))
             {
-                return itr->second->valueOf(query.substr(colon + 1));
+                return Query(tmpl->root, std::string_view(query).substr(colon + 1));
             }
         }
 
-        return defaultValue;
+        spdlog::get("log")->warn("ContentDb can't compile query {} as its template doesn't exist", query);
+
+        return Query(nullptr, {});
+    }
+
+    const FuelLayer* ContentDb::getGameObjectTmpl(const std::string& tmpl) const
+    {
+        const Template* found = find(tmpl);
+
+        return found ? found->root : nullptr;
+    }
+
+    const ContentDbIndex& ContentDb::buildIndex(unsigned int threads)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::pair<std::string_view, const FuelLayer*>> templates;
+
+        templates.reserve(db.size() + pending.size());
+
+        for (const auto& [name, tmpl] : db)
+        {
+            templates.emplace_back(name, tmpl.root);
+        }
+
+        for (const auto& entry : pending)
+        {
+            if (const Template* tmpl = resolve(entry.first)) { templates.emplace_back(entry.first, tmpl->root); }
+        }
+
+        attributeIndex = std::make_unique<ContentDbIndex>(templates, threads);
+
+        spdlog::get("log")->debug("ContentDb indexed {} values under {} paths in {:.3f} ms", attributeIndex->entryCount(), attributeIndex->pathCount(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        return *attributeIndex;
+    }
+
+    const ContentDb::Template* ContentDb::find(const std::string& name) const
+    {
+        if (lazyFileSys) { return resolve(name); }
+
+        const auto itr = db.find(name);
+
+        return itr != db.end() ? &itr->second : nullptr;
+    }
+
+    const ContentDb::Template* ContentDb::resolve(const std::string& name) const
+    {
+        const auto itr = pending.find(name);
+
+        if (itr == pending.end()) { return nullptr; }
+
+        Pending& entry = itr->second;
+
+        std::call_once(entry.resolved, [this, &entry, &name]() {
+            auto log = spdlog::get("log");
+
+            const FuelBlock* block = findBlock(entry, name);
+
+            if (block == nullptr)
+            {
+                log->error("{} could not be found in {}", name, lazySources[entry.source]->filename);
+
+                return;
+            }
+
+            const std::string specializes = stringtool::convertToLowerCase(block->valueOf("specializes"));
+            const FuelLayer* super = nullptr;
+
+            if (!specializes.empty())
+            {
+                // the whole chain is walked before resolving any of it, waiting on a template that is part of a cycle would never return
+                std::vector<std::string> chain = {name};
+
+                for (std::string parent = specializes; !parent.empty();)
+                {
+                    if (std::find(chain.begin(), chain.end(), parent) != chain.end())
+                    {
+                        std::string cycle;
+
+                        for (const auto& link : chain)
+                        {
+                            cycle += link;
+                            cycle += " -> ";
+                        }
+
+                        log->error("{} can't be resolved as its specializes chain runs in a cycle: {}{}", block->name(), cycle, parent);
+
+                        return;
+                    }
+
+                    const auto base = pending.find(parent);
+
+                    if (base == pending.end()) { break; }
+
+                    const FuelBlock* baseBlock = findBlock(base->second, parent);
+
+                    chain.push_back(std::move(parent));
+                    parent = baseBlock ? stringtool::convertToLowerCase(baseBlock->valueOf("specializes")) : std::string();
+                }
+
+                if (const Template* base = resolve(specializes)) { super = base->root; }
+                else if (pending.count(specializes) == 0)
+                {
+                    // resolved on its own like it always has been
+                    log->error("{} specializes {} which could not be found", block->name(), specializes);
+                }
+            }
+
+            entry.tmpl.root = FuelLayer::create(block, super, entry.tmpl.layers);
+
+            ++materializedCount;
+        });
+
+        return entry.tmpl.root ? &entry.tmpl : nullptr;
+    }
+
+    const FuelBlock* ContentDb::findBlock(const Pending& entry, const std::string& name) const
+    {
+        Source& source = *lazySources[entry.source];
+
+        std::call_once(source.parsed, [this, &source]() {
+            if (!parseSource(source)) { spdlog::get("log")->error("{}: could not be parsed", source.filename); }
+        });
+
+        const auto itr = source.blocks.find(name);
+
+        return itr != source.blocks.end() ? itr->second : nullptr;
     }
 
-    const FuelBlock* ContentDb::getGameObjectTmpl(const std::string& tmpl) const
+    bool ContentDb::parseSource(Source& source) const
     {
-        const auto itr = db.find(tmpl);
+        if (!(source.doc = lazyFileSys->openGasFile(source.filename))) { return false; }
+
+        source.doc->decodeValues();
+
+        // the first one wins like it does for the other files
+        for (const FuelBlock* node : source.doc->eachChild())
+        {
+            source.blocks.try_emplace(stringtool::convertToLowerCase(node->name()), node);
+        }
+
+        ++parsedCount;
 
-        return itr != db.end() ? itr->second.get() : nullptr;
+        return true;
     }
 } // namespace ehb
@@ -1,26 +1,193 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
+#include "ContentDbIndex.hpp"
 #include "gas/Fuel.hpp"
+#include "gas/FuelLayer.hpp"
 
 namespace ehb
 {
     class IFileSys;
+    struct SourceCrc;
     class ContentDb final
     {
     public:
-        void init(IFileSys& fileSys, const std::string& directory = "/world/contentdb/templates/");
+        /**
+         * a query split up and looked up once so it can be asked over and over, the template is found by compile
+         * and the path below it is hashed segment by segment. only valid for as long as the ContentDb is
+         */
+        class Query final
+        {
+        public:
+            //! @return whether the template of the query exists
+            explicit operator bool() const;
+
+            const FuelLayer* tmpl() const;
+            const FuelPath& path() const;
+
+            //! @return whether the template has the attribute
+            bool exists() const;
+
+            std::string_view valueOf(std::string_view defaultValue = {}) const;
+
+            //! see the FuelBlock getters of the same name
+            bool valueAsBool(bool defaultValue = false) const;
+            int valueAsInt(int defaultValue = 0) const;
+            unsigned int valueAsUInt(unsigned int defaultValue = 0) const;
+            float valueAsFloat(float defaultValue = 0.f) const;
+            double valueAsDouble(double defaultValue = 0.0) const;
+            std::string valueAsString(const std::string& defaultValue = "") const;
+            uint32_t valueAsGuid(uint32_t defaultValue = 0) const;
+            std::array<float, 3> valueAsFloat3(const std::array<float, 3> defaultValue = {1.0, 1.0, 1.0}) const;
+            vsg::vec3 valueAsVec3(const vsg::vec3& defaultValue = {1.0, 1.0, 1.0}) const;
+
+        private:
+            friend class ContentDb;
+
+            Query(const FuelLayer* tmpl, std::string_view path);
+
+            const FuelLayer* mTemplate;
+            FuelPath mPath;
+        };
+
+        /**
+         * load every template under the directory and resolve its specializes chain. with a gas cache set on the
+         * filesystem the resolved templates are kept in a snapshot next to it, which is used as long as none of the
+         * gas files it was built from have changed
+         * @param threads the number of workers resolving the templates of one level, 0 picks one per hardware thread
+         */
+        void init(IFileSys& fileSys, const std::string& directory = "/world/contentdb/templates/", unsigned int threads = 0);
+
+        /**
+         * only find out which file every template is in, a template and the ones it specializes are parsed and
+         * resolved the first time it is asked for. for sessions that only ever touch a fraction of the templates,
+         * the filesystem has to outlive the ContentDb
+         */
+        void initLazy(IFileSys& fileSys, const std::string& directory = "/world/contentdb/templates/");
+
+        //! how much of the ContentDb has been materialized, after init everything has
+        struct Counters
+        {
+            size_t templates = 0;
+            size_t materialized = 0;
+            size_t documents = 0;
+            size_t parsed = 0;
+        };
+
+        Counters counters() const;
 
         //! query a string from a given template, for example: "2w_gargoyle:aspect:experience_value"
-        const std::string& queryString(const std::string& query, const std::string& defaultValue = "") const;
+        std::string_view queryString(const std::string& query, std::string_view defaultValue = {}) const;
 
-        const FuelBlock* getGameObjectTmpl(const std::string& tmpl) const;
+        //! split and look up a query in the same form queryString takes, for the ones that are asked all the time
+        Query compile(const std::string& query) const;
+
+        const FuelLayer* getGameObjectTmpl(const std::string& tmpl) const;
+
+        /**
+         * build the inverted attribute index over the resolved templates, it isn't kept up to date so this has to
+         * be called again after init. a lazy ContentDb materializes every template for it
+         * @param threads the number of workers, 0 picks one per hardware thread
+         */
+        const ContentDbIndex& buildIndex(unsigned int threads = 0);
+
+        //! @return the index or nullptr if it hasn't been built
+        const ContentDbIndex* index() const;
 
     private:
-        std::unordered_map<std::string, std::unique_ptr<FuelBlock>> db;
+        //! see ContentDbSnapshot.cpp for the layout
+        bool loadSnapshot(const std::string& filename, const std::vector<SourceCrc>& sources);
+        bool saveSnapshot(const std::string& filename, const std::vector<SourceCrc>& sources) const;
+
+        //! fewer templates than this per worker aren't worth starting a thread for
+        static constexpr size_t MinTemplatesPerThread = 64;
+
+        // a resolved template only holds the layers for what it overrides, everything else is shared with the
+        // template it specializes, so the parsed documents have to stay around for as long as the templates do
+        struct Template
+        {
+            FuelLayer::Storage layers;
+            const FuelLayer* root = nullptr;
+        };
+
+        //! a gas file of a lazy ContentDb, parsed by whoever needs one of its templates first
+        struct Source
+        {
+            std::string filename;
+            std::once_flag parsed;
+            std::unique_ptr<Fuel> doc;
+
+            //! key: lower case name, value: the first top level block with it
+            std::unordered_map<std::string, const FuelBlock*> blocks;
+        };
+
+        //! a template of a lazy ContentDb, resolved once no matter how many threads ask for it at the same time
+        struct Pending
+        {
+            uint32_t source = 0;
+            std::once_flag resolved;
+            Template tmpl;
+        };
+
+        const Template* find(const std::string& name) const;
+
+        const Template* resolve(const std::string& name) const;
+        const FuelBlock* findBlock(const Pending& entry, const std::string& name) const;
+
+        //! parse the gas file of a lazy source and index its top level blocks, @return false if it couldn't be parsed
+        bool parseSource(Source& source) const;
+
+        std::vector<std::unique_ptr<Fuel>> docs;
+        std::unordered_map<std::string, Template> db;
+
+        //! set by initLazy, the maps are filled up front and only the entries change afterwards
+        IFileSys* lazyFileSys = nullptr;
+        std::vector<std::unique_ptr<Source>> lazySources;
+        mutable std::unordered_map<std::string, Pending> pending;
+        mutable std::atomic<size_t> materializedCount = 0;
+        mutable std::atomic<size_t> parsedCount = 0;
+
+        std::unique_ptr<ContentDbIndex> attributeIndex;
     };
+
+    inline const ContentDbIndex* ContentDb::index() const { return attributeIndex.get(); }
+
+    inline ContentDb::Query::Query(const FuelLayer* tmpl, std::string_view path) :
+        mTemplate(tmpl), mPath(path) {}
+
+    inline ContentDb::Query::operator bool() const { return mTemplate != nullptr; }
+
+    inline const FuelLayer* ContentDb::Query::tmpl() const { return mTemplate; }
+
+    inline const FuelPath& ContentDb::Query::path() const { return mPath; }
+
+    inline bool ContentDb::Query::exists() const { return mTemplate && mTemplate->hasAttr(mPath); }
+
+    inline std::string_view ContentDb::Query::valueOf(std::string_view defaultValue) const { return mTemplate ? mTemplate->valueOf(mPath, defaultValue) : defaultValue; }
+
+    inline bool ContentDb::Query::valueAsBool(bool defaultValue) const { return mTemplate ? mTemplate->valueAsBool(mPath, defaultValue) : defaultValue; }
+
+    inline int ContentDb::Query::valueAsInt(int defaultValue) const { return mTemplate ? mTemplate->valueAsInt(mPath, defaultValue) : defaultValue; }
+
+    inline unsigned int ContentDb::Query::valueAsUInt(unsigned int defaultValue) const { return mTemplate ? mTemplate->valueAsUInt(mPath, defaultValue) : defaultValue; }
+
+    inline float ContentDb::Query::valueAsFloat(float defaultValue) const { return mTemplate ? mTemplate->valueAsFloat(mPath, defaultValue) : defaultValue; }
+
+    inline double ContentDb::Query::valueAsDouble(double defaultValue) const { return mTemplate ? mTemplate->valueAsDouble(mPath, defaultValue) : defaultValue; }
+
+    inline std::string ContentDb::Query::valueAsString(const std::string& defaultValue) const { return mTemplate ? mTemplate->valueAsString(mPath, defaultValue) : defaultValue; }
+
+    inline uint32_t ContentDb::Query::valueAsGuid(uint32_t defaultValue) const { return mTemplate ? mTemplate->valueAsGuid(mPath, defaultValue) : defaultValue; }
+
+    inline std::array<float, 3> ContentDb::Query::valueAsFloat3(const std::array<float, 3> defaultValue) const { return mTemplate ? mTemplate->valueAsFloat3(mPath, defaultValue) : defaultValue; }
+
+    inline vsg::vec3 ContentDb::Query::valueAsVec3(const vsg::vec3& defaultValue) const { return mTemplate ? mTemplate->valueAsVec3(mPath, defaultValue) : defaultValue; }
 } // namespace ehb
@@ -0,0 +1,199 @@
+#include "ContentDbIndex.hpp"
+
+#include "gas/FuelLayer.hpp"
+#include "io/StringTool.hpp"
+#include "io/ThreadPool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace ehb
+{
+    ContentDbIndex::ContentDbIndex(const std::vector<std::pair<std::string_view, const FuelLayer*>>& templates, unsigned int threads)
+    {
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+        threads = std::max(1u, std::min<unsigned int>(threads, static_cast<unsigned int>(templates.size())));
+
+        // template ids follow the names so sorting ids sorts the results
+        std::vector<std::pair<std::string_view, const FuelLayer*>> sorted = templates;
+        std::sort(sorted.begin(), sorted.end());
+
+        mNames.reserve(sorted.size());
+
+        for (const auto& entry : sorted)
+        {
+            mNames.push_back(entry.first);
+        }
+
+        struct Partial
+        {
+            std::unordered_map<std::string, std::vector<Entry>> paths;
+            std::unordered_map<std::string, std::vector<uint32_t>> children;
+        };
+
+        std::vector<Partial> partials(threads);
+
+        parallelFor(sorted.size(), threads, [&sorted, &partials](unsigned int thread, size_t index) {
+            Partial& partial = partials[thread];
+            const auto tmpl = static_cast<uint32_t>(index);
+            const FuelLayer* root = sorted[index].second;
+
+            std::string path;
+
+            // the path is grown and shrunk in place while walking down, duplicate blocks are all indexed
+            auto walk = [&partial, &path, tmpl](const FuelLayer* layer, auto&& walk) -> void {
+                const size_t length = path.size();
+
+                for (const Attribute* attr : layer->eachAttribute())
+                {
+                    path.append(attr->name);
+                    partial.paths[path].push_back({attr->value, tmpl});
+                    path.resize(length);
+                }
+
+                for (const FuelLayer* child : layer->eachChild())
+                {
+                    path.append(child->name());
+                    path.push_back(':');
+                    walk(child, walk);
+                    path.resize(length);
+                }
+            };
+
+            walk(root, walk);
+
+            if (const std::string_view parent = root->valueOf("specializes"); !parent.empty())
+            {
+                partial.children[stringtool::convertToLowerCase(parent)].push_back(tmpl);
+            }
+        });
+
+        for (Partial& partial : partials)
+        {
+            for (auto& [path, entries] : partial.paths)
+            {
+                auto& target = mPaths[path];
+                target.insert(target.end(), entries.begin(), entries.end());
+            }
+
+            for (auto& [parent, children] : partial.children)
+            {
+                auto& target = mChildren[parent];
+                target.insert(target.end(), children.begin(), children.end());
+            }
+        }
+
+        partials.clear();
+
+        std::vector<std::vector<Entry>*> lists;
+
+        lists.reserve(mPaths.size());
+
+        for (auto& entry : mPaths)
+        {
+            mEntryCount += entry.second.size();
+            lists.push_back(&entry.second);
+        }
+
+        parallelFor(lists.size(), threads, [&lists](unsigned int, size_t index) { std::sort(lists[index]->begin(), lists[index]->end()); });
+
+        for (auto& entry : mChildren)
+        {
+            std::sort(entry.second.begin(), entry.second.end());
+        }
+    }
+
+    ContentDbIndex::TemplateList ContentDbIndex::withValue(std::string_view path, std::string_view value) const
+    {
+        std::vector<uint32_t> templates;
+
+        if (const auto itr = mPaths.find(std::string(path)); itr != mPaths.end())
+        {
+            const auto& entries = itr->second;
+
+            auto first = std::lower_bound(entries.begin(), entries.end(), value, [](const Entry& entry, std::string_view value) { return entry.value < value; });
+
+            for (; first != entries.end() && first->value == value; ++first)
+            {
+                templates.push_back(first->tmpl);
+            }
+        }
+
+        return collect(templates);
+    }
+
+    ContentDbIndex::TemplateList ContentDbIndex::withPrefix(std::string_view path, std::string_view prefix) const
+    {
+        std::vector<uint32_t> templates;
+
+        if (const auto itr = mPaths.find(std::string(path)); itr != mPaths.end())
+        {
+            const auto& entries = itr->second;
+
+            auto first = std::lower_bound(entries.begin(), entries.end(), prefix, [](const Entry& entry, std::string_view value) { return entry.value < value; });
+
+            for (; first != entries.end() && first->value.substr(0, prefix.size()) == prefix; ++first)
+            {
+                templates.push_back(first->tmpl);
+            }
+        }
+
+        return collect(templates);
+    }
+
+    ContentDbIndex::TemplateList ContentDbIndex::specializing(std::string_view parent, bool recursive) const
+    {
+        std::vector<uint32_t> templates;
+
+        if (const auto itr = mChildren.find(stringtool::convertToLowerCase(parent)); itr != mChildren.end())
+        {
+            templates = itr->second;
+        }
+
+        // a breadth first walk down the tree, the names are all lowercase already as they come from ContentDb
+        if (recursive)
+        {
+            std::vector<bool> visited(mNames.size(), false);
+
+            for (uint32_t tmpl : templates)
+            {
+                visited[tmpl] = true;
+            }
+
+            for (size_t i = 0; i < templates.size(); ++i)
+            {
+                if (const auto itr = mChildren.find(std::string(mNames[templates[i]])); itr != mChildren.end())
+                {
+                    for (uint32_t child : itr->second)
+                    {
+                        if (!visited[child])
+                        {
+                            visited[child] = true;
+                            templates.push_back(child);
+                        }
+                    }
+                }
+            }
+        }
+
+        return collect(templates);
+    }
+
+    ContentDbIndex::TemplateList ContentDbIndex::collect(std::vector<uint32_t>& templates) const
+    {
+        std::sort(templates.begin(), templates.end());
+        templates.erase(std::unique(templates.begin(), templates.end()), templates.end());
+
+        TemplateList result;
+
+        result.reserve(templates.size());
+
+        for (uint32_t tmpl : templates)
+        {
+            result.push_back(mNames[tmpl]);
+        }
+
+        return result;
+    }
+} // namespace ehb
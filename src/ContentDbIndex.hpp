@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ehb
+{
+    class FuelLayer;
+
+    /**
+     * inverted index over resolved templates, from an attribute path and value to the templates that end up with
+     * that value (inherited ones included) and from a template to the ones that specialize it. names and values
+     * point into the ContentDb the index was built from, so it is only valid for as long as that is
+     */
+    class ContentDbIndex final
+    {
+    public:
+        //! template names, sorted and without duplicates
+        using TemplateList = std::vector<std::string_view>;
+
+        /**
+         * @param templates the name and resolved root layer of every template
+         * @param threads the number of workers, 0 picks one per hardware thread
+         */
+        ContentDbIndex(const std::vector<std::pair<std::string_view, const FuelLayer*>>& templates, unsigned int threads = 0);
+
+        //! @param path the attribute below the template, for example "aspect:model"
+        TemplateList withValue(std::string_view path, std::string_view value) const;
+        TemplateList withPrefix(std::string_view path, std::string_view prefix) const;
+
+        //! @param recursive also include the templates that specialize those, all the way down
+        TemplateList specializing(std::string_view parent, bool recursive = false) const;
+
+        size_t pathCount() const;
+        size_t entryCount() const;
+
+    private:
+        struct Entry
+        {
+            std::string_view value;
+            uint32_t tmpl;
+
+            bool operator<(const Entry& rhs) const { return value < rhs.value || (value == rhs.value && tmpl < rhs.tmpl); }
+        };
+
+        TemplateList collect(std::vector<uint32_t>& templates) const;
+
+        std::vector<std::string_view> mNames;
+
+        //! entries of a path are sorted by value so equal values and common prefixes are contiguous
+        std::unordered_map<std::string, std::vector<Entry>> mPaths;
+
+        //! keyed by the lowercase name of the parent, which doesn't have to exist
+        std::unordered_map<std::string, std::vector<uint32_t>> mChildren;
+
+        size_t mEntryCount = 0;
+    };
+
+    inline size_t ContentDbIndex::pathCount() const { return mPaths.size(); }
+
+    inline size_t ContentDbIndex::entryCount() const { return mEntryCount; }
+} // namespace ehb
@@ -0,0 +1,403 @@
+#include "ContentDb.hpp"
+
+#include "io/IFileSys.hpp"
+#include "io/MappedFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+/*
+ * resolved ContentDb snapshot layout, everything is stored in native (little endian) byte order
+ *
+ *   Header
+ *   SourceEntry[sourceCount]      what the templates were loaded from, the snapshot is only used when these still match
+ *   DocumentEntry[documentCount]  where the template documents are, each one compiled the way FuelBinary.cpp writes them
+ *   TemplateEntry[templateCount]
+ *   LayerEntry[layerCount]        children always come before their parent so a layer can be rebuilt in one pass
+ *   uint32_t[childCount]          child layers of a layer are a contiguous range
+ *   uint32_t[attributeCount]      so are the attributes, which are numbered across all documents in the order they are stored
+ *   char[namesSize]               names of the sources and templates
+ *   the compiled documents, each starting on an 8 byte boundary
+ *
+ * blocks are numbered across all documents the same way, breadth first within each document
+ */
+
+namespace ehb
+{
+    namespace
+    {
+        constexpr char Magic[4] = {'C', 'D', 'B', 'S'};
+        constexpr uint32_t Version = 1;
+
+        struct Header
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t sourceCount;
+            uint32_t documentCount;
+            uint32_t templateCount;
+            uint32_t layerCount;
+            uint32_t childCount;
+            uint32_t attributeCount;
+            uint32_t namesSize;
+            uint32_t reserved;
+        };
+
+        struct StringRef
+        {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        struct SourceEntry
+        {
+            StringRef name;
+            uint32_t crc;
+            uint32_t reserved;
+            uint64_t size;
+        };
+
+        struct DocumentEntry
+        {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct TemplateEntry
+        {
+            StringRef name;
+            uint32_t layer;
+            uint32_t reserved;
+        };
+
+        struct LayerEntry
+        {
+            uint32_t block;
+            uint32_t owner; //! the template whose storage the layer goes into
+            uint32_t firstChild;
+            uint32_t childCount;
+            uint32_t firstAttribute;
+            uint32_t attributeCount;
+        };
+
+        static_assert(sizeof(Header) == 40 && sizeof(SourceEntry) == 24 && sizeof(DocumentEntry) == 16 && sizeof(TemplateEntry) == 16 && sizeof(LayerEntry) == 24, "snapshot records must be tightly packed");
+
+        template <typename T>
+        void writeRecords(std::ostream& stream, const std::vector<T>& records)
+        {
+            stream.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(T)));
+        }
+
+        //! every block and attribute of the documents in the order they are numbered in
+        void numberDocuments(const std::vector<std::unique_ptr<Fuel>>& docs, std::vector<const FuelBlock*>& blocks, std::vector<const Attribute*>& attributes)
+        {
+            for (const auto& doc : docs)
+            {
+                const size_t first = blocks.size();
+
+                blocks.push_back(doc.get());
+
+                for (size_t i = first; i < blocks.size(); ++i)
+                {
+                    blocks.insert(blocks.end(), blocks[i]->eachChild().begin(), blocks[i]->eachChild().end());
+
+                    for (const Attribute& attr : blocks[i]->eachAttribute())
+                    {
+                        attributes.push_back(&attr);
+                    }
+                }
+            }
+        }
+
+        constexpr uint64_t align8(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+    } // namespace
+
+    bool ContentDb::saveSnapshot(const std::string& filename, const std::vector<SourceCrc>& sources) const
+    {
+        std::vector<const FuelBlock*> blocks;
+        std::vector<const Attribute*> attributes;
+
+        numberDocuments(docs, blocks, attributes);
+
+        std::unordered_map<const FuelBlock*, uint32_t> blockIndex;
+        std::unordered_map<const Attribute*, uint32_t> attributeIndex;
+
+        for (uint32_t i = 0; i < blocks.size(); ++i)
+        {
+            blockIndex.emplace(blocks[i], i);
+        }
+
+        for (uint32_t i = 0; i < attributes.size(); ++i)
+        {
+            attributeIndex.emplace(attributes[i], i);
+        }
+
+        std::string names;
+
+        const auto addName = [&names](std::string_view str) {
+            const StringRef ref = {static_cast<uint32_t>(names.size()), static_cast<uint32_t>(str.size())};
+
+            names.append(str);
+
+            return ref;
+        };
+
+        std::vector<SourceEntry> sourceRecords;
+
+        for (const auto& source : sources)
+        {
+            sourceRecords.push_back({addName(source.name), source.crc, 0, source.size});
+        }
+
+        // shared layers are written once, by the template whose storage holds them
+        std::unordered_map<const FuelLayer*, uint32_t> owners;
+        std::vector<TemplateEntry> templates;
+
+        for (const auto& [name, tmpl] : db)
+        {
+            for (const FuelLayer& layer : tmpl.layers)
+            {
+                owners.emplace(&layer, static_cast<uint32_t>(templates.size()));
+            }
+
+            templates.push_back({addName(name), 0, 0});
+        }
+
+        std::vector<LayerEntry> layers;
+        std::vector<uint32_t> children, layerAttributes;
+        std::unordered_map<const FuelLayer*, uint32_t> layerIndex;
+
+        // post order so the children of a layer are numbered before it
+        std::function<uint32_t(const FuelLayer*)> number = [&](const FuelLayer* layer) {
+            if (const auto itr = layerIndex.find(layer); itr != layerIndex.end()) { return itr->second; }
+
+            std::vector<uint32_t> childIndices;
+
+            for (const FuelLayer* child : layer->eachChild())
+            {
+                childIndices.push_back(number(child));
+            }
+
+            LayerEntry record = {blockIndex.at(layer->block()), owners.at(layer), static_cast<uint32_t>(children.size()), static_cast<uint32_t>(childIndices.size()), static_cast<uint32_t>(layerAttributes.size()), static_cast<uint32_t>(layer->eachAttribute().size())};
+
+            children.insert(children.end(), childIndices.begin(), childIndices.end());
+
+            for (const Attribute* attr : layer->eachAttribute())
+            {
+                layerAttributes.push_back(attributeIndex.at(attr));
+            }
+
+            layers.push_back(record);
+            layerIndex.emplace(layer, static_cast<uint32_t>(layers.size() - 1));
+
+            return static_cast<uint32_t>(layers.size() - 1);
+        };
+
+        {
+            uint32_t index = 0;
+
+            for (const auto& entry : db)
+            {
+                templates[index++].layer = number(entry.second.root);
+            }
+        }
+
+        std::vector<std::string> compiled;
+
+        for (const auto& doc : docs)
+        {
+            std::ostringstream stream;
+
+            if (!doc->saveBinary(stream)) { return false; }
+
+            compiled.push_back(stream.str());
+        }
+
+        Header header = {};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.sourceCount = static_cast<uint32_t>(sourceRecords.size());
+        header.documentCount = static_cast<uint32_t>(compiled.size());
+        header.templateCount = static_cast<uint32_t>(templates.size());
+        header.layerCount = static_cast<uint32_t>(layers.size());
+        header.childCount = static_cast<uint32_t>(children.size());
+        header.attributeCount = static_cast<uint32_t>(layerAttributes.size());
+        header.namesSize = static_cast<uint32_t>(names.size());
+
+        uint64_t offset = sizeof(Header) + sourceRecords.size() * sizeof(SourceEntry) + compiled.size() * sizeof(DocumentEntry) + templates.size() * sizeof(TemplateEntry) + layers.size() * sizeof(LayerEntry) + (children.size() + layerAttributes.size()) * sizeof(uint32_t) + names.size();
+
+        std::vector<DocumentEntry> documents;
+
+        for (const auto& data : compiled)
+        {
+            offset = align8(offset);
+            documents.push_back({offset, data.size()});
+            offset += data.size();
+        }
+
+        // write to a unique temporary first so a reader never sees a partial snapshot
+        const std::string temporary = FuelCache::temporaryFor(filename);
+
+        if (std::ofstream out(temporary, std::ios::binary); out)
+        {
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            writeRecords(out, sourceRecords);
+            writeRecords(out, documents);
+            writeRecords(out, templates);
+            writeRecords(out, layers);
+            writeRecords(out, children);
+            writeRecords(out, layerAttributes);
+            out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+            for (size_t i = 0; i < compiled.size(); ++i)
+            {
+                static const char padding[8] = {};
+
+                out.write(padding, static_cast<std::streamsize>(documents[i].offset - static_cast<uint64_t>(out.tellp())));
+                out.write(compiled[i].data(), static_cast<std::streamsize>(compiled[i].size()));
+            }
+
+            out.close();
+
+            // the snapshot of an older run is replaced, std::rename refuses to on windows
+            if (out && FuelCache::replace(temporary, filename)) { return true; }
+        }
+
+        std::remove(temporary.c_str());
+
+        return false;
+    }
+
+    bool ContentDb::loadSnapshot(const std::string& filename, const std::vector<SourceCrc>& sources)
+    {
+        auto file = MappedFile::open(filename);
+
+        if (!file) { return false; }
+
+        const std::string_view data = file->data();
+
+        Header header;
+
+        if (data.size() < sizeof(header)) { return false; }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) { return false; }
+
+        const uint64_t tables = sizeof(Header) + uint64_t(header.sourceCount) * sizeof(SourceEntry) + uint64_t(header.documentCount) * sizeof(DocumentEntry) + uint64_t(header.templateCount) * sizeof(TemplateEntry) + uint64_t(header.layerCount) * sizeof(LayerEntry) + (uint64_t(header.childCount) + header.attributeCount) * sizeof(uint32_t) + header.namesSize;
+
+        if (tables > data.size() || header.sourceCount != sources.size()) { return false; }
+
+        // the records are read in place, mmap hands out suitably aligned memory
+        const SourceEntry* sourceRecords = reinterpret_cast<const SourceEntry*>(data.data() + sizeof(Header));
+        const DocumentEntry* documents = reinterpret_cast<const DocumentEntry*>(sourceRecords + header.sourceCount);
+        const TemplateEntry* templates = reinterpret_cast<const TemplateEntry*>(documents + header.documentCount);
+        const LayerEntry* layers = reinterpret_cast<const LayerEntry*>(templates + header.templateCount);
+        const uint32_t* children = reinterpret_cast<const uint32_t*>(layers + header.layerCount);
+        const uint32_t* layerAttributes = children + header.childCount;
+        const char* names = reinterpret_cast<const char*>(layerAttributes + header.attributeCount);
+
+        const auto valid = [&header](const StringRef& ref) { return ref.offset <= header.namesSize && ref.size <= header.namesSize - ref.offset; };
+        const auto view = [names](const StringRef& ref) { return std::string_view(names + ref.offset, ref.size); };
+
+        // anything that changed since the snapshot was written makes it stale
+        for (uint32_t i = 0; i < header.sourceCount; ++i)
+        {
+            const SourceEntry& source = sourceRecords[i];
+
+            if (!valid(source.name) || view(source.name) != sources[i].name || source.crc != sources[i].crc || source.size != sources[i].size) { return false; }
+        }
+
+        std::vector<std::unique_ptr<Fuel>> loaded;
+
+        for (uint32_t i = 0; i < header.documentCount; ++i)
+        {
+            const DocumentEntry& document = documents[i];
+
+            if (document.offset < tables || document.offset % 8 != 0 || document.offset > data.size() || document.size > data.size() - document.offset) { return false; }
+
+            auto doc = std::make_unique<Fuel>();
+
+            if (!doc->loadBinary(file, data.substr(document.offset, document.size))) { return false; }
+
+            loaded.push_back(std::move(doc));
+        }
+
+        std::vector<const FuelBlock*> blocks;
+        std::vector<const Attribute*> attributes;
+
+        numberDocuments(loaded, blocks, attributes);
+
+        // validate everything before building anything
+        for (uint32_t i = 0; i < header.layerCount; ++i)
+        {
+            const LayerEntry& layer = layers[i];
+
+            if (layer.block >= blocks.size() || layer.owner >= header.templateCount) { return false; }
+
+            if (layer.firstChild > header.childCount || layer.childCount > header.childCount - layer.firstChild) { return false; }
+
+            if (layer.firstAttribute > header.attributeCount || layer.attributeCount > header.attributeCount - layer.firstAttribute) { return false; }
+
+            for (uint32_t c = 0; c < layer.childCount; ++c)
+            {
+                if (children[layer.firstChild + c] >= i) { return false; }
+            }
+
+            for (uint32_t a = 0; a < layer.attributeCount; ++a)
+            {
+                if (layerAttributes[layer.firstAttribute + a] >= attributes.size()) { return false; }
+            }
+        }
+
+        for (uint32_t i = 0; i < header.templateCount; ++i)
+        {
+            if (!valid(templates[i].name) || templates[i].layer >= header.layerCount) { return false; }
+        }
+
+        db.clear();
+        docs = std::move(loaded);
+
+        std::vector<ContentDb::Template*> owners(header.templateCount);
+
+        for (uint32_t i = 0; i < header.templateCount; ++i)
+        {
+            owners[i] = &db[std::string(view(templates[i].name))];
+        }
+
+        std::vector<const FuelLayer*> restored(header.layerCount);
+
+        for (uint32_t i = 0; i < header.layerCount; ++i)
+        {
+            const LayerEntry& layer = layers[i];
+
+            FuelLayer::ChildList childList(layer.childCount);
+            FuelLayer::AttributeList attributeList(layer.attributeCount);
+
+            for (uint32_t c = 0; c < layer.childCount; ++c)
+            {
+                childList[c] = restored[children[layer.firstChild + c]];
+            }
+
+            for (uint32_t a = 0; a < layer.attributeCount; ++a)
+            {
+                attributeList[a] = attributes[layerAttributes[layer.firstAttribute + a]];
+            }
+
+            restored[i] = FuelLayer::restore(blocks[layer.block], std::move(childList), std::move(attributeList), owners[layer.owner]->layers);
+        }
+
+        for (uint32_t i = 0; i < header.templateCount; ++i)
+        {
+            owners[i]->root = restored[templates[i].layer];
+        }
+
+        return true;
+    }
+} // namespace ehb
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ehb
+{
+    namespace bench
+    {
+        using Clock = std::chrono::steady_clock;
+
+        inline double millisecondsSince(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        inline double megabytesPerSecond(uint64_t bytes, double milliseconds)
+        {
+            return milliseconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+        }
+
+        //! minimal streaming json writer, we only need objects, arrays, strings and numbers
+        class JsonWriter
+        {
+        public:
+            explicit JsonWriter(std::ostream& stream) :
+                stream(stream) {}
+
+            void beginObject(const char* key = nullptr) { open(key, '{'); }
+            void endObject() { close('}'); }
+
+            void beginArray(const char* key = nullptr) { open(key, '['); }
+            void endArray() { close(']'); }
+
+            void value(const char* key, const std::string& value)
+            {
+                prefix(key);
+                stream << '"';
+                for (char c : value)
+                {
+                    switch (c)
+                    {
+                    case '"': stream << "\\\""; break;
+                    case '\\': stream << "\\\\"; break;
+                    case '\n': stream << "\\n"; break;
+                    case '\t': stream << "\\t"; break;
+                    default: stream << c; break;
+                    }
+                }
+                stream << '"';
+            }
+
+            void value(const char* key, const char* value) { this->value(key, std::string(value)); }
+
+            void value(const char* key, double value)
+            {
+                prefix(key);
+
+                char buffer[64];
+                std::snprintf(buffer, sizeof(buffer), "%.4f", value);
+                stream << buffer;
+            }
+
+            void value(const char* key, uint64_t value)
+            {
+                prefix(key);
+                stream << value;
+            }
+
+            void value(const char* key, uint32_t value) { this->value(key, static_cast<uint64_t>(value)); }
+
+            void value(const char* key, bool value)
+            {
+                prefix(key);
+                stream << (value ? "true" : "false");
+            }
+
+        private:
+            void open(const char* key, char bracket)
+            {
+                prefix(key);
+                stream << bracket;
+                first.push_back(true);
+            }
+
+            void close(char bracket)
+            {
+                first.pop_back();
+                stream << '\n'
+                       << std::string(first.size() * 2, ' ') << bracket;
+            }
+
+            void prefix(const char* key)
+            {
+                if (!first.empty())
+                {
+                    if (!first.back()) stream << ',';
+                    first.back() = false;
+
+                    stream << '\n'
+                           << std::string(first.size() * 2, ' ');
+                }
+
+                if (key) stream << '"' << key << "\": ";
+            }
+
+            std::ostream& stream;
+            std::vector<bool> first;
+        };
+
+        struct Percentiles
+        {
+            uint64_t count = 0;
+            double p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;
+        };
+
+        inline Percentiles percentiles(std::vector<double> samples)
+        {
+            Percentiles result;
+
+            if (samples.empty()) return result;
+
+            std::sort(samples.begin(), samples.end());
+
+            auto at = [&samples](double p) { return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))]; };
+
+            result.count = samples.size();
+            result.p50 = at(0.50);
+            result.p90 = at(0.90);
+            result.p99 = at(0.99);
+            result.p999 = at(0.999);
+            result.max = samples.back();
+
+            return result;
+        }
+    } // namespace bench
+} // namespace ehb
@@ -0,0 +1,766 @@
+// standalone benchmark for the I/O layer (TankFileSys and LocalFileSys)
+//
+// usage: siege-bench-filesys [--synthetic <dir>] [--synthetic-files <n>] [--max-files <n>]
+//                            [--iterations <n>] [--threads <n>] [--output <file.json>]
+//                            [--ds-install-path <path>] [--bits <path>]
+//
+// when --synthetic is passed a set of tanks and an equivalent loose bits tree are generated under
+// the directory and benchmarked. when DS content is found (--ds-install-path, --bits, or the regular
+// steam / registry / user configuration) the real tanks and bits are benchmarked as well.
+// all results are written as a single JSON document so they can be diffed between releases
+
+#include "bench/Benchmark.hpp"
+#include "cfg/WritableConfig.hpp"
+#include "io/LocalFileSys.hpp"
+#include "io/TankFileSys.hpp"
+#include "io/tank/TankFile.hpp"
+
+#include "miniz.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <vsg/utils/CommandLine.h>
+
+namespace ehb
+{
+    namespace bench
+    {
+        //! drain a stream the same way the loaders do and return the number of bytes read
+        inline uint64_t drain(std::istream& stream)
+        {
+            static thread_local std::vector<char> buffer(64 * 1024);
+
+            uint64_t total = 0;
+
+            while (stream.read(buffer.data(), buffer.size()) || stream.gcount() > 0)
+            {
+                total += static_cast<uint64_t>(stream.gcount());
+            }
+
+            return total;
+        }
+    } // namespace bench
+} // namespace ehb
+
+namespace ehb
+{
+    namespace bench
+    {
+        //! writes tank files that TankFile::Reader can index - this is only meant for benchmarking so
+        //! directory and file times, guids and the index crc are left zeroed out
+        class SyntheticTankWriter
+        {
+        public:
+            void add(const std::string& path, std::string data) { files.emplace(path, std::move(data)); }
+
+            bool write(const std::filesystem::path& filename, TankFile::DataFormat format, uint32_t priority) const;
+
+        private:
+            struct Dir
+            {
+                std::string name;
+                std::string parent;
+                std::vector<std::string> dirs;
+                std::vector<std::string> files;
+                uint32_t offset = 0;
+            };
+
+            static uint32_t nstringSize(const std::string& str)
+            {
+                // mirrors TankFile::readNString, which always pads the length word + characters up to the next dword
+                if (str.empty()) return 4;
+
+                const uint32_t size = static_cast<uint32_t>(str.size()) + 2;
+                return size + (4 - (size % 4));
+            }
+
+            static void writeU16(std::string& out, uint16_t value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+            static void writeU32(std::string& out, uint32_t value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+            static void writeZeros(std::string& out, size_t count) { out.append(count, '\0'); }
+
+            static void writeNString(std::string& out, const std::string& str)
+            {
+                if (str.empty())
+                {
+                    writeU16(out, 0);
+                    writeU16(out, 0);
+                    return;
+                }
+
+                const uint32_t size = nstringSize(str);
+
+                writeU16(out, static_cast<uint16_t>(str.size()));
+                out.append(str);
+                writeZeros(out, size - 2 - str.size());
+            }
+
+            // key: full path without a leading slash, value: file contents
+            std::map<std::string, std::string> files;
+        };
+
+        bool SyntheticTankWriter::write(const std::filesystem::path& filename, TankFile::DataFormat format, uint32_t priority) const
+        {
+            static constexpr uint32_t chunkSize = 16 * 1024;
+
+            // build the directory tree, the root directory is the empty string
+            std::map<std::string, Dir> dirs;
+            dirs[""];
+
+            for (const auto& [path, data] : files)
+            {
+                std::string parent;
+
+                for (auto slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1))
+                {
+                    const std::string dir = path.substr(0, slash);
+
+                    if (auto [itr, inserted] = dirs.try_emplace(dir); inserted)
+                    {
+                        itr->second.name = dir.substr(parent.empty() ? 0 : parent.size() + 1);
+                        itr->second.parent = parent;
+                        dirs[parent].dirs.push_back(dir);
+                    }
+
+                    parent = dir;
+                }
+
+                dirs[parent].files.push_back(path);
+            }
+
+            // encode the data section first so the fileset knows the final sizes
+            struct Encoded
+            {
+                uint32_t offset = 0;
+                uint32_t crc = 0;
+                uint32_t compressedSize = 0;
+                std::vector<std::array<uint32_t, 4>> chunks; // uncompressed, compressed, extra, offset
+            };
+
+            std::string data;
+            std::map<std::string, Encoded> encoded;
+
+            for (const auto& [path, contents] : files)
+            {
+                Encoded& entry = encoded[path];
+                entry.offset = static_cast<uint32_t>(data.size());
+                entry.crc = static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(contents.data()), contents.size()));
+
+                if (format == TankFile::DataFormat::Raw || contents.empty())
+                {
+                    data.append(contents);
+                }
+                else
+                {
+                    for (size_t offset = 0; offset < contents.size(); offset += chunkSize)
+                    {
+                        const size_t size = std::min<size_t>(chunkSize, contents.size() - offset);
+
+                        std::string chunk(mz_compressBound(static_cast<mz_ulong>(size)), '\0');
+                        mz_ulong chunkLen = static_cast<mz_ulong>(chunk.size());
+
+                        const bool compressed = mz_compress(reinterpret_cast<unsigned char*>(chunk.data()), &chunkLen, reinterpret_cast<const unsigned char*>(contents.data() + offset), static_cast<mz_ulong>(size)) == MZ_OK && chunkLen < size;
+
+                        // chunks that don't shrink are stored raw, the reader detects that by comparing sizes
+                        if (!compressed)
+                        {
+                            chunk.assign(contents, offset, size);
+                            chunkLen = static_cast<mz_ulong>(size);
+                        }
+
+                        entry.chunks.push_back({static_cast<uint32_t>(size), static_cast<uint32_t>(chunkLen), 0, static_cast<uint32_t>(data.size() - entry.offset)});
+
+                        data.append(chunk.data(), chunkLen);
+                    }
+
+                    entry.compressedSize = static_cast<uint32_t>(data.size() - entry.offset);
+                }
+
+                // keep every resource aligned like the retail tanks
+                writeZeros(data, (TankFile::DataAlignment - (data.size() % TankFile::DataAlignment)) % TankFile::DataAlignment);
+            }
+
+            // header
+            std::string header;
+            header.append("DSigTank", 8);
+            writeU32(header, TankFile::Header::ExpectedVersion);
+            const size_t offsetsPosition = header.size();
+            writeZeros(header, 4 * 4); // dirsetOffset, filesetOffset, indexSize, dataOffset
+            writeZeros(header, 12 * 2);  // product and minimum versions
+            writeU32(header, priority);
+            writeU32(header, TankFile::TankFlagNone);
+            header.append("USER", 4);
+            writeZeros(header, 16); // guid
+            writeU32(header, 0);    // indexCrc32
+            writeU32(header, static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(data.data()), data.size())));
+            writeZeros(header, 16); // utcBuildTime
+            writeZeros(header, sizeof(WideChar) * (TankFile::Header::CopyrightTextMaxLength + TankFile::Header::BuildTextMaxLength + TankFile::Header::TitleTextMaxLength + TankFile::Header::AuthorTextMaxLength));
+            writeU16(header, 0); // descriptionText
+            writeU16(header, 0);
+
+            // dirset - offsets are relative to the start of the dirset
+            uint32_t position = 4 + 4 * static_cast<uint32_t>(dirs.size());
+            for (auto& [path, dir] : dirs)
+            {
+                dir.offset = position;
+                position += 4 + 4 + 8 + nstringSize(dir.name) + 4 * static_cast<uint32_t>(dir.dirs.size() + dir.files.size());
+            }
+
+            // fileset - offsets are relative to the start of the fileset
+            std::map<std::string, uint32_t> fileOffsets;
+            position = 4 + 4 * static_cast<uint32_t>(files.size());
+            for (const auto& [path, contents] : files)
+            {
+                fileOffsets[path] = position;
+                position += 4 * 4 + 8 + 2 + 2 + nstringSize(path.substr(path.find_last_of('/') + 1));
+
+                if (const auto& entry = encoded[path]; !entry.chunks.empty())
+                {
+                    position += 4 + 4 + 16 * static_cast<uint32_t>(entry.chunks.size());
+                }
+            }
+
+            std::string dirset;
+            writeU32(dirset, static_cast<uint32_t>(dirs.size()));
+            for (const auto& [path, dir] : dirs) writeU32(dirset, dir.offset);
+            for (const auto& [path, dir] : dirs)
+            {
+                writeU32(dirset, path.empty() ? 0 : dirs[dir.parent].offset);
+                writeU32(dirset, static_cast<uint32_t>(dir.dirs.size() + dir.files.size()));
+                writeZeros(dirset, 8);
+                writeNString(dirset, dir.name);
+                for (const auto& child : dir.dirs) writeU32(dirset, dirs[child].offset);
+                for (const auto& child : dir.files) writeU32(dirset, fileOffsets[child]);
+            }
+
+            std::string fileset;
+            writeU32(fileset, static_cast<uint32_t>(files.size()));
+            for (const auto& [path, contents] : files) writeU32(fileset, fileOffsets[path]);
+            for (const auto& [path, contents] : files)
+            {
+                const auto slash = path.find_last_of('/');
+                const auto& entry = encoded[path];
+                const bool compressed = !entry.chunks.empty();
+
+                writeU32(fileset, dirs[slash == std::string::npos ? std::string() : path.substr(0, slash)].offset);
+                writeU32(fileset, static_cast<uint32_t>(contents.size()));
+                writeU32(fileset, entry.offset);
+                writeU32(fileset, entry.crc);
+                writeZeros(fileset, 8);
+                writeU16(fileset, static_cast<uint16_t>(compressed ? TankFile::DataFormat::Zlib : TankFile::DataFormat::Raw));
+                writeU16(fileset, TankFile::FileFlagNone);
+                writeNString(fileset, path.substr(slash + 1));
+
+                if (compressed)
+                {
+                    writeU32(fileset, entry.compressedSize);
+                    writeU32(fileset, chunkSize);
+
+                    for (const auto& chunk : entry.chunks)
+                    {
+                        for (uint32_t value : chunk) writeU32(fileset, value);
+                    }
+                }
+            }
+
+            const uint32_t dirsetOffset = static_cast<uint32_t>(header.size());
+            const uint32_t filesetOffset = dirsetOffset + static_cast<uint32_t>(dirset.size());
+            const uint32_t indexSize = filesetOffset + static_cast<uint32_t>(fileset.size());
+            const uint32_t dataOffset = indexSize + (TankFile::DataSectionAlignment - (indexSize % TankFile::DataSectionAlignment));
+
+            std::memcpy(&header[offsetsPosition + 0], &dirsetOffset, 4);
+            std::memcpy(&header[offsetsPosition + 4], &filesetOffset, 4);
+            std::memcpy(&header[offsetsPosition + 8], &indexSize, 4);
+            std::memcpy(&header[offsetsPosition + 12], &dataOffset, 4);
+
+            std::ofstream stream(filename, std::ios_base::binary);
+
+            stream << header << dirset << fileset << std::string(dataOffset - indexSize, '\0') << data;
+
+            return stream.good();
+        }
+
+        //! generates a tree of gas-like text files plus some larger binary blobs, the size mix roughly follows
+        //! the retail resources: lots of small gas files, a fair amount of textures and a handful of large meshes
+        class SyntheticContent
+        {
+        public:
+            SyntheticContent(uint32_t fileCount, uint32_t seed = 0x5133) :
+                rng(seed)
+            {
+                static const char* directories[] = {"world/contentdb/templates/regular", "world/contentdb/templates/veteran", "world/global/siege_nodes", "world/maps/bench_map/regions/r0/terrain_nodes", "art/bitmaps/terrain", "art/meshes/terrain", "ui/interfaces/backend"};
+
+                for (uint32_t index = 0; index < fileCount; ++index)
+                {
+                    const std::string directory = directories[rng() % std::size(directories)];
+                    const uint32_t roll = rng() % 100;
+
+                    char name[64];
+                    if (roll < 70)
+                    {
+                        std::snprintf(name, sizeof(name), "/gen_%05u.gas", index);
+                        files.emplace_back(directory + name, gas(256 + rng() % 3840));
+                    }
+                    else if (roll < 97)
+                    {
+                        std::snprintf(name, sizeof(name), "/gen_%05u.raw", index);
+                        files.emplace_back(directory + name, blob(16 * 1024 + rng() % (240 * 1024)));
+                    }
+                    else
+                    {
+                        std::snprintf(name, sizeof(name), "/gen_%05u.sno", index);
+                        files.emplace_back(directory + name, blob(1024 * 1024 + rng() % (3 * 1024 * 1024)));
+                    }
+                }
+            }
+
+            std::vector<std::pair<std::string, std::string>> files;
+
+        private:
+            std::string gas(size_t size)
+            {
+                std::string result;
+                result.reserve(size + 64);
+
+                char line[128];
+                for (uint32_t block = 0; result.size() < size; ++block)
+                {
+                    std::snprintf(line, sizeof(line), "[t:template,n:gen_%u]\n{\n", block);
+                    result += line;
+
+                    for (uint32_t attr = 0; attr < 8; ++attr)
+                    {
+                        std::snprintf(line, sizeof(line), "\tf value_%u = %u.%03u;\n\tx guid_%u = 0x%08x;\n", attr, rng() % 1000, rng() % 1000, attr, rng());
+                        result += line;
+                    }
+
+                    result += "}\n";
+                }
+
+                return result;
+            }
+
+            std::string blob(size_t size)
+            {
+                // half noise, half runs so compression has something to chew on
+                std::string result(size, '\0');
+                for (size_t i = 0; i < size; i += 2)
+                {
+                    result[i] = static_cast<char>(rng());
+                }
+
+                return result;
+            }
+
+            std::mt19937 rng;
+        };
+
+        //! writes the synthetic content as both tanks (one raw, one zlib) and a loose bits tree
+        inline void generateSynthetic(const std::filesystem::path& root, uint32_t fileCount)
+        {
+            namespace stdfs = std::filesystem;
+
+            SyntheticContent content(fileCount);
+
+            stdfs::create_directories(root / "install" / "Resources");
+            stdfs::create_directories(root / "install" / "Maps");
+            stdfs::create_directories(root / "bits");
+
+            SyntheticTankWriter raw, zlib;
+
+            for (size_t index = 0; index < content.files.size(); ++index)
+            {
+                const auto& [path, data] = content.files[index];
+
+                // split the content over two tanks so lookups have to walk past the first one
+                (index % 2 == 0 ? raw : zlib).add(path, data);
+
+                const stdfs::path loose = root / "bits" / path;
+                stdfs::create_directories(loose.parent_path());
+                std::ofstream(loose, std::ios_base::binary) << data;
+            }
+
+            raw.write(root / "install" / "Resources" / "bench_raw.dsres", TankFile::DataFormat::Raw, static_cast<uint32_t>(TankFile::Priority::Factory));
+            zlib.write(root / "install" / "Resources" / "bench_zlib.dsres", TankFile::DataFormat::Zlib, static_cast<uint32_t>(TankFile::Priority::Expansion));
+        }
+    } // namespace bench
+} // namespace ehb
+
+namespace ehb
+{
+    namespace bench
+    {
+        struct Settings
+        {
+            uint32_t iterations = 3;
+            uint32_t maxFiles = 4000;
+            uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        };
+
+        //! open and index every tank under the given directories
+        inline void benchmarkTankIndex(JsonWriter& json, const std::vector<std::filesystem::path>& directories, const Settings& settings)
+        {
+            json.beginArray("index");
+
+            for (const auto& directory : directories)
+            {
+                std::error_code ec;
+                for (const auto& entry : std::filesystem::directory_iterator(directory, ec))
+                {
+                    if (!TankFileSys::isTankFileExtension(entry.path().extension().string())) continue;
+
+                    std::vector<double> openSamples, indexSamples;
+                    uint32_t fileCount = 0, dirCount = 0;
+
+                    for (uint32_t i = 0; i < settings.iterations; ++i)
+                    {
+                        TankFile tank;
+                        TankFile::Reader reader;
+
+                        auto start = Clock::now();
+                        tank.openForReading(entry.path().generic_string());
+                        openSamples.push_back(millisecondsSince(start));
+
+                        start = Clock::now();
+                        reader.indexFile(tank);
+                        indexSamples.push_back(millisecondsSince(start));
+
+                        fileCount = reader.getFileCount();
+                        dirCount = reader.getDirectoryCount();
+                    }
+
+                    json.beginObject();
+                    json.value("tank", entry.path().filename().string());
+                    json.value("size_bytes", static_cast<uint64_t>(entry.file_size()));
+                    json.value("files", fileCount);
+                    json.value("directories", dirCount);
+                    json.value("open_ms", percentiles(openSamples).p50);
+                    json.value("index_ms", percentiles(indexSamples).p50);
+                    json.endObject();
+                }
+            }
+
+            json.endArray();
+        }
+
+        //! @return the timing of one pass over files as {milliseconds, bytes}
+        inline std::pair<double, uint64_t> extractPass(IFileSys& fileSys, const std::vector<std::string>& files, std::vector<double>* latencies = nullptr, const std::vector<uint64_t>* sizes = nullptr)
+        {
+            uint64_t bytes = 0;
+
+            const auto start = Clock::now();
+
+            for (size_t index = 0; index < files.size(); ++index)
+            {
+                const auto fileStart = Clock::now();
+
+                if (auto stream = fileSys.createInputStream(files[index])) { bytes += drain(*stream); }
+
+                if (latencies && sizes && (*sizes)[index] <= TankFile::LargeFileSize)
+                {
+                    latencies->push_back(millisecondsSince(fileStart) * 1000.0);
+                }
+            }
+
+            return {millisecondsSince(start), bytes};
+        }
+
+        inline void writeThroughput(JsonWriter& json, const char* key, size_t files, const std::vector<std::pair<double, uint64_t>>& passes)
+        {
+            std::vector<double> times;
+            for (const auto& pass : passes) times.push_back(pass.first);
+
+            const double ms = percentiles(times).p50;
+            const uint64_t bytes = passes.empty() ? 0 : passes.front().second;
+
+            json.beginObject(key);
+            json.value("files", static_cast<uint64_t>(files));
+            json.value("bytes", bytes);
+            json.value("ms", ms);
+            json.value("mb_per_s", megabytesPerSecond(bytes, ms));
+            json.endObject();
+        }
+
+        inline void benchmarkFileSys(JsonWriter& json, const std::string& name, IFileSys& fileSys, IConfig& config, const std::vector<std::filesystem::path>& tankDirectories, const Settings& settings)
+        {
+            json.beginObject();
+            json.value("name", name);
+
+            {
+                const auto start = Clock::now();
+                const bool initialized = fileSys.init(config);
+                json.value("init_ms", millisecondsSince(start));
+                json.value("initialized", initialized);
+            }
+
+            if (!tankDirectories.empty()) { benchmarkTankIndex(json, tankDirectories, settings); }
+
+            // take a deterministic, evenly spaced sample of the files so runs stay comparable
+            std::vector<std::string> files;
+            {
+                const auto start = Clock::now();
+                const FileList all = fileSys.getFiles();
+                json.value("list_ms", millisecondsSince(start));
+                json.value("files_total", static_cast<uint64_t>(all.size()));
+
+                std::vector<std::string> candidates;
+                for (const auto& filename : all)
+                {
+                    if (!vsg::lowerCaseFileExtension(filename).empty()) candidates.push_back(filename);
+                }
+
+                const size_t step = std::max<size_t>(1, candidates.size() / std::max(1u, settings.maxFiles));
+                for (size_t index = 0; index < candidates.size() && files.size() < settings.maxFiles; index += step)
+                {
+                    files.push_back(candidates[index]);
+                }
+            }
+
+            // the first pass tells us how large each file is. it is the first read in this process, not a cold cache one:
+            // the page cache isn't evicted, so a previous run or the tanks having just been generated leaves it warm
+            std::vector<uint64_t> sizes;
+            {
+                uint64_t bytes = 0;
+                const auto start = Clock::now();
+
+                for (const auto& filename : files)
+                {
+                    auto stream = fileSys.createInputStream(filename);
+                    sizes.push_back(stream ? drain(*stream) : 0);
+                    bytes += sizes.back();
+                }
+
+                const double firstPassMs = millisecondsSince(start);
+
+                std::vector<double> warmSamples;
+                for (uint32_t i = 0; i < settings.iterations; ++i)
+                {
+                    warmSamples.push_back(extractPass(fileSys, files).first);
+                }
+
+                const double warmMs = percentiles(warmSamples).p50;
+
+                // negative lookups have to walk every mounted tank before giving up
+                std::vector<double> missSamples;
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    const auto missStart = Clock::now();
+                    fileSys.createInputStream("/bench/does_not_exist_" + std::to_string(i) + ".gas");
+                    missSamples.push_back(millisecondsSince(missStart) * 1000.0);
+                }
+
+                json.value("files_sampled", static_cast<uint64_t>(files.size()));
+                json.value("bytes_sampled", bytes);
+
+                json.beginObject("cache");
+                json.value("first_pass_ms", firstPassMs);
+                json.value("warm_ms", warmMs);
+                json.value("first_pass_ratio", warmMs > 0.0 ? firstPassMs / warmMs : 0.0);
+                json.value("miss_lookup_us", percentiles(missSamples).p50);
+                json.endObject();
+            }
+
+            { // sequential in path order, which is also the order files are laid out in the tanks
+                std::vector<std::pair<double, uint64_t>> passes;
+                for (uint32_t i = 0; i < settings.iterations; ++i) passes.push_back(extractPass(fileSys, files));
+
+                writeThroughput(json, "sequential", files.size(), passes);
+            }
+
+            { // random order with a fixed seed
+                std::vector<size_t> order(files.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::shuffle(order.begin(), order.end(), std::mt19937(0x5133));
+
+                std::vector<std::string> shuffled;
+                for (size_t index : order) shuffled.push_back(files[index]);
+
+                std::vector<std::pair<double, uint64_t>> passes;
+                for (uint32_t i = 0; i < settings.iterations; ++i) passes.push_back(extractPass(fileSys, shuffled));
+
+                writeThroughput(json, "random", files.size(), passes);
+            }
+
+            { // open + read latency of small files, in microseconds
+                std::vector<double> latencies;
+                for (uint32_t i = 0; i < settings.iterations; ++i) extractPass(fileSys, files, &latencies, &sizes);
+
+                const Percentiles p = percentiles(latencies);
+
+                json.beginObject("small_file_latency_us");
+                json.value("max_size_bytes", TankFile::LargeFileSize);
+                json.value("count", p.count);
+                json.value("p50", p.p50);
+                json.value("p90", p.p90);
+                json.value("p99", p.p99);
+                json.value("p999", p.p999);
+                json.value("max", p.max);
+                json.endObject();
+            }
+
+            { // multi-threaded extraction, each thread pulls the next file from a shared counter
+                json.beginArray("threads");
+
+                double baseline = 0.0;
+
+                for (uint32_t threadCount = 1; threadCount <= settings.maxThreads; threadCount *= 2)
+                {
+                    std::vector<double> samples;
+                    uint64_t bytes = 0;
+
+                    for (uint32_t i = 0; i < settings.iterations; ++i)
+                    {
+                        std::atomic<size_t> next{0};
+                        std::atomic<uint64_t> total{0};
+                        std::vector<std::thread> threads;
+
+                        const auto start = Clock::now();
+
+                        for (uint32_t t = 0; t < threadCount; ++t)
+                        {
+                            threads.emplace_back([&]() {
+                                for (size_t index = next++; index < files.size(); index = next++)
+                                {
+                                    if (auto stream = fileSys.createInputStream(files[index])) { total += drain(*stream); }
+                                }
+                            });
+                        }
+
+                        for (auto& thread : threads) thread.join();
+
+                        samples.push_back(millisecondsSince(start));
+                        bytes = total;
+                    }
+
+                    const double ms = percentiles(samples).p50;
+                    if (threadCount == 1) baseline = ms;
+
+                    json.beginObject();
+                    json.value("threads", threadCount);
+                    json.value("ms", ms);
+                    json.value("mb_per_s", megabytesPerSecond(bytes, ms));
+                    json.value("speedup", ms > 0.0 ? baseline / ms : 0.0);
+                    json.endObject();
+                }
+
+                json.endArray();
+            }
+
+            json.endObject();
+        }
+    } // namespace bench
+} // namespace ehb
+
+int main(int argc, char* argv[])
+{
+    using namespace ehb;
+    using namespace ehb::bench;
+
+    // keep stdout clean for the json report
+    spdlog::stderr_color_mt("log")->set_level(spdlog::level::warn);
+    spdlog::stderr_color_mt("filesystem")->set_level(spdlog::level::warn);
+
+    Settings settings;
+    std::string synthetic, output;
+    uint32_t syntheticFiles = 2000;
+
+    vsg::CommandLine args(&argc, argv);
+    args.read("--synthetic", synthetic);
+    args.read("--synthetic-files", syntheticFiles);
+    args.read("--iterations", settings.iterations);
+    args.read("--max-files", settings.maxFiles);
+    args.read("--threads", settings.maxThreads);
+    args.read("--output", output);
+
+    settings.iterations = std::max(1u, settings.iterations);
+    settings.maxThreads = std::max(1u, settings.maxThreads);
+
+    std::ostringstream report;
+    JsonWriter json(report);
+
+    char timestamp[64] = {'\0'};
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    json.beginObject();
+    json.value("benchmark", "filesys");
+    json.value("schema", 1u);
+    json.value("timestamp", timestamp);
+    json.value("hardware_threads", std::thread::hardware_concurrency());
+    json.value("iterations", settings.iterations);
+    json.beginArray("suites");
+
+    if (!synthetic.empty())
+    {
+        const std::filesystem::path root(synthetic);
+
+        if (!std::filesystem::exists(root / "install" / "Resources"))
+        {
+            spdlog::get("log")->warn("generating {} synthetic files under {}", syntheticFiles, synthetic);
+
+            generateSynthetic(root, syntheticFiles);
+        }
+
+        {
+            WritableConfig config;
+            config.setString("ds-install-path", (root / "install").string());
+
+            TankFileSys fileSys;
+            benchmarkFileSys(json, "synthetic/TankFileSys", fileSys, config, {root / "install" / "Resources"}, settings);
+        }
+        {
+            WritableConfig config;
+            config.setString("bits", (root / "bits").string());
+
+            LocalFileSys fileSys;
+            benchmarkFileSys(json, "synthetic/LocalFileSys", fileSys, config, {}, settings);
+        }
+    }
+
+    // real content is picked up the same way the game does it
+    WritableConfig config(argc, argv);
+    const IConfig& gameConfig = config;
+
+    if (const std::string& installPath = gameConfig.getString("ds-install-path"); !installPath.empty())
+    {
+        // don't let loose bits shadow the tanks we are trying to measure
+        WritableConfig tankConfig(config);
+        tankConfig.setString("bits", "");
+
+        TankFileSys fileSys;
+        benchmarkFileSys(json, "retail/TankFileSys", fileSys, tankConfig, {std::filesystem::path(installPath) / "Resources", std::filesystem::path(installPath) / "Maps"}, settings);
+    }
+
+    if (!gameConfig.getString("bits").empty())
+    {
+        LocalFileSys fileSys;
+        benchmarkFileSys(json, "retail/LocalFileSys", fileSys, config, {}, settings);
+    }
+
+    json.endArray();
+    json.endObject();
+
+    report << '\n';
+
+    if (!output.empty()) { std::ofstream(output) << report.str(); }
+    else
+    {
+        std::cout << report.str();
+    }
+
+    return 0;
+}
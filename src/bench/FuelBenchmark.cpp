@@ -0,0 +1,706 @@
+// standalone benchmark for the gas parsers, FuelBlock queries and ContentDb
+//
+// usage: siege-bench-fuel [--corpus <dir>] [--generate <dir>] [--iterations <n>] [--queries <n>] [--output <file.json>]
+//                         [--seed <n>] [--files <n>] [--blocks <n>] [--depth <n>] [--fan-out <n>] [--attributes <n>]
+//                         [--templates <n>] [--template-files <n>] [--chain <n>] [--type-mix <word,string,int,hex,float,bool,vector>]
+//
+// without --corpus a synthetic corpus is generated from the settings, into the --generate directory when one is
+// given (and kept) or into a temporary one otherwise. every .gas file under the corpus is parsed with each parser,
+// a sample of blocks and attributes is queried and, if the corpus has world/contentdb/templates, ContentDb::init
+// is timed on it. all results are written as a single JSON document so they can be diffed between releases
+
+#include "ContentDb.hpp"
+#include "bench/Benchmark.hpp"
+#include "bench/SyntheticGas.hpp"
+#include "cfg/WritableConfig.hpp"
+#include "gas/Fuel.hpp"
+#include "gas/FuelCache.hpp"
+#include "gas/FuelLayer.hpp"
+#include "gas/FuelNumeric.hpp"
+#include "gas/FuelReader.hpp"
+#include "io/LocalFileSys.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <vsg/utils/CommandLine.h>
+
+// every allocation made through operator new is counted so the parsers can be compared by how much they allocate,
+// the size is kept in front of each block so what is still alive can be tracked as well
+namespace
+{
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> allocationBytes{0};
+    std::atomic<uint64_t> liveBytes{0};
+
+    constexpr std::size_t AllocationHeader = alignof(std::max_align_t);
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    liveBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (auto ptr = static_cast<unsigned char*>(std::malloc(size + AllocationHeader)))
+    {
+        *reinterpret_cast<std::size_t*>(ptr) = size;
+
+        return ptr + AllocationHeader;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr == nullptr) { return; }
+
+    auto block = static_cast<unsigned char*>(ptr) - AllocationHeader;
+
+    liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { operator delete(ptr); }
+
+namespace ehb
+{
+    namespace bench
+    {
+        struct Allocations
+        {
+            uint64_t count = 0;
+            uint64_t bytes = 0;
+
+            static Allocations now() { return {allocationCount.load(std::memory_order_relaxed), allocationBytes.load(std::memory_order_relaxed)}; }
+
+            Allocations since() const
+            {
+                const Allocations current = now();
+
+                return {current.count - count, current.bytes - bytes};
+            }
+        };
+
+        struct Settings
+        {
+            uint32_t iterations = 5;
+            uint32_t queries = 100000;
+        };
+
+        struct Corpus
+        {
+            std::vector<std::pair<std::string, std::string>> files;
+            uint64_t bytes = 0;
+        };
+
+        inline Corpus loadCorpus(const std::filesystem::path& root)
+        {
+            Corpus corpus;
+
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(root))
+            {
+                if (!entry.is_regular_file() || entry.path().extension() != ".gas") { continue; }
+
+                std::ifstream stream(entry.path(), std::ios_base::binary);
+                std::string data(std::istreambuf_iterator<char>(stream), {});
+
+                corpus.bytes += data.size();
+                corpus.files.emplace_back(entry.path().generic_string(), std::move(data));
+            }
+
+            // directory iteration order isn't specified, keep runs comparable
+            std::sort(corpus.files.begin(), corpus.files.end());
+
+            return corpus;
+        }
+
+        //! time one way of parsing the whole corpus, the copies handed to the parser are made outside of the measurement
+        inline void benchmarkParse(JsonWriter& json, const char* name, const Corpus& corpus, const Settings& settings, const std::function<bool(std::string&&)>& parse)
+        {
+            std::vector<double> samples;
+            Allocations allocations;
+            size_t failures = 0;
+
+            for (uint32_t i = 0; i < settings.iterations; ++i)
+            {
+                double ms = 0.0;
+                const Allocations before = Allocations::now();
+                Allocations copies;
+
+                for (const auto& [path, data] : corpus.files)
+                {
+                    const Allocations copyStart = Allocations::now();
+                    std::string copy = data;
+                    const Allocations copied = copyStart.since();
+
+                    copies.count += copied.count;
+                    copies.bytes += copied.bytes;
+
+                    const auto start = Clock::now();
+
+                    if (!parse(std::move(copy)) && i == 0) { ++failures; }
+
+                    ms += millisecondsSince(start);
+                }
+
+                samples.push_back(ms);
+
+                if (i == 0)
+                {
+                    const Allocations total = before.since();
+
+                    allocations = {total.count - copies.count, total.bytes - copies.bytes};
+                }
+            }
+
+            const double ms = percentiles(samples).p50;
+            const double kilobytes = std::max(1.0, corpus.bytes / 1024.0);
+
+            json.beginObject();
+            json.value("name", name);
+            json.value("ms", ms);
+            json.value("mb_per_s", megabytesPerSecond(corpus.bytes, ms));
+            json.value("allocations_per_kb", allocations.count / kilobytes);
+            json.value("allocated_bytes_per_kb", allocations.bytes / kilobytes);
+            json.value("failures", static_cast<uint64_t>(failures));
+            json.endObject();
+        }
+
+        //! the blocks and attributes queries are made against, gathered from the parsed corpus
+        struct QuerySet
+        {
+            std::vector<std::pair<const FuelBlock*, std::string>> children;
+            std::vector<std::pair<const FuelBlock*, std::string>> values, ints, floats, bools, guids, vectors, strings;
+        };
+
+        inline void collectQueries(const FuelBlock* node, QuerySet& queries)
+        {
+            for (const FuelBlock* child : node->eachChild())
+            {
+                queries.children.emplace_back(node, std::string(child->name()));
+
+                collectQueries(child, queries);
+            }
+
+            for (const auto& attr : node->eachAttribute())
+            {
+                auto entry = std::make_pair(node, std::string(attr.name));
+
+                queries.values.push_back(entry);
+
+                if (attr.type == "i") { queries.ints.push_back(entry); }
+                else if (attr.type == "f") { queries.floats.push_back(entry); }
+                else if (attr.type == "b") { queries.bools.push_back(entry); }
+                else if (attr.type == "x") { queries.guids.push_back(entry); }
+                else if (!attr.value.empty() && attr.value.front() == '"') { queries.strings.push_back(entry); }
+                else if (attr.value.find(',') != std::string_view::npos) { queries.vectors.push_back(entry); }
+            }
+        }
+
+        /**
+         * time a query over a random sample of the targets. the clock is only read every Batch queries so its own
+         * cost stays out of the numbers, the percentiles are of the average latency within each batch
+         */
+        template <typename Query>
+        inline void benchmarkQuery(JsonWriter& json, const char* name, const std::vector<std::pair<const FuelBlock*, std::string>>& targets, const Settings& settings, Query query)
+        {
+            constexpr size_t Batch = 64;
+
+            if (targets.empty()) { return; }
+
+            std::mt19937 rng(0x5133);
+            std::vector<size_t> order(settings.queries);
+
+            for (auto& index : order)
+            {
+                index = rng() % targets.size();
+            }
+
+            std::vector<double> samples;
+            uint64_t sink = 0;
+
+            for (size_t first = 0; first + Batch <= order.size(); first += Batch)
+            {
+                const auto start = Clock::now();
+
+                for (size_t index = first; index < first + Batch; ++index)
+                {
+                    const auto& [node, key] = targets[order[index]];
+
+                    sink += query(node, key);
+                }
+
+                samples.push_back(millisecondsSince(start) * 1e6 / Batch);
+            }
+
+            const Percentiles p = percentiles(samples);
+
+            json.beginObject();
+            json.value("name", name);
+            json.value("targets", static_cast<uint64_t>(targets.size()));
+            json.value("queries", static_cast<uint64_t>(samples.size() * Batch));
+            json.value("p50_ns", p.p50);
+            json.value("p90_ns", p.p90);
+            json.value("p99_ns", p.p99);
+            json.value("max_ns", p.max);
+            // keeps the compiler from dropping the queries
+            json.value("checksum", sink & 0xffff);
+            json.endObject();
+        }
+
+        inline void benchmarkQueries(JsonWriter& json, const char* key, const QuerySet& queries, const Settings& settings)
+        {
+            json.beginArray(key);
+
+            benchmarkQuery(json, "child", queries.children, settings, [](const FuelBlock* node, const std::string& name) { return node->child(name) != nullptr; });
+            benchmarkQuery(json, "valueOf", queries.values, settings, [](const FuelBlock* node, const std::string& name) { return node->valueOf(name).size(); });
+            benchmarkQuery(json, "valueAsInt", queries.ints, settings, [](const FuelBlock* node, const std::string& name) { return static_cast<uint64_t>(node->valueAsInt(name)); });
+            benchmarkQuery(json, "valueAsFloat", queries.floats, settings, [](const FuelBlock* node, const std::string& name) { return static_cast<uint64_t>(node->valueAsFloat(name)); });
+            benchmarkQuery(json, "valueAsBool", queries.bools, settings, [](const FuelBlock* node, const std::string& name) { return static_cast<uint64_t>(node->valueAsBool(name)); });
+            benchmarkQuery(json, "valueAsGuid", queries.guids, settings, [](const FuelBlock* node, const std::string& name) { return static_cast<uint64_t>(node->valueAsGuid(name)); });
+            benchmarkQuery(json, "valueAsFloat3", queries.vectors, settings, [](const FuelBlock* node, const std::string& name) { return static_cast<uint64_t>(node->valueAsFloat3(name)[2]); });
+            benchmarkQuery(json, "valueAsString", queries.strings, settings, [](const FuelBlock* node, const std::string& name) { return node->valueAsString(name).size(); });
+
+            json.endArray();
+        }
+
+        inline void benchmarkContentDb(JsonWriter& json, const std::filesystem::path& root, const Settings& settings)
+        {
+            WritableConfig config;
+            config.setString("bits", root.string());
+
+            LocalFileSys fileSys;
+
+            if (!fileSys.init(config)) { return; }
+
+            json.beginObject("contentdb");
+
+            std::vector<double> samples;
+            Allocations allocations;
+            uint64_t residentBytes = 0;
+            std::unique_ptr<ContentDb> contentDb;
+
+            for (uint32_t i = 0; i < settings.iterations; ++i)
+            {
+                // tear the previous one down first so it doesn't show up in the allocations
+                contentDb.reset();
+                contentDb = std::make_unique<ContentDb>();
+
+                const Allocations before = Allocations::now();
+                const uint64_t live = liveBytes.load(std::memory_order_relaxed);
+                const auto start = Clock::now();
+
+                contentDb->init(fileSys);
+
+                samples.push_back(millisecondsSince(start));
+
+                if (i == 0)
+                {
+                    allocations = before.since();
+                    residentBytes = liveBytes.load(std::memory_order_relaxed) - live;
+                }
+            }
+
+            // the resolved templates are found again through the files they came from
+            std::vector<std::string> names, queries;
+
+            for (const auto& filename : fileSys.getFiles())
+            {
+                if (filename.find("/world/contentdb/templates/") != 0 || std::filesystem::path(filename).extension() != ".gas") { continue; }
+
+                Fuel doc;
+
+                if (auto stream = fileSys.createInputStream(filename); stream && doc.load(*stream))
+                {
+                    for (const FuelBlock* node : doc.eachChild())
+                    {
+                        names.emplace_back(node->name());
+                    }
+                }
+            }
+
+            size_t resolved = 0;
+
+            for (const auto& name : names)
+            {
+                if (const FuelLayer* tmpl = contentDb->getGameObjectTmpl(name))
+                {
+                    ++resolved;
+
+                    for (const FuelLayer* component : tmpl->eachChild())
+                    {
+                        for (const Attribute* attr : component->eachAttribute())
+                        {
+                            queries.push_back(name + ":" + std::string(component->name()) + ":" + std::string(attr->name));
+                        }
+                    }
+                }
+            }
+
+            json.value("templates", static_cast<uint64_t>(names.size()));
+            json.value("resolved", static_cast<uint64_t>(resolved));
+            json.value("init_ms", percentiles(samples).p50);
+            json.value("allocations", allocations.count);
+            json.value("allocated_bytes", allocations.bytes);
+            json.value("resident_bytes", residentBytes);
+
+            if (!queries.empty())
+            {
+                // the same targets once through queryString and once through handles compiled up front
+                std::vector<ContentDb::Query> compiled;
+
+                compiled.reserve(queries.size());
+
+                for (const auto& query : queries)
+                {
+                    compiled.push_back(contentDb->compile(query));
+                }
+
+                auto benchmark = [&queries, &json](const char* name, size_t count, auto&& query) {
+                    constexpr size_t Batch = 64;
+
+                    std::mt19937 rng(0x5133);
+                    std::vector<double> latencies;
+                    uint64_t sink = 0;
+
+                    for (size_t first = 0; first + Batch <= count; first += Batch)
+                    {
+                        std::array<size_t, Batch> batch;
+
+                        for (auto& index : batch)
+                        {
+                            index = rng() % queries.size();
+                        }
+
+                        const auto start = Clock::now();
+
+                        for (size_t index : batch)
+                        {
+                            sink += query(index);
+                        }
+
+                        latencies.push_back(millisecondsSince(start) * 1e6 / Batch);
+                    }
+
+                    const Percentiles p = percentiles(latencies);
+
+                    json.beginObject(name);
+                    json.value("targets", static_cast<uint64_t>(queries.size()));
+                    json.value("p50_ns", p.p50);
+                    json.value("p90_ns", p.p90);
+                    json.value("p99_ns", p.p99);
+                    json.value("max_ns", p.max);
+                    json.value("checksum", sink & 0xffff);
+                    json.endObject();
+                };
+
+                benchmark("query_string", settings.queries, [&](size_t index) { return contentDb->queryString(queries[index]).size(); });
+                benchmark("compiled_query", settings.queries, [&](size_t index) { return compiled[index].valueOf().size(); });
+
+                // every template with the same value as the query, once through the index and once by visiting them all
+                std::vector<double> build;
+
+                for (uint32_t i = 0; i < settings.iterations; ++i)
+                {
+                    const auto start = Clock::now();
+
+                    contentDb->buildIndex();
+
+                    build.push_back(millisecondsSince(start));
+                }
+
+                const ContentDbIndex& index = *contentDb->index();
+
+                std::vector<std::pair<FuelPath, std::string_view>> lookups;
+
+                lookups.reserve(queries.size());
+
+                for (size_t i = 0; i < queries.size(); ++i)
+                {
+                    // the template name is the first segment of the query
+                    lookups.emplace_back(std::string_view(queries[i]).substr(queries[i].find(':') + 1), compiled[i].valueOf());
+                }
+
+                json.beginObject("attribute_index");
+                json.value("build_ms", percentiles(build).p50);
+                json.value("paths", static_cast<uint64_t>(index.pathCount()));
+                json.value("entries", static_cast<uint64_t>(index.entryCount()));
+
+                benchmark("with_value", settings.queries, [&](size_t i) { return index.withValue(lookups[i].first.str(), lookups[i].second).size(); });
+
+                // visiting every template is far slower, a smaller sample keeps the run short
+                benchmark("scan", std::max<size_t>(settings.queries / names.size(), 64), [&](size_t i) {
+                    size_t matches = 0;
+
+                    for (const auto& name : names)
+                    {
+                        if (const FuelLayer* tmpl = contentDb->getGameObjectTmpl(name); tmpl && tmpl->hasAttr(lookups[i].first) && tmpl->valueOf(lookups[i].first) == lookups[i].second)
+                        {
+                            ++matches;
+                        }
+                    }
+
+                    return matches;
+                });
+
+                json.endObject();
+            }
+
+            // a lazy ContentDb only pays for the templates a session ends up using, here one in twenty of them
+            {
+                std::vector<double> lazyInit, touch;
+                uint64_t lazyResident = 0;
+                ContentDb::Counters counters;
+
+                for (uint32_t i = 0; i < settings.iterations; ++i)
+                {
+                    auto lazy = std::make_unique<ContentDb>();
+
+                    const uint64_t live = liveBytes.load(std::memory_order_relaxed);
+                    auto start = Clock::now();
+
+                    lazy->initLazy(fileSys);
+
+                    lazyInit.push_back(millisecondsSince(start));
+
+                    start = Clock::now();
+
+                    for (size_t index = 0; index < names.size(); index += 20)
+                    {
+                        lazy->getGameObjectTmpl(names[index]);
+                    }
+
+                    touch.push_back(millisecondsSince(start));
+
+                    lazyResident = liveBytes.load(std::memory_order_relaxed) - live;
+                    counters = lazy->counters();
+                }
+
+                json.beginObject("lazy");
+                json.value("init_ms", percentiles(lazyInit).p50);
+                json.value("touch_ms", percentiles(touch).p50);
+                json.value("templates", static_cast<uint64_t>(counters.templates));
+                json.value("materialized", static_cast<uint64_t>(counters.materialized));
+                json.value("documents", static_cast<uint64_t>(counters.documents));
+                json.value("parsed", static_cast<uint64_t>(counters.parsed));
+                json.value("resident_bytes", lazyResident);
+                json.endObject();
+            }
+
+            // with a gas cache the first init writes a snapshot of the resolved templates and the ones after load it
+            {
+                const std::filesystem::path cache = std::filesystem::temp_directory_path() / ("siege-bench-fuel-cache-" + std::to_string(std::random_device()()));
+
+                fileSys.setGasCache(std::make_shared<FuelCache>(cache.string()));
+
+                ContentDb().init(fileSys);
+
+                std::vector<double> warm;
+                size_t restored = 0;
+
+                for (uint32_t i = 0; i < settings.iterations; ++i)
+                {
+                    ContentDb snapshot;
+
+                    const auto start = Clock::now();
+
+                    snapshot.init(fileSys);
+
+                    warm.push_back(millisecondsSince(start));
+
+                    restored = 0;
+
+                    for (const auto& name : names)
+                    {
+                        restored += snapshot.getGameObjectTmpl(name) != nullptr;
+                    }
+                }
+
+                json.beginObject("snapshot");
+                json.value("resolved", static_cast<uint64_t>(restored));
+                json.value("init_ms", percentiles(warm).p50);
+                json.endObject();
+
+                fileSys.setGasCache(nullptr);
+
+                std::error_code ec;
+                std::filesystem::remove_all(cache, ec);
+            }
+
+            json.endObject();
+        }
+    } // namespace bench
+} // namespace ehb
+
+int main(int argc, char* argv[])
+{
+    using namespace ehb;
+    using namespace ehb::bench;
+
+    // keep stdout clean for the json report
+    spdlog::stderr_color_mt("log")->set_level(spdlog::level::warn);
+    spdlog::stderr_color_mt("filesystem")->set_level(spdlog::level::warn);
+
+    Settings settings;
+    SyntheticGasSettings synthetic;
+    std::string corpusPath, generatePath, output, typeMix;
+
+    vsg::CommandLine args(&argc, argv);
+    args.read("--corpus", corpusPath);
+    args.read("--generate", generatePath);
+    args.read("--iterations", settings.iterations);
+    args.read("--queries", settings.queries);
+    args.read("--output", output);
+    args.read("--seed", synthetic.seed);
+    args.read("--files", synthetic.files);
+    args.read("--blocks", synthetic.blocks);
+    args.read("--depth", synthetic.depth);
+    args.read("--fan-out", synthetic.fanOut);
+    args.read("--attributes", synthetic.attributes);
+    args.read("--templates", synthetic.templates);
+    args.read("--template-files", synthetic.templateFiles);
+    args.read("--chain", synthetic.chainLength);
+    args.read("--type-mix", typeMix);
+
+    settings.iterations = std::max(1u, settings.iterations);
+
+    if (!typeMix.empty())
+    {
+        numeric::TupleReader reader(typeMix);
+
+        for (auto& weight : synthetic.typeMix)
+        {
+            reader.read(weight);
+        }
+
+        if (const auto error = reader.finish(); error != numeric::ParseError::None)
+        {
+            spdlog::get("log")->error("--type-mix needs {} comma separated weights: {}", synthetic.typeMix.size(), numeric::describe(error));
+
+            return 1;
+        }
+    }
+
+    // the synthetic corpus goes through the filesystem too so ContentDb can be pointed at it
+    std::filesystem::path root = corpusPath;
+    std::filesystem::path temporary;
+
+    if (corpusPath.empty())
+    {
+        if (!generatePath.empty()) { root = generatePath; }
+        else
+        {
+            root = temporary = std::filesystem::temp_directory_path() / ("siege-bench-fuel-" + std::to_string(std::random_device()()));
+        }
+
+        SyntheticGas(synthetic).write(root);
+    }
+
+    const Corpus corpus = loadCorpus(root);
+
+    std::ostringstream report;
+    JsonWriter json(report);
+
+    char timestamp[64] = {'\0'};
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    json.beginObject();
+    json.value("benchmark", "fuel");
+    json.value("schema", 1u);
+    json.value("timestamp", timestamp);
+    json.value("hardware_threads", std::thread::hardware_concurrency());
+    json.value("iterations", settings.iterations);
+
+    json.beginObject("corpus");
+    json.value("source", corpusPath.empty() ? "synthetic" : corpusPath);
+    json.value("files", static_cast<uint64_t>(corpus.files.size()));
+    json.value("bytes", corpus.bytes);
+
+    if (corpusPath.empty())
+    {
+        json.value("seed", synthetic.seed);
+        json.value("documents", synthetic.files);
+        json.value("blocks", synthetic.blocks);
+        json.value("depth", synthetic.depth);
+        json.value("fan_out", synthetic.fanOut);
+        json.value("attributes", synthetic.attributes);
+        json.value("templates", synthetic.templates);
+        json.value("chain_length", synthetic.chainLength);
+    }
+
+    json.endObject();
+
+    json.beginArray("parse");
+
+    benchmarkParse(json, "bison", corpus, settings, [](std::string&& data) { return Fuel().parse(std::move(data), Fuel::Parser::Bison); });
+    benchmarkParse(json, "descent", corpus, settings, [](std::string&& data) { return Fuel().parse(std::move(data), Fuel::Parser::Descent); });
+    benchmarkParse(json, "lazy", corpus, settings, [](std::string&& data) { return Fuel().parseLazy(std::move(data)); });
+    benchmarkParse(json, "reader", corpus, settings, [](std::string&& data) {
+        std::istringstream stream(std::move(data));
+
+        return FuelReader().read(stream);
+    });
+
+    json.endArray();
+
+    {
+        std::vector<std::unique_ptr<Fuel>> docs;
+        QuerySet queries;
+
+        for (const auto& [path, data] : corpus.files)
+        {
+            auto doc = std::make_unique<Fuel>();
+            doc->parse(data);
+
+            collectQueries(doc.get(), queries);
+
+            docs.push_back(std::move(doc));
+        }
+
+        benchmarkQueries(json, "queries", queries, settings);
+
+        // the same queries once the typed values have been decoded, the way ContentDb keeps its templates
+        for (auto& doc : docs)
+        {
+            doc->decodeValues();
+        }
+
+        benchmarkQueries(json, "queries_decoded", queries, settings);
+    }
+
+    if (std::filesystem::exists(root / "world" / "contentdb" / "templates")) { benchmarkContentDb(json, root, settings); }
+
+    json.endObject();
+
+    report << '\n';
+
+    if (!temporary.empty()) { std::filesystem::remove_all(temporary); }
+
+    if (!output.empty()) { std::ofstream(output) << report.str(); }
+    else
+    {
+        std::cout << report.str();
+    }
+
+    return 0;
+}
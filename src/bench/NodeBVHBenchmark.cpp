@@ -0,0 +1,445 @@
+// standalone benchmark for NodeBVH, the world space tree over placed siege nodes
+//
+// usage: siege-bench-bvh [--regions <n>] [--nodes-per-region <n>] [--queries <n>] [--churn <n>] [--seed <n>] [--output <file.json>]
+//
+// a synthetic world is generated from regions laid out on a grid, each a patch of node sized boxes turned in steps
+// of 90 degrees the way siege nodes are. the tree is built by inserting every node one at a time, regions are taken
+// out and put back the way the streamer does it, and then point, box, ray and frustum queries are timed against the
+// tree and against a linear scan over the same boxes. every result of the tree is checked against the scan and the
+// exit code is non zero if any of them differ. all results are written as a single JSON document so they can be
+// diffed between releases
+
+#include "bench/Benchmark.hpp"
+#include "world/NodeBVH.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <vsg/maths/transform.h>
+#include <vsg/utils/CommandLine.h>
+
+namespace ehb
+{
+    namespace bench
+    {
+        struct Settings
+        {
+            uint32_t regions = 256;
+            uint32_t nodesPerRegion = 400;
+            uint32_t queries = 10000;
+            uint32_t churn = 200; //! regions taken out and put back
+            uint32_t seed = 0x5eed;
+        };
+
+        struct SyntheticNode
+        {
+            uint32_t guid;
+            vsg::dbox bounds;
+            vsg::dvec3 center;
+        };
+
+        //! key: region, value: its nodes
+        using SyntheticWorld = std::vector<std::vector<SyntheticNode>>;
+
+        inline SyntheticWorld generateWorld(const Settings& settings)
+        {
+            // most terrain nodes are 4 or 8 meters across, some pieces are smaller
+            constexpr double Cell = 8.0;
+            constexpr double Sizes[] = {2.0, 4.0, 4.0, 8.0, 8.0, 8.0};
+
+            std::mt19937 rng(settings.seed);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+            const uint32_t nodeSide = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(settings.nodesPerRegion))));
+            const uint32_t regionSide = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(settings.regions))));
+
+            const double regionSize = nodeSide * Cell;
+
+            SyntheticWorld world(settings.regions);
+
+            uint32_t index = 0;
+
+            for (uint32_t region = 0; region < settings.regions; ++region)
+            {
+                // regions step up and down like the hills between them
+                const vsg::dvec3 origin((region % regionSide) * regionSize, (unit(rng) - 0.5) * 40.0, (region / regionSide) * regionSize);
+
+                auto& nodes = world[region];
+                nodes.reserve(settings.nodesPerRegion);
+
+                for (uint32_t node = 0; node < settings.nodesPerRegion; ++node, ++index)
+                {
+                    const double size = Sizes[rng() % std::size(Sizes)];
+                    const double height = 0.5 + unit(rng) * 4.0;
+
+                    const vsg::box local(vsg::vec3(static_cast<float>(-size / 2), static_cast<float>(-height), static_cast<float>(-size / 2)),
+                                         vsg::vec3(static_cast<float>(size / 2), static_cast<float>(height), static_cast<float>(size / 2)));
+
+                    const vsg::dvec3 position(origin.x + (node % nodeSide) * Cell, origin.y + (unit(rng) - 0.5) * 6.0, origin.z + (node / nodeSide) * Cell);
+
+                    const vsg::dmat4 matrix = vsg::translate(position) * vsg::rotate(vsg::radians(90.0 * (rng() % 4)), 0.0, 1.0, 0.0);
+
+                    // guids are all over the place in the real data, a multiply by an odd number keeps them unique
+                    nodes.push_back({(index + 1) * 2654435761u, NodeBVH::transform(matrix, local), position});
+                }
+            }
+
+            return world;
+        }
+
+        //! the reference every query of the tree is checked against
+        class LinearScan
+        {
+        public:
+            explicit LinearScan(const SyntheticWorld& world)
+            {
+                for (const auto& region : world)
+                {
+                    nodes.insert(nodes.end(), region.begin(), region.end());
+                }
+            }
+
+            void intersect(const vsg::dvec3& point, std::vector<uint32_t>& result) const
+            {
+                for (const auto& node : nodes)
+                {
+                    const auto& b = node.bounds;
+
+                    if (point.x >= b.min.x && point.x <= b.max.x && point.y >= b.min.y && point.y <= b.max.y && point.z >= b.min.z && point.z <= b.max.z) { result.push_back(node.guid); }
+                }
+            }
+
+            void intersect(const vsg::dbox& box, std::vector<uint32_t>& result) const
+            {
+                for (const auto& node : nodes)
+                {
+                    const auto& b = node.bounds;
+
+                    if (box.min.x <= b.max.x && box.max.x >= b.min.x && box.min.y <= b.max.y && box.max.y >= b.min.y && box.min.z <= b.max.z && box.max.z >= b.min.z) { result.push_back(node.guid); }
+                }
+            }
+
+            void intersect(const NodeBVH::Frustum& frustum, std::vector<uint32_t>& result) const
+            {
+                for (const auto& node : nodes)
+                {
+                    const auto& b = node.bounds;
+
+                    bool inside = true;
+
+                    for (const auto& p : frustum)
+                    {
+                        if (p.x * (p.x >= 0.0 ? b.max.x : b.min.x) + p.y * (p.y >= 0.0 ? b.max.y : b.min.y) + p.z * (p.z >= 0.0 ? b.max.z : b.min.z) + p.w < 0.0)
+                        {
+                            inside = false;
+                            break;
+                        }
+                    }
+
+                    if (inside) { result.push_back(node.guid); }
+                }
+            }
+
+            void intersect(const NodeBVH::Ray& ray, std::vector<uint32_t>& result) const
+            {
+                for (const auto& node : nodes)
+                {
+                    double entry = 0.0, exit = ray.length;
+
+                    for (int axis = 0; axis < 3 && entry <= exit; ++axis)
+                    {
+                        double t0 = (node.bounds.min[axis] - ray.origin[axis]) / ray.direction[axis];
+                        double t1 = (node.bounds.max[axis] - ray.origin[axis]) / ray.direction[axis];
+
+                        if (t0 > t1) { std::swap(t0, t1); }
+
+                        entry = std::max(entry, t0);
+                        exit = std::min(exit, t1);
+                    }
+
+                    if (entry <= exit) { result.push_back(node.guid); }
+                }
+            }
+
+        private:
+            std::vector<SyntheticNode> nodes;
+        };
+
+        //! @return the median
+        inline double writeLatencies(JsonWriter& json, const char* prefix, const std::vector<double>& samples)
+        {
+            const Percentiles p = percentiles(samples);
+
+            const std::string name(prefix);
+
+            json.value((name + "p50_ns").c_str(), p.p50);
+            json.value((name + "p90_ns").c_str(), p.p90);
+            json.value((name + "p99_ns").c_str(), p.p99);
+            json.value((name + "max_ns").c_str(), p.max);
+
+            return p.p50;
+        }
+
+        inline double nanosecondsSince(Clock::time_point start)
+        {
+            return millisecondsSince(start) * 1e6;
+        }
+
+        //! @return the number of queries whose result differed from the scan
+        template<typename Query>
+        uint64_t benchmarkQuery(JsonWriter& json, const char* name, const std::vector<Query>& queries, const NodeBVH& tree, const LinearScan& scan, std::function<void(const Query&, std::vector<uint32_t>&)> query)
+        {
+            std::vector<double> treeSamples, scanSamples;
+            treeSamples.reserve(queries.size());
+            scanSamples.reserve(queries.size());
+
+            // the tree is timed on its own first, running the scan in between would push it out of the cache every time
+            std::vector<std::vector<uint32_t>> results(queries.size());
+            std::vector<uint32_t> actual, expected;
+
+            uint64_t hits = 0, mismatches = 0;
+
+            for (size_t index = 0; index < queries.size(); ++index)
+            {
+                actual.clear();
+
+                const auto start = Clock::now();
+                query(queries[index], actual);
+                treeSamples.push_back(nanosecondsSince(start));
+
+                hits += actual.size();
+
+                results[index] = actual;
+            }
+
+            for (size_t index = 0; index < queries.size(); ++index)
+            {
+                expected.clear();
+
+                const auto start = Clock::now();
+                scan.intersect(queries[index], expected);
+                scanSamples.push_back(nanosecondsSince(start));
+
+                std::sort(results[index].begin(), results[index].end());
+                std::sort(expected.begin(), expected.end());
+
+                if (results[index] != expected) { ++mismatches; }
+            }
+
+            json.beginObject();
+            json.value("name", name);
+            json.value("queries", static_cast<uint64_t>(queries.size()));
+            json.value("hits", hits);
+            const double treeMedian = writeLatencies(json, "", treeSamples);
+            const double scanMedian = writeLatencies(json, "scan_", scanSamples);
+            json.value("speedup", treeMedian > 0.0 ? scanMedian / treeMedian : 0.0);
+            json.value("mismatches", mismatches);
+            json.endObject();
+
+            return mismatches;
+        }
+    } // namespace bench
+} // namespace ehb
+
+int main(int argc, char* argv[])
+{
+    using namespace ehb;
+    using namespace ehb::bench;
+
+    // keep stdout clean for the json report
+    spdlog::stderr_color_mt("log")->set_level(spdlog::level::warn);
+
+    Settings settings;
+    std::string output;
+
+    vsg::CommandLine args(&argc, argv);
+    args.read("--regions", settings.regions);
+    args.read("--nodes-per-region", settings.nodesPerRegion);
+    args.read("--queries", settings.queries);
+    args.read("--churn", settings.churn);
+    args.read("--seed", settings.seed);
+    args.read("--output", output);
+
+    settings.regions = std::max(1u, settings.regions);
+    settings.nodesPerRegion = std::max(1u, settings.nodesPerRegion);
+
+    std::ostringstream report;
+    JsonWriter json(report);
+
+    char timestamp[64] = {'\0'};
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    json.beginObject();
+    json.value("benchmark", "bvh");
+    json.value("schema", 1u);
+    json.value("timestamp", timestamp);
+    json.value("hardware_threads", std::thread::hardware_concurrency());
+    json.value("regions", settings.regions);
+    json.value("nodes_per_region", settings.nodesPerRegion);
+    json.value("seed", settings.seed);
+
+    const SyntheticWorld world = generateWorld(settings);
+    const LinearScan scan(world);
+
+    NodeBVH tree;
+
+    // every node is inserted on its own, the same as regions coming in one after the other
+    {
+        const auto start = Clock::now();
+
+        for (const auto& region : world)
+        {
+            for (const auto& node : region)
+            {
+                tree.insert(node.guid, node.bounds);
+            }
+        }
+
+        const double ms = millisecondsSince(start);
+
+        json.beginObject("build");
+        json.value("nodes", static_cast<uint64_t>(tree.size()));
+        json.value("ms", ms);
+        json.value("ns_per_node", tree.size() != 0 ? ms * 1e6 / tree.size() : 0.0);
+        json.value("height", tree.height());
+        json.endObject();
+    }
+
+    std::mt19937 rng(settings.seed ^ 0xb7e15163);
+
+    // regions leave and come back in a random order, which is the worst case for the shape of the tree
+    {
+        std::vector<double> removeSamples, insertSamples;
+
+        for (uint32_t i = 0; i < settings.churn; ++i)
+        {
+            const auto& region = world[rng() % world.size()];
+
+            auto start = Clock::now();
+
+            for (const auto& node : region)
+            {
+                tree.remove(node.guid);
+            }
+
+            removeSamples.push_back(nanosecondsSince(start));
+
+            start = Clock::now();
+
+            for (const auto& node : region)
+            {
+                tree.insert(node.guid, node.bounds);
+            }
+
+            insertSamples.push_back(nanosecondsSince(start));
+        }
+
+        json.beginObject("stream");
+        json.value("regions", settings.churn);
+        writeLatencies(json, "remove_region_", removeSamples);
+        writeLatencies(json, "insert_region_", insertSamples);
+        json.value("height", tree.height());
+        json.value("nodes", static_cast<uint64_t>(tree.size()));
+        json.endObject();
+    }
+
+    // queries are aimed at the world so most of them find something, like picking and placement do
+    std::vector<const SyntheticNode*> targets;
+
+    for (const auto& region : world)
+    {
+        for (const auto& node : region)
+        {
+            targets.push_back(&node);
+        }
+    }
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    auto jitter = [&](double range) { return vsg::dvec3((unit(rng) - 0.5) * range, (unit(rng) - 0.5) * range, (unit(rng) - 0.5) * range); };
+
+    std::vector<vsg::dvec3> points(settings.queries);
+    std::vector<vsg::dbox> boxes(settings.queries);
+    std::vector<NodeBVH::Ray> rays(settings.queries);
+    std::vector<NodeBVH::Frustum> frustums(std::max(1u, settings.queries / 10));
+
+    for (auto& point : points)
+    {
+        point = targets[rng() % targets.size()]->center + jitter(8.0);
+    }
+
+    for (auto& box : boxes)
+    {
+        const vsg::dvec3 center = targets[rng() % targets.size()]->center;
+        const double half = 5.0 + unit(rng) * 25.0;
+
+        box = vsg::dbox(center - vsg::dvec3(half, half, half), center + vsg::dvec3(half, half, half));
+    }
+
+    for (auto& ray : rays)
+    {
+        // from a camera above the ground down at a node
+        const vsg::dvec3 target = targets[rng() % targets.size()]->center;
+        const vsg::dvec3 origin = target + vsg::dvec3((unit(rng) - 0.5) * 60.0, 20.0 + unit(rng) * 30.0, (unit(rng) - 0.5) * 60.0);
+
+        ray = {origin, target - origin};
+    }
+
+    for (auto& frustum : frustums)
+    {
+        const vsg::dvec3 target = targets[rng() % targets.size()]->center;
+        const vsg::dvec3 eye = target + vsg::dvec3((unit(rng) - 0.5) * 80.0, 15.0 + unit(rng) * 25.0, (unit(rng) - 0.5) * 80.0);
+
+        frustum = NodeBVH::frustum(vsg::perspective(vsg::radians(60.0), 16.0 / 9.0, 1.0, 200.0), vsg::lookAt(eye, target, vsg::dvec3(0.0, 1.0, 0.0)));
+    }
+
+    uint64_t mismatches = 0;
+
+    json.beginArray("queries");
+
+    mismatches += benchmarkQuery<vsg::dvec3>(json, "point", points, tree, scan, [&tree](const vsg::dvec3& point, std::vector<uint32_t>& result) { tree.intersect(point, result); });
+    mismatches += benchmarkQuery<vsg::dbox>(json, "box", boxes, tree, scan, [&tree](const vsg::dbox& box, std::vector<uint32_t>& result) { tree.intersect(box, result); });
+
+    mismatches += benchmarkQuery<NodeBVH::Ray>(json, "ray", rays, tree, scan, [&tree](const NodeBVH::Ray& ray, std::vector<uint32_t>& result) {
+        static thread_local std::vector<NodeBVH::Hit> hits;
+
+        hits.clear();
+        tree.intersect(ray, hits);
+
+        for (const auto& hit : hits)
+        {
+            result.push_back(hit.node);
+        }
+    });
+
+    mismatches += benchmarkQuery<NodeBVH::Frustum>(json, "frustum", frustums, tree, scan, [&tree](const NodeBVH::Frustum& frustum, std::vector<uint32_t>& result) { tree.intersect(frustum, result); });
+
+    json.endArray();
+
+    json.value("mismatches", mismatches);
+    json.endObject();
+
+    report << '\n';
+
+    if (!output.empty()) { std::ofstream(output) << report.str(); }
+    else
+    {
+        std::cout << report.str();
+    }
+
+    if (mismatches != 0) { spdlog::get("log")->error("{} queries of the tree didn't match the linear scan", mismatches); }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ehb
+{
+    namespace bench
+    {
+        struct SyntheticGasSettings
+        {
+            enum ValueKind
+            {
+                Word,   //! untyped identifiers like model names
+                String, //! quoted text
+                Int,
+                Hex,
+                Float,
+                Bool,
+                Vector, //! untyped "x,y,z" tuples
+                ValueKindCount
+            };
+
+            uint32_t seed = 0x5133;
+
+            // plain documents
+            uint32_t files = 64;
+            uint32_t blocks = 8;      //! root blocks per document
+            uint32_t depth = 3;       //! levels of nested blocks below each root block
+            uint32_t fanOut = 3;      //! child blocks per block, on average
+            uint32_t attributes = 8;  //! attributes per block, on average
+
+            // templates for ContentDb
+            uint32_t templates = 2000;
+            uint32_t templateFiles = 40;
+            uint32_t chainLength = 6; //! longest specializes chain
+
+            //! relative weights of the kinds of values, roughly what the retail templates hold
+            std::array<uint32_t, ValueKindCount> typeMix = {30, 10, 15, 10, 15, 10, 10};
+        };
+
+        /**
+         * generates gas documents that look like the retail content without containing any of it: nested
+         * blocks with a mix of typed and untyped values and comments, plus templates whose specializes chains
+         * ContentDb has to resolve. the same settings always produce the same corpus
+         */
+        class SyntheticGas
+        {
+        public:
+            explicit SyntheticGas(const SyntheticGasSettings& settings);
+
+            //! writes every document under the root, the templates end up in world/contentdb/templates
+            void write(const std::filesystem::path& root) const;
+
+            //! paths relative to the root of the corpus and their content
+            std::vector<std::pair<std::string, std::string>> documents;
+
+        private:
+            void block(std::string& out, uint32_t level, const std::string& indent);
+            void attribute(std::string& out, const std::string& indent, const char* name);
+            std::string templateBody(uint32_t index, int32_t parent);
+
+            uint32_t vary(uint32_t average) { return average == 0 ? 0 : average / 2 + rng() % (average + 1); }
+
+            SyntheticGasSettings settings;
+            std::mt19937 rng;
+            std::discrete_distribution<int> kinds;
+        };
+
+        namespace synthetic
+        {
+            // vocabularies borrowed from the shape of the retail templates
+            inline const char* const blockTypes[] = {"template", "snode", "door", "aspect", "mood_setting", "light", "effect", "interface"};
+            inline const char* const components[] = {"aspect", "body", "common", "physics", "inventory", "attack", "defend", "actor", "gui", "mind"};
+            inline const char* const attributeNames[] = {"model", "scale", "life", "max_life", "mana", "texture", "screen_name", "damage_min", "damage_max", "guid", "mesh_guid", "is_visible", "position", "orientation", "experience_value", "gold_value", "category_name", "range", "speed", "flags"};
+        } // namespace synthetic
+
+        inline SyntheticGas::SyntheticGas(const SyntheticGasSettings& settings) :
+            settings(settings), rng(settings.seed), kinds(settings.typeMix.begin(), settings.typeMix.end())
+        {
+            char path[128];
+
+            for (uint32_t file = 0; file < settings.files; ++file)
+            {
+                std::string out = "// synthetic gas for benchmarking\n\n";
+
+                for (uint32_t index = 0; index < settings.blocks; ++index)
+                {
+                    block(out, 0, "");
+                }
+
+                std::snprintf(path, sizeof(path), "bench/gas/doc_%04u.gas", file);
+                documents.emplace_back(path, std::move(out));
+            }
+
+            if (settings.templates == 0 || settings.templateFiles == 0) { return; }
+
+            // templates are spread over the files at random so a parent is as likely to come after its children as before
+            std::vector<std::string> files(settings.templateFiles);
+            const uint32_t chainLength = std::max(1u, settings.chainLength);
+
+            for (uint32_t index = 0; index < settings.templates; ++index)
+            {
+                const uint32_t position = index % chainLength;
+                const int32_t parent = position == 0 ? -1 : static_cast<int32_t>(index - position + rng() % position);
+
+                files[rng() % files.size()] += templateBody(index, parent);
+            }
+
+            for (uint32_t file = 0; file < files.size(); ++file)
+            {
+                std::snprintf(path, sizeof(path), "world/contentdb/templates/bench/tmpl_%04u.gas", file);
+                documents.emplace_back(path, std::move(files[file]));
+            }
+        }
+
+        inline void SyntheticGas::write(const std::filesystem::path& root) const
+        {
+            for (const auto& [path, data] : documents)
+            {
+                const std::filesystem::path filename = root / path;
+
+                std::filesystem::create_directories(filename.parent_path());
+                std::ofstream(filename, std::ios_base::binary) << data;
+            }
+        }
+
+        inline void SyntheticGas::block(std::string& out, uint32_t level, const std::string& indent)
+        {
+            char line[128];
+
+            const char* type = synthetic::blockTypes[rng() % std::size(synthetic::blockTypes)];
+
+            // most blocks at the top are typed, the ones inside are usually just named
+            if (level == 0 || rng() % 4 == 0) { std::snprintf(line, sizeof(line), "%s[t:%s,n:%s_%08x]\n%s{\n", indent.c_str(), type, type, static_cast<uint32_t>(rng()), indent.c_str()); }
+            else
+            {
+                std::snprintf(line, sizeof(line), "%s[%s_%u]\n%s{\n", indent.c_str(), synthetic::components[rng() % std::size(synthetic::components)], level, indent.c_str());
+            }
+
+            out += line;
+
+            const std::string inner = indent + '\t';
+            const uint32_t attributes = vary(settings.attributes);
+
+            for (uint32_t index = 0; index < attributes; ++index)
+            {
+                std::snprintf(line, sizeof(line), "%s_%u", synthetic::attributeNames[rng() % std::size(synthetic::attributeNames)], index);
+                attribute(out, inner, line);
+            }
+
+            if (level < settings.depth)
+            {
+                const uint32_t children = vary(settings.fanOut);
+
+                for (uint32_t index = 0; index < children; ++index)
+                {
+                    block(out, level + 1, inner);
+                }
+            }
+
+            out += indent + "}\n";
+        }
+
+        inline void SyntheticGas::attribute(std::string& out, const std::string& indent, const char* name)
+        {
+            char line[256];
+
+            switch (kinds(rng))
+            {
+            case SyntheticGasSettings::Word: std::snprintf(line, sizeof(line), "%s = m_c_gah_%04x;", name, static_cast<uint32_t>(rng() % 0x10000)); break;
+            case SyntheticGasSettings::String: std::snprintf(line, sizeof(line), "%s = \"synthetic text %u with a few words\";", name, static_cast<uint32_t>(rng() % 1000)); break;
+            case SyntheticGasSettings::Int: std::snprintf(line, sizeof(line), "i %s = %d;", name, static_cast<int32_t>(rng() % 20000) - 10000); break;
+            case SyntheticGasSettings::Hex: std::snprintf(line, sizeof(line), "x %s = 0x%08x;", name, static_cast<uint32_t>(rng())); break;
+            case SyntheticGasSettings::Float: std::snprintf(line, sizeof(line), "f %s = %u.%03u;", name, static_cast<uint32_t>(rng() % 1000), static_cast<uint32_t>(rng() % 1000)); break;
+            case SyntheticGasSettings::Bool: std::snprintf(line, sizeof(line), "b %s = %s;", name, rng() % 2 ? "true" : "false"); break;
+            default: std::snprintf(line, sizeof(line), "%s = %u.%02u,%u.%02u,%u.%02u;", name, static_cast<uint32_t>(rng() % 100), static_cast<uint32_t>(rng() % 100), static_cast<uint32_t>(rng() % 100), static_cast<uint32_t>(rng() % 100), static_cast<uint32_t>(rng() % 100), static_cast<uint32_t>(rng() % 100)); break;
+            }
+
+            out += indent;
+            out += line;
+
+            // a trailing comment every now and then, the lexer has to skip those too
+            if (rng() % 16 == 0) { out += " // tweaked for balance"; }
+
+            out += '\n';
+        }
+
+        inline std::string SyntheticGas::templateBody(uint32_t index, int32_t parent)
+        {
+            char line[128];
+            std::string out;
+
+            std::snprintf(line, sizeof(line), "[t:template,n:tmpl_%05u]\n{\n", index);
+            out += line;
+
+            std::snprintf(line, sizeof(line), "\tdoc = \"synthetic template %u\";\n", index);
+            out += line;
+
+            if (parent >= 0)
+            {
+                std::snprintf(line, sizeof(line), "\tspecializes = tmpl_%05d;\n", parent);
+                out += line;
+            }
+
+            // templates down a chain mostly override the same components with a few values each, which is what makes merging them expensive
+            const size_t first = rng() % std::size(synthetic::components);
+            const uint32_t count = 1 + rng() % 4;
+
+            for (uint32_t component = 0; component < count; ++component)
+            {
+                out += "\t[";
+                out += synthetic::components[(first + component) % std::size(synthetic::components)];
+                out += "]\n\t{\n";
+
+                const size_t name = rng() % std::size(synthetic::attributeNames);
+                const uint32_t attributes = std::min<uint32_t>(vary(settings.attributes), std::size(synthetic::attributeNames));
+
+                for (uint32_t attr = 0; attr < attributes; ++attr)
+                {
+                    attribute(out, "\t\t", synthetic::attributeNames[(name + attr) % std::size(synthetic::attributeNames)]);
+                }
+
+                out += "\t}\n";
+            }
+
+            out += "}\n";
+
+            return out;
+        }
+    } // namespace bench
+} // namespace ehb
@@ -22,15 +22,21 @@ namespace ehb
             if (args.read("--profile", value)) config.setBool("profile", value);
             if (args.read("--debuglayer", value)) config.setBool("debuglayer", value);
             if (args.read("--apidumplayer", value)) config.setBool("apidumplayer", value);
+            if (args.read("--world-placement", value)) config.setBool("world-placement", value);
         }
         {
             // parse all float values from the command line
+            float value;
+
+            if (args.read("--stream-radius", value)) config.setFloat("stream-radius", value);
         } { // parse all integer values from the command line
             int value;
 
             if (args.read("--bpp", value)) config.setInt("bpp", value);
             if (args.read("--height", value)) config.setInt("height", value);
             if (args.read("--maxfps", value)) config.setInt("maxfps", value);
+            if (args.read("--stream-budget-mb", value)) config.setInt("stream-budget-mb", value);
+            if (args.read("--stream-hops", value)) config.setInt("stream-hops", value);
             if (args.read("--width", value)) config.setInt("width", value);
         }
         { // parse all string values from the command line
@@ -38,6 +44,7 @@ namespace ehb
 
             if (args.read("--bits", value)) config.setString("bits", value);
             if (args.read("--ds-install-path", value)) config.setString("ds-install-path", value);
+            if (args.read("--gas-cache", value)) config.setString("gas-cache", value);
             if (args.read("--map_paths", value)) config.setString("map_paths", value);
             if (args.read("--mod_paths", value)) config.setString("mod_paths", value);
             if (args.read("--res_paths", value)) config.setString("res_paths", value);
@@ -21,32 +21,17 @@
 
 #include "Fuel.hpp"
 
+#include "FuelDescentParser.hpp"
+#include "FuelNumeric.hpp"
 #include "FuelParser.hpp"
 #include "FuelScanner.hpp"
 #include <cctype>
+#include <climits>
 #include <fstream>
-#include <sstream>
 
 namespace ehb
 {
-    static std::vector<std::string> split(const std::string& value, char delim)
-    {
-        std::vector<std::string> result;
-
-        std::istringstream stream(value);
-
-        while (!stream.eof())
-        {
-            std::string item;
-            std::getline(stream, item, delim);
-
-            result.push_back(item);
-        }
-
-        return result;
-    }
-
-    static bool stringEqual(const std::string& str1, const std::string& str2)
+    static bool stringEqual(std::string_view str1, std::string_view str2)
     {
         return (
             (str1.size() == str2.size()) &&
@@ -59,31 +44,67 @@ namespace ehb
                 }));
     }
 
-    FuelBlock::~FuelBlock()
+    FuelValue FuelValue::decode(std::string_view type, std::string_view value)
     {
-        for (FuelBlock* node : mChildren)
+        FuelValue result;
+
+        if (type.size() != 1) { return result; }
+
+        switch (type[0])
         {
-            delete node;
+        case 'i':
+        case 'x':
+            if (int64_t i = 0; numeric::parse(value, i, type[0] == 'x' ? 16 : 10) == numeric::ParseError::None)
+            {
+                result.kind = Kind::Int;
+                result.i = i;
+            }
+            break;
+
+        case 'f':
+            if (float f = 0; numeric::parse(value, f) == numeric::ParseError::None)
+            {
+                result.kind = Kind::Float;
+                result.f = f;
+            }
+            break;
+
+        case 'b':
+            result.kind = Kind::Bool;
+            result.b = stringEqual(value, "true");
+            break;
         }
+
+        return result;
     }
 
-    FuelBlock* FuelBlock::appendChild(const std::string& name)
+    FuelBlock* FuelBlock::createChild()
+    {
+        return new (mArena->allocate(sizeof(FuelBlock), alignof(FuelBlock))) FuelBlock(this);
+    }
+
+    FuelBlock* FuelBlock::appendChild(std::string_view name)
     {
         const auto index = name.find_last_of(':');
 
-        if (index != std::string::npos)
+        if (index != std::string_view::npos)
         {
-            const std::vector<std::string> path = split(name.substr(0, index), ':');
-
             FuelBlock* parent = this;
 
-            for (const std::string& item : path)
+            for (std::string_view path = name.substr(0, index);;)
             {
+                const auto colon = path.find(':');
+                const std::string_view item = path.substr(0, colon);
+
                 FuelBlock* node = parent->child(item);
 
                 if (!node) { node = parent->appendChild(item); }
 
                 parent = node;
+
+                if (colon == std::string_view::npos) { break; }
+
+                path.remove_prefix(colon + 1);
             }
 
             return parent->appendChild(name.substr(index + 1));
@@ -91,265 +112,208 @@ namespace ehb
         else
         {
             // simply add a new child to this node with the given name
-            FuelBlock* node = new FuelBlock(this);
+            FuelBlock* node = createChild();
 
-            node->mName = name;
+            node->mName = mArena->store(name);
 
-            mChildren.push_back(node);
+            addChild(node);
 
             return node;
         }
     }
 
-    FuelBlock* FuelBlock::appendChild(const std::string& name, const std::string& type)
+    FuelBlock* FuelBlock::appendChild(std::string_view name, std::string_view type)
     {
         FuelBlock* result = appendChild(name);
 
-        result->mType = type;
+        result->mType = mArena->store(type);
 
         return result;
     }
 
-    FuelBlock* FuelBlock::child(const std::string& name) const
+    FuelBlock* FuelBlock::child(std::string_view name) const
     {
-        // TODO: cleanup the code here
-
-        std::vector<std::string> path = split(name, ':');
+        const FuelBlock* node = this;
 
-        switch (path.size())
+        // walk the colon separated path one segment at a time
+        for (;;)
         {
-        case 1: {
-            for (FuelBlock* node : mChildren)
-            {
-                if (node->name() == name) { return node; }
-            }
-        }
-        break;
+            const auto colon = name.find(':');
 
-        default: {
-            const FuelBlock* cItr = this;
-            FuelBlock* finalAnswer = nullptr;
+            FuelBlock* result = node->findChild(name.substr(0, colon));
 
-            for (const std::string& item : path)
-            {
-                FuelBlock* result = nullptr;
+            if (!result || colon == std::string_view::npos) { return result; }
 
-                for (FuelBlock* node : cItr->mChildren)
-                {
-                    if (node->name() == item)
-                    {
-                        result = node;
-                        break;
-                    }
-                }
+            node = result;
+            name.remove_prefix(colon + 1);
+        }
+    }
 
-                // did we find the node we're looking for?
-                if (result)
-                {
-                    cItr = result;
-                    finalAnswer = result;
-                }
-                else
-                {
-                    return nullptr;
-                }
-            }
+    FuelBlock* FuelBlock::child(const FuelPath& path) const
+    {
+        const FuelBlock* node = this;
 
-            return finalAnswer;
-        }
-        break;
+        for (size_t i = 0; i < path.size() && node; ++i)
+        {
+            node = node->findChild(path.segment(i), path.hash(i));
         }
 
-        return nullptr;
+        return const_cast<FuelBlock*>(node);
+    }
+
+    const FuelBlock::ChildList& FuelBlock::eachChildOf(std::string_view name) const
+    {
+        static const ChildList emptyVector;
+
+        if (FuelBlock* node = this->child(name)) { return node->eachChild(); }
+
+        return emptyVector;
     }
 
-    const std::vector<FuelBlock*>& FuelBlock::eachChildOf(const std::string& name) const
+    const FuelBlock::ChildList& FuelBlock::eachChildOf(const FuelPath& path) const
     {
-        static std::vector<FuelBlock*> emptyVector;
+        static const ChildList emptyVector;
 
-        if (FuelBlock* node = this->child(name)) { return node->mChildren; }
+        if (FuelBlock* node = this->child(path)) { return node->eachChild(); }
 
         return emptyVector;
     }
 
-    const std::vector<Attribute>& FuelBlock::eachAttrOf(const std::string& name) const
+    const FuelBlock::AttributeList& FuelBlock::eachAttrOf(std::string_view name) const
     {
-        static std::vector<Attribute> empty;
+        static const AttributeList empty;
 
-        if (FuelBlock* node = this->child(name)) { return node->mAttributes; }
+        if (FuelBlock* node = this->child(name)) { return node->eachAttribute(); }
 
         return empty;
     }
 
-    void FuelBlock::appendValue(const std::string& name, const std::string& type, const std::string& value)
+    const FuelBlock::AttributeList& FuelBlock::eachAttrOf(const FuelPath& path) const
+    {
+        static const AttributeList empty;
+
+        if (FuelBlock* node = this->child(path)) { return node->eachAttribute(); }
+
+        return empty;
+    }
+
+    void FuelBlock::appendValue(std::string_view name, std::string_view type, std::string_view value)
     {
         const auto index = name.find_last_of(':');
 
-        if (index != std::string::npos)
+        if (index != std::string_view::npos)
         {
-            const std::vector<std::string> path = split(name.substr(0, index), ':');
-
             FuelBlock* parent = this;
 
-            for (const std::string& item : path)
+            for (std::string_view path = name.substr(0, index);;)
             {
+                const auto colon = path.find(':');
+                const std::string_view item = path.substr(0, colon);
+
                 FuelBlock* node = parent->child(item);
 
                 if (!node) { node = parent->appendChild(item); }
 
                 parent = node;
+
+                if (colon == std::string_view::npos) { break; }
+
+                path.remove_prefix(colon + 1);
             }
 
             return parent->appendValue(name.substr(index + 1), type, value);
         }
         else
         {
-            Attribute attr;
-
-            attr.name = name;
-            attr.type = type;
-            attr.value = value;
-
-            mAttributes.push_back(attr);
+            addAttribute({mArena->store(name), mArena->store(type), mArena->store(value)});
         }
     }
 
-    bool FuelBlock::valueAsBool(const std::string& name, bool defaultValue) const
+    bool FuelBlock::toBool(const Attribute* attr, bool defaultValue)
     {
-        if (const Attribute* attr = attribute(name)) { return stringEqual(attr->value, "true"); }
+        if (attr) { return attr->typed.kind == FuelValue::Kind::Bool ? attr->typed.b : stringEqual(attr->value, "true"); }
 
         return defaultValue;
     }
 
-    int FuelBlock::valueAsInt(const std::string& name, int defaultValue) const
+    int FuelBlock::toInt(const Attribute* attr, int defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
+        if (attr && attr->typed.kind == FuelValue::Kind::Int)
         {
-            const int base = attr->type == "x" ? 16 : 10;
-
-            try
-            {
-                return std::stoi(attr->value, nullptr, base);
-            }
-            catch (...)
-            {
-            }
+            // out of range values fail the same way when parsing the string
+            return attr->typed.i >= INT_MIN && attr->typed.i <= INT_MAX ? static_cast<int>(attr->typed.i) : defaultValue;
         }
 
+        if (int32_t value = 0; attr && numeric::parse(attr->value, value, attr->type == "x" ? 16 : 10) == numeric::ParseError::None) { return value; }
+
         return defaultValue;
     }
 
-    unsigned int FuelBlock::valueAsUInt(const std::string& name, unsigned int defaultValue) const
+    unsigned int FuelBlock::toUInt(const Attribute* attr, unsigned int defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
-        {
-            const int base = attr->type == "x" ? 16 : 10;
+        // negative values wrap the same way when parsing the string
+        if (attr && attr->typed.kind == FuelValue::Kind::Int) { return static_cast<unsigned int>(attr->typed.i); }
 
-            try
-            {
-                return std::stoul(attr->value, nullptr, base);
-            }
-            catch (...)
-            {
-            }
-        }
+        if (int64_t value = 0; attr && numeric::parse(attr->value, value, attr->type == "x" ? 16 : 10) == numeric::ParseError::None) { return static_cast<unsigned int>(value); }
 
         return defaultValue;
     }
 
-    float FuelBlock::valueAsFloat(const std::string& name, float defaultValue) const
+    float FuelBlock::toFloat(const Attribute* attr, float defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
-        {
-            try
-            {
-                return std::stof(attr->value, nullptr);
-            }
-            catch (...)
-            {
-            }
-        }
+        if (attr && attr->typed.kind == FuelValue::Kind::Float) { return attr->typed.f; }
+
+        if (float value = 0; attr && numeric::parse(attr->value, value) == numeric::ParseError::None) { return value; }
 
         return defaultValue;
     }
 
-    double FuelBlock::valueAsDouble(const std::string& name, double defaultValue) const
+    double FuelBlock::toDouble(const Attribute* attr, double defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
-        {
-            try
-            {
-                return std::stod(attr->value, nullptr);
-            }
-            catch (...)
-            {
-            }
-        }
+        if (double value = 0; attr && numeric::parse(attr->value, value) == numeric::ParseError::None) { return value; }
 
         return defaultValue;
     }
 
-    std::string FuelBlock::valueAsString(const std::string& name, const std::string& defaultValue) const
+    std::string FuelBlock::toString(const Attribute* attr, const std::string& defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
+        if (attr)
         {
-            if (attr->value.front() == '"' && attr->value.back() == '"') { return attr->value.substr(1, attr->value.size() - 2); }
+            if (attr->value.size() >= 2 && attr->value.front() == '"' && attr->value.back() == '"') { return std::string(attr->value.substr(1, attr->value.size() - 2)); }
         }
 
         return defaultValue;
     }
 
-    std::array<float, 3> FuelBlock::valueAsFloat3(const std::string& name, std::array<float, 3> defaultValue) const
+    uint32_t FuelBlock::toGuid(const Attribute* attr, uint32_t defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
-        {
-            const std::string& value = valueOf(name);
-
-            if (value.empty()) { return defaultValue; }
-
-            const auto itr1 = value.find(',');
-            const auto itr2 = value.find(',', itr1 + 1);
-            const auto itr3 = value.find(',', itr2 + 1);
+        // guids are 32 bits but some of them are written with the full 64 bits, keep the low half like strtoul did
+        if (attr && attr->typed.kind == FuelValue::Kind::Int) { return static_cast<uint32_t>(attr->typed.i); }
 
-            float x = std::stof(value.substr(0, itr1));
-            float y = std::stof(value.substr(itr1 + 1, itr2 - itr1 - 1));
-            float z = std::stof(value.substr(itr2 + 1, itr3 - itr2 - 1));
-
-            return std::array<float, 3>{x, y, z};
-        }
+        if (uint32_t guid = 0; attr && numeric::parseGuid(attr->value, guid) == numeric::ParseError::None) { return guid; }
 
         return defaultValue;
     }
 
-    std::array<float, 4> FuelBlock::valueAsFloat4(const std::string& name, std::array<float, 4> defaultValue) const
+    std::array<float, 3> FuelBlock::toFloat3(const Attribute* attr, std::array<float, 3> defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
-        {
-            const std::string& value = valueOf(name);
+        if (attr) { numeric::parseFloats(attr->value, defaultValue); }
 
-            if (value.empty()) { return defaultValue; }
-
-            const auto itr1 = value.find(',');
-            const auto itr2 = value.find(',', itr1 + 1);
-            const auto itr3 = value.find(',', itr2 + 1);
-            const auto itr4 = value.find(',', itr3 + 1);
-
-            float x = std::stof(value.substr(0, itr1));
-            float y = std::stof(value.substr(itr1 + 1, itr2 - itr1 - 1));
-            float z = std::stof(value.substr(itr2 + 1, itr3 - itr2 - 1));
-            float w = std::stof(value.substr(itr3 + 1, itr4 - itr3 - 1));
+        return defaultValue;
+    }
 
-            return std::array<float, 4>{x, y, z, w};
-        }
+    std::array<float, 4> FuelBlock::toFloat4(const Attribute* attr, std::array<float, 4> defaultValue)
+    {
+        if (attr) { numeric::parseFloats(attr->value, defaultValue); }
 
         return defaultValue;
     }
 
-    vsg::vec3 FuelBlock::valueAsVec3(const std::string& name, const vsg::vec3& defaultValue) const
+    vsg::vec3 FuelBlock::toVec3(const Attribute* attr, const vsg::vec3& defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
+        if (attr)
         {
-            auto value = valueAsFloat3(name);
+            auto value = toFloat3(attr, {1.0, 1.0, 1.0});
 
             return vsg::vec3(value[0], value[1], value[2]);
         }
@@ -357,38 +321,28 @@ namespace ehb
         return defaultValue;
     }
 
-    vsg::vec4 FuelBlock::valueAsColor(const std::string& name, const vsg::vec4& defaultValue) const
+    vsg::vec4 FuelBlock::toColor(const Attribute* attr, const vsg::vec4& defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
+        if (attr)
         {
-            if (attr->value != "-1")
+            if (uint32_t value = 0; attr->value != "-1" && numeric::parse(attr->value, value, 16) == numeric::ParseError::None)
             {
-                const int base = attr->type == "i" ? 10 : 16;
+                uint8_t r = static_cast<float>((value >> 16) & 255);
+                uint8_t g = static_cast<float>((value >> 8) & 255);
+                uint8_t b = static_cast<float>(value & 255);
 
-                try
-                {
-                    const unsigned int value = std::stoul(attr->value, nullptr, 16);
-
-                    uint8_t r = static_cast<float>((value >> 16) & 255);
-                    uint8_t g = static_cast<float>((value >> 8) & 255);
-                    uint8_t b = static_cast<float>(value & 255);
-
-                    return vsg::vec4(r, g, b, 255.f) / 255.f;
-                }
-                catch (...)
-                {
-                }
+                return vsg::vec4(r, g, b, 255.f) / 255.f;
             }
         }
 
         return defaultValue;
     }
 
-    vsg::quat FuelBlock::valueAsQuat(const std::string& name, const vsg::quat& defaultValue) const
+    vsg::quat FuelBlock::toQuat(const Attribute* attr, const vsg::quat& defaultValue)
     {
-        if (const Attribute* attr = attribute(name))
+        if (attr)
         {
-            auto value = valueAsFloat4(name);
+            auto value = toFloat4(attr, {0.0, 0.0, 0.0, 1.0});
 
             return vsg::quat(value[0], value[1], value[2], value[3]);
         }
@@ -397,55 +351,27 @@ namespace ehb
     }
 
 #if 0
-    SiegeRot FuelBlock::valueAsSiegeRot(const std::string & name, const SiegeRot & defaultValue) const
+    SiegeRot FuelBlock::valueAsSiegeRot(std::string_view name, const SiegeRot& defaultValue) const
     {
-        if (const Attribute * attr = attribute(name))
-        {
-            const std::string & value = valueOf(name);
+        std::array<float, 4> rot;
+        uint32_t node;
 
-            if (value.empty())
-            {
-                return defaultValue;
-            }
-
-            const auto itr1 = value.find(',');
-            const auto itr2 = value.find(',', itr1 + 1);
-            const auto itr3 = value.find(',', itr2 + 1);
-            const auto itr4 = value.find(',', itr3 + 1);
-
-            float x = std::stof(value.substr(0, itr1));
-            float y = std::stof(value.substr(itr1 + 1, itr2 - itr1 - 1));
-            float z = std::stof(value.substr(itr2 + 1, itr3 - itr2 - 1));
-            float w = std::stof(value.substr(itr3 + 1, itr4 - itr3 - 1));
-            unsigned int node = std::stoul(value.substr(itr4 + 1), nullptr, 16);
-
-            return SiegeRot(x, y, z, w, node);
+        if (const Attribute* attr = attribute(name); attr && numeric::parseOrientation(attr->value, rot, node) == numeric::ParseError::None)
+        {
+            return SiegeRot(vsg::quat(rot[0], rot[1], rot[2], rot[3]), DatabaseGuid(node));
         }
 
         return defaultValue;
     }
 
-    SiegePos FuelBlock::valueAsSiegePos(const std::string & name, const SiegePos & defaultValue) const
+    SiegePos FuelBlock::valueAsSiegePos(std::string_view name, const SiegePos& defaultValue) const
     {
-        if (const Attribute * attr = attribute(name))
-        {
-            const std::string& value = valueOf(name);
-
-            if (value.empty())
-            {
-                return defaultValue;
-            }
+        std::array<float, 3> pos;
+        uint32_t node;
 
-            const auto itr1 = value.find(',');
-            const auto itr2 = value.find(',', itr1 + 1);
-            const auto itr3 = value.find(',', itr2 + 1);
-
-            float x = std::stof(value.substr(0, itr1));
-            float y = std::stof(value.substr(itr1 + 1, itr2 - itr1 - 1));
-            float z = std::stof(value.substr(itr2 + 1, itr3 - itr2 - 1));
-            unsigned int node = std::stoul(value.substr(itr3 + 1), nullptr, 16);
-
-            return SiegePos(x, y, z, node);
+        if (const Attribute* attr = attribute(name); attr && numeric::parsePosition(attr->value, pos, node) == numeric::ParseError::None)
+        {
+            return SiegePos(vsg::vec3(pos[0], pos[1], pos[2]), DatabaseGuid(node));
         }
 
         return defaultValue;
@@ -454,19 +380,23 @@ namespace ehb
 
     FuelBlock* FuelBlock::clone(FuelBlock* parent) const
     {
-        FuelBlock* result = new FuelBlock(parent);
+        FuelBlock* result = parent ? parent->createChild() : new FuelBlock();
 
-        result->mName = mName;
-        result->mType = mType;
+        result->mName = result->adopt(mName, this);
+        result->mType = result->adopt(mType, this);
 
+        expand();
+
+        result->mChildren.reserve(mChildren.size());
         for (const FuelBlock* child : mChildren)
         {
-            result->mChildren.push_back(child->clone(result));
+            result->addChild(child->clone(result));
         }
 
+        result->mAttributes.reserve(mAttributes.size());
         for (const Attribute& attr : mAttributes)
         {
-            result->mAttributes.push_back(attr);
+            result->addAttribute({result->adopt(attr.name, this), result->adopt(attr.type, this), result->adopt(attr.value, this), attr.typed});
         }
 
         return result;
@@ -476,91 +406,200 @@ namespace ehb
     {
         if (result)
         {
-            result->mName = mName;
-            result->mType = mType;
+            const bool renamed = result->mName != mName;
+
+            result->mName = result->adopt(mName, this);
+            result->mType = result->adopt(mType, this);
+
+            // the parent looks its children up by name so it has to know about the rename
+            if (renamed && result->mParent) { result->mParent->rebuildIndexes(); }
 
+            // isEmpty has parsed a lazy body by now
             if (!isEmpty())
             {
                 for (const FuelBlock* i : mChildren)
                 {
-                    bool found = false;
-
-                    for (FuelBlock* j : result->mChildren)
+                    if (FuelBlock* j = result->findChild(i->mName)) { i->merge(j); }
+                    else
                     {
-                        if (i->name() == j->name())
-                        {
-                            found = true;
-                            i->merge(j);
-                            break;
-                        }
-                    }
-
-                    if (!found)
-                    {
-                        FuelBlock* copy = i->clone(result);
-                        result->mChildren.push_back(copy);
+                        result->addChild(i->clone(result));
                     }
                 }
 
                 for (const Attribute& i : mAttributes)
                 {
-                    bool found = false;
-
-                    for (Attribute& j : result->mAttributes)
+                    if (Attribute* j = const_cast<Attribute*>(result->findAttribute(i.name)))
                     {
-                        if (i.name == j.name)
-                        {
-                            found = true;
-                            j = i;
-                            break;
-                        }
+                        j->type = result->adopt(i.type, this);
+                        j->value = result->adopt(i.value, this);
+                        j->typed = i.typed;
+                    }
+                    else
+                    {
+                        result->addAttribute({result->adopt(i.name, this), result->adopt(i.type, this), result->adopt(i.value, this), i.typed});
                     }
-
-                    if (!found) { result->mAttributes.push_back(i); }
                 }
             }
         }
     }
 
-    const Attribute* FuelBlock::attribute(const std::string& name) const
+    void FuelBlock::decodeValues()
+    {
+        expand();
+
+        for (Attribute& attr : mAttributes)
+        {
+            if (attr.typed.kind == FuelValue::Kind::None && !attr.type.empty()) { attr.typed = FuelValue::decode(attr.type, attr.value); }
+        }
+
+        for (FuelBlock* child : mChildren)
+        {
+            child->decodeValues();
+        }
+    }
+
+    const Attribute* FuelBlock::attribute(std::string_view name) const
     {
         const auto index = name.find_last_of(':');
 
-        const FuelBlock* parent;
-        std::string actualName;
+        const FuelBlock* parent = index != std::string_view::npos ? child(name.substr(0, index)) : this;
+
+        return parent ? parent->findAttribute(index != std::string_view::npos ? name.substr(index + 1) : name) : nullptr;
+    }
+
+    const Attribute* FuelBlock::attribute(const FuelPath& path) const
+    {
+        const FuelBlock* node = this;
 
-        if (index != std::string::npos)
+        for (size_t i = 0; i + 1 < path.size() && node; ++i)
         {
-            parent = child(name.substr(0, index));
-            actualName = name.substr(index + 1);
+            node = node->findChild(path.segment(i), path.hash(i));
         }
-        else
+
+        const size_t last = path.size() - 1;
+
+        return node ? node->findAttribute(path.segment(last), path.hash(last)) : nullptr;
+    }
+
+    FuelBlock* FuelBlock::findChild(std::string_view name) const
+    {
+        expand();
+
+        if (!mChildIndex.empty()) { return findChild(name, fuelHash(name)); }
+
+        for (FuelBlock* child : mChildren)
         {
-            parent = this;
-            actualName = name;
+            if (child->mName == name) { return child; }
         }
 
-        if (parent)
+        return nullptr;
+    }
+
+    FuelBlock* FuelBlock::findChild(std::string_view name, uint32_t hash) const
+    {
+        expand();
+
+        if (mChildIndex.empty()) { return findChild(name); }
+
+        const uint32_t position = mChildIndex.find(name, hash, [this](uint32_t i) { return mChildren[i]->mName; });
+
+        return position != FuelNameIndex::npos ? mChildren[position] : nullptr;
+    }
+
+    const Attribute* FuelBlock::findAttribute(std::string_view name) const
+    {
+        expand();
+
+        if (!mAttributeIndex.empty()) { return findAttribute(name, fuelHash(name)); }
+
+        for (const Attribute& attr : mAttributes)
         {
-            for (const Attribute& attr : parent->mAttributes)
-            {
-                if (attr.name == actualName) { return &attr; }
-            }
+            if (attr.name == name) { return &attr; }
         }
 
         return nullptr;
     }
 
-    bool Fuel::load(std::istream& stream)
+    const Attribute* FuelBlock::findAttribute(std::string_view name, uint32_t hash) const
+    {
+        expand();
+
+        if (mAttributeIndex.empty()) { return findAttribute(name); }
+
+        const uint32_t position = mAttributeIndex.find(name, hash, [this](uint32_t i) { return mAttributes[i].name; });
+
+        return position != FuelNameIndex::npos ? &mAttributes[position] : nullptr;
+    }
+
+    void FuelBlock::addChild(FuelBlock* node)
+    {
+        expand();
+
+        mChildren.push_back(node);
+
+        mChildIndex.append(*mArena, static_cast<uint32_t>(mChildren.size()), [this](uint32_t i) { return mChildren[i]->mName; });
+    }
+
+    void FuelBlock::addAttribute(const Attribute& attr)
+    {
+        expand();
+
+        mAttributes.push_back(attr);
+
+        mAttributeIndex.append(*mArena, static_cast<uint32_t>(mAttributes.size()), [this](uint32_t i) { return mAttributes[i].name; });
+    }
+
+    void FuelBlock::rebuildIndexes()
     {
-        const std::string data(std::istreambuf_iterator<char>(stream), {});
+        expand();
+
+        mChildIndex.rebuild(*mArena, static_cast<uint32_t>(mChildren.size()), [this](uint32_t i) { return mChildren[i]->mName; });
+        mAttributeIndex.rebuild(*mArena, static_cast<uint32_t>(mAttributes.size()), [this](uint32_t i) { return mAttributes[i].name; });
+    }
+
+    bool Fuel::load(std::istream& stream) { return parse(std::string(std::istreambuf_iterator<char>(stream), {})); }
+
+    bool Fuel::parse(std::string text, Parser kind)
+    {
+        // the scanner relies on the null terminator of the retained string to find the end of the input
+        const std::string_view data = arena().retain(std::move(text));
+
+        if (kind == Parser::Descent) { return FuelDescentParser(data, this).parse(); }
 
-        FuelScanner scanner(data.c_str());
+        FuelScanner scanner(data);
         FuelParser parser(scanner, this);
 
         return parser.parse() == 0;
     }
 
+    bool Fuel::loadLazy(std::istream& stream) { return parseLazy(std::string(std::istreambuf_iterator<char>(stream), {})); }
+
+    bool Fuel::parseLazy(std::string text)
+    {
+        const std::string_view data = arena().retain(std::move(text));
+
+        if (FuelDescentParser(data, this, FuelDescentParser::Mode::Shallow).parse()) { return true; }
+
+        // start over with a regular parse so a broken document is reported and recovered from like it would be otherwise
+        mChildren.clear();
+        mAttributes.clear();
+        mChildIndex = {};
+        mAttributeIndex = {};
+
+        return FuelDescentParser(data, this).parse();
+    }
+
+    void FuelBlock::expandLazyBody()
+    {
+        const std::string_view body = mLazyBody;
+
+        // cleared first so the appends below don't come back here
+        mLazyBody = {};
+
+        // parseLazy has checked the whole document, so this can't run into an error
+        FuelDescentParser(body, this, FuelDescentParser::Mode::Shallow).parse();
+    }
+
     bool Fuel::load(const std::string& filename)
     {
         std::ifstream stream(filename);
@@ -575,7 +614,7 @@ namespace ehb
 
         void write(const FuelBlock* node)
         {
-            if (node->type() != "") { stream << indent() << "[t:" << node->type() << ",n:" << node->name() << "]" << std::endl; }
+            if (!node->type().empty()) { stream << indent() << "[t:" << node->type() << ",n:" << node->name() << "]" << std::endl; }
             else
             {
                 stream << indent() << "[" << node->name() << "]" << std::endl;
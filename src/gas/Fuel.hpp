@@ -21,8 +21,15 @@
 
 #pragma once
 
+#include "FuelArena.hpp"
+#include "FuelPath.hpp"
+#include "FuelValue.hpp"
+
 #include <array>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <vsg/maths/quat.h>
 #include <vsg/maths/vec3.h>
@@ -33,23 +40,148 @@
 namespace ehb
 {
     // private
+    // NOTE: all three views point into the FuelArena of the tree the attribute belongs to
     struct Attribute
     {
-        std::string name;
-        std::string type;
-        std::string value;
+        std::string_view name;
+        std::string_view type;
+        std::string_view value;
+
+        //! filled in for trees loaded from a compiled binary or once FuelBlock::decodeValues has run
+        FuelValue typed;
+    };
+
+    class Fuel;
+    class FuelDescentParser;
+    class FuelLayer;
+    class FuelParser;
+
+    /**
+     * open addressing table from a name hash to the position of the first entry with that name,
+     * only built once a block holds more than Threshold children or attributes as a plain scan
+     * is faster for small blocks. the table lives in the arena of the tree
+     */
+    class FuelNameIndex
+    {
+    public:
+        static constexpr uint32_t Threshold = 8;
+        static constexpr uint32_t npos = ~0u;
+
+        bool empty() const;
+
+        template <typename NameOf>
+        uint32_t find(std::string_view name, uint32_t hash, NameOf nameOf) const;
+
+        //! account for the entry at position count - 1 that was just appended
+        template <typename NameOf>
+        void append(FuelArena& arena, uint32_t count, NameOf nameOf);
+
+        template <typename NameOf>
+        void rebuild(FuelArena& arena, uint32_t count, NameOf nameOf);
+
+    private:
+        struct Slot
+        {
+            uint32_t hash;
+            uint32_t position;
+        };
+
+        template <typename NameOf>
+        void insert(uint32_t position, NameOf nameOf);
+
+        Slot* mSlots = nullptr;
+        uint32_t mMask = 0;
     };
 
+    inline bool FuelNameIndex::empty() const { return mSlots == nullptr; }
+
+    template <typename NameOf>
+    inline uint32_t FuelNameIndex::find(std::string_view name, uint32_t hash, NameOf nameOf) const
+    {
+        for (uint32_t slot = hash & mMask;; slot = (slot + 1) & mMask)
+        {
+            const Slot& entry = mSlots[slot];
+
+            if (entry.position == npos) { return npos; }
+            if (entry.hash == hash && nameOf(entry.position) == name) { return entry.position; }
+        }
+    }
+
+    template <typename NameOf>
+    inline void FuelNameIndex::append(FuelArena& arena, uint32_t count, NameOf nameOf)
+    {
+        if (count <= Threshold) { return; }
+
+        // keep the load factor at or below one half
+        if (mSlots == nullptr || count * 2 > mMask + 1) { rebuild(arena, count, nameOf); }
+        else
+        {
+            insert(count - 1, nameOf);
+        }
+    }
+
+    template <typename NameOf>
+    inline void FuelNameIndex::rebuild(FuelArena& arena, uint32_t count, NameOf nameOf)
+    {
+        if (count <= Threshold)
+        {
+            mSlots = nullptr;
+            mMask = 0;
+
+            return;
+        }
+
+        uint32_t capacity = 16;
+        while (capacity < count * 4) { capacity *= 2; }
+
+        mSlots = static_cast<Slot*>(arena.allocate(capacity * sizeof(Slot), alignof(Slot)));
+        mMask = capacity - 1;
+
+        for (uint32_t i = 0; i < capacity; ++i) { mSlots[i] = {0, npos}; }
+        for (uint32_t i = 0; i < count; ++i) { insert(i, nameOf); }
+    }
+
+    template <typename NameOf>
+    inline void FuelNameIndex::insert(uint32_t position, NameOf nameOf)
+    {
+        const std::string_view name = nameOf(position);
+        const uint32_t hash = fuelHash(name);
+
+        for (uint32_t slot = hash & mMask;; slot = (slot + 1) & mMask)
+        {
+            Slot& entry = mSlots[slot];
+
+            if (entry.position == npos)
+            {
+                entry = {hash, position};
+                return;
+            }
+
+            // duplicate names (door blocks for example) resolve to the first one like a linear scan would
+            if (entry.hash == hash && nameOf(entry.position) == name) { return; }
+        }
+    }
+
     // main element to make use of in this api
+    // every block of a tree lives in the FuelArena owned by its root block, names and values are
+    // views into the retained source text or the arena, so they stay valid for as long as the root does
     class FuelBlock
     {
+        friend class Fuel;
+        friend class FuelDescentParser;
+        friend class FuelLayer;
+        friend class FuelParser;
+
     public:
-        ~FuelBlock();
+        using ChildList = std::vector<FuelBlock*, FuelArenaAllocator<FuelBlock*>>;
+        using AttributeList = std::vector<Attribute, FuelArenaAllocator<Attribute>>;
+
+        ~FuelBlock() = default;
 
         FuelBlock* parent() const;
 
-        const std::string& name() const;
-        const std::string& type() const;
+        std::string_view name() const;
+        std::string_view type() const;
 
         //! @return whether this node has no child nodes and attributes or not
         bool isEmpty() const;
@@ -59,22 +191,26 @@ namespace ehb
              * @param type the type of the new node to create
              * @return the newly created child node
              */
-        FuelBlock* appendChild(const std::string& name);
-        FuelBlock* appendChild(const std::string& name, const std::string& type);
+        FuelBlock* appendChild(std::string_view name);
+        FuelBlock* appendChild(std::string_view name, std::string_view type);
 
-        FuelBlock* child(const std::string& name) const;
+        FuelBlock* child(std::string_view name) const;
+        FuelBlock* child(const FuelPath& path) const;
 
-        const std::vector<FuelBlock*>& eachChild() const;
-        const std::vector<FuelBlock*>& eachChildOf(const std::string& name) const;
+        const ChildList& eachChild() const;
+        const ChildList& eachChildOf(std::string_view name) const;
+        const ChildList& eachChildOf(const FuelPath& path) const;
 
-        bool hasAttr(const std::string& name) const;
+        bool hasAttr(std::string_view name) const;
+        bool hasAttr(const FuelPath& path) const;
 
         // TODO: rename eachAttribute to eachAttr
-        const std::vector<Attribute>& eachAttribute() const;
-        const std::vector<Attribute>& eachAttrOf(const std::string& name) const;
+        const AttributeList& eachAttribute() const;
+        const AttributeList& eachAttrOf(std::string_view name) const;
+        const AttributeList& eachAttrOf(const FuelPath& path) const;
 
-        void appendValue(const std::string& name, const std::string& value);
-        void appendValue(const std::string& name, const std::string& type, const std::string& value);
+        void appendValue(std::string_view name, std::string_view value);
+        void appendValue(std::string_view name, std::string_view type, std::string_view value);
 
         //! @return the number of attributes in this node
         unsigned int valueCount() const;
@@ -84,40 +220,63 @@ namespace ehb
              * @param defaultValue the value to return if the attribute does not exist
              * @return the attribute type or value
              */
-        const std::string& valueOf(const std::string& name, const std::string& defaultValue = "") const;
-        const std::string& typeOf(const std::string& name, const std::string& defaultValue = "") const;
+        std::string_view valueOf(std::string_view name, std::string_view defaultValue = {}) const;
+        std::string_view typeOf(std::string_view name, std::string_view defaultValue = {}) const;
+        std::string_view valueOf(const FuelPath& path, std::string_view defaultValue = {}) const;
+        std::string_view typeOf(const FuelPath& path, std::string_view defaultValue = {}) const;
 
         /**
              * @param index which attribute name, type, or value to return ranging from 0 to valueCount()
              * @param defaultValue the value to return if the attribute does not exist
              * @return the attribute name, type, or value
              */
-        const std::string& nameOf(unsigned int index, const std::string& defaultValue = "") const;
-        const std::string& typeOf(unsigned int index, const std::string& defaultValue = "") const;
-        const std::string& valueOf(unsigned int index, const std::string& defaultValue = "") const;
+        std::string_view nameOf(unsigned int index, std::string_view defaultValue = {}) const;
+        std::string_view typeOf(unsigned int index, std::string_view defaultValue = {}) const;
+        std::string_view valueOf(unsigned int index, std::string_view defaultValue = {}) const;
 
         /**
              * @param name which attribute value to return
              * @param defaultValue the value to return if the attribute does not exist or cannot be coerced to the desired type
              * @return the attribute value interpreted as the desired type
              */
-        bool valueAsBool(const std::string& name, bool defaultValue = false) const;
-        int valueAsInt(const std::string& name, int defaultValue = 0) const;
-        unsigned int valueAsUInt(const std::string& name, unsigned int defaultValue = 0) const;
-        float valueAsFloat(const std::string& name, float defaultValue = 0.f) const;
-        double valueAsDouble(const std::string& name, double defaultvalue = 0.0) const;
-        std::string valueAsString(const std::string& name, const std::string& defaultValue = "") const;
+        bool valueAsBool(std::string_view name, bool defaultValue = false) const;
+        int valueAsInt(std::string_view name, int defaultValue = 0) const;
+        unsigned int valueAsUInt(std::string_view name, unsigned int defaultValue = 0) const;
+        float valueAsFloat(std::string_view name, float defaultValue = 0.f) const;
+        double valueAsDouble(std::string_view name, double defaultvalue = 0.0) const;
+        std::string valueAsString(std::string_view name, const std::string& defaultValue = "") const;
+
+        bool valueAsBool(const FuelPath& path, bool defaultValue = false) const;
+        int valueAsInt(const FuelPath& path, int defaultValue = 0) const;
+        unsigned int valueAsUInt(const FuelPath& path, unsigned int defaultValue = 0) const;
+        float valueAsFloat(const FuelPath& path, float defaultValue = 0.f) const;
+        double valueAsDouble(const FuelPath& path, double defaultvalue = 0.0) const;
+        std::string valueAsString(const FuelPath& path, const std::string& defaultValue = "") const;
+
+        //! guids are written in hex with or without a leading 0x regardless of the attribute type
+        uint32_t valueAsGuid(std::string_view name, uint32_t defaultValue = 0) const;
+        uint32_t valueAsGuid(const FuelPath& path, uint32_t defaultValue = 0) const;
 
         // extra types...
-        std::array<float, 3> valueAsFloat3(const std::string& name, const std::array<float, 3> defaultValue = {1.0, 1.0, 1.0}) const;
-        std::array<float, 4> valueAsFloat4(const std::string& name, const std::array<float, 4> defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
-        vsg::vec3 valueAsVec3(const std::string& name, const vsg::vec3& defaultValue = {1.0, 1.0, 1.0}) const; // don't use 1.f as vsg::vec3 could be doubles
-        vsg::vec4 valueAsColor(const std::string& name, const vsg::vec4& defaultValue = {1.f, 1.f, 1.f, 1.f}) const;
-        vsg::quat valueAsQuat(const std::string& name, const vsg::quat& defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+        std::array<float, 3> valueAsFloat3(std::string_view name, const std::array<float, 3> defaultValue = {1.0, 1.0, 1.0}) const;
+        std::array<float, 4> valueAsFloat4(std::string_view name, const std::array<float, 4> defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+        vsg::vec3 valueAsVec3(std::string_view name, const vsg::vec3& defaultValue = {1.0, 1.0, 1.0}) const; // don't use 1.f as vsg::vec3 could be doubles
+        vsg::vec4 valueAsColor(std::string_view name, const vsg::vec4& defaultValue = {1.f, 1.f, 1.f, 1.f}) const;
+        vsg::quat valueAsQuat(std::string_view name, const vsg::quat& defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+
+        std::array<float, 3> valueAsFloat3(const FuelPath& path, const std::array<float, 3> defaultValue = {1.0, 1.0, 1.0}) const;
+        std::array<float, 4> valueAsFloat4(const FuelPath& path, const std::array<float, 4> defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+        vsg::vec3 valueAsVec3(const FuelPath& path, const vsg::vec3& defaultValue = {1.0, 1.0, 1.0}) const;
+        vsg::vec4 valueAsColor(const FuelPath& path, const vsg::vec4& defaultValue = {1.f, 1.f, 1.f, 1.f}) const;
+        vsg::quat valueAsQuat(const FuelPath& path, const vsg::quat& defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
         //SiegeRot valueAsSiegeRot(const std::string & name, const SiegeRot & defaultValue = { 0.0, 0.0, 0.0, 0.0, 0}) const;
         //SiegePos valueAsSiegePos(const std::string & name, const SiegePos & defaultValue = { 0.0, 0.0, 0.0, 0 }) const;
 
-        //! create a deep copy of the node that must be deleted by the user
+        /**
+             * create a deep copy of the node
+             * without a parent the copy becomes the root of a new tree with its own arena and must be deleted by the user,
+             * otherwise it is allocated in the arena of the parent and the caller is responsible for attaching it
+             */
         FuelBlock* clone(FuelBlock* parent = nullptr) const;
 
         /**
@@ -128,97 +287,275 @@ namespace ehb
              */
         void merge(FuelBlock* result) const;
 
+        /**
+             * decode the value of every typed attribute (i, x, f and b) in this node and its children up front
+             * so the valueAs getters don't have to convert the string on every call. untyped attributes and
+             * values that don't parse keep going through the string conversions
+             */
+        void decodeValues();
+
         void write(std::ostream& stream) const;
 
     protected:
         FuelBlock(FuelBlock* parent = nullptr);
 
+        FuelArena& arena() const;
+
     private:
-        const Attribute* attribute(const std::string& name) const;
+        const Attribute* attribute(std::string_view name) const;
+        const Attribute* attribute(const FuelPath& path) const;
+
+        //! single segment lookups, these go through the hashed indexes once a block is large enough
+        FuelBlock* findChild(std::string_view name) const;
+        FuelBlock* findChild(std::string_view name, uint32_t hash) const;
+        const Attribute* findAttribute(std::string_view name) const;
+        const Attribute* findAttribute(std::string_view name, uint32_t hash) const;
+
+        //! parse the body of a block read by Fuel::parseLazy if that hasn't happened yet
+        void expand() const;
+        void expandLazyBody();
+
+        // all appends go through these so the indexes stay in sync
+        void addChild(FuelBlock* node);
+        void addAttribute(const Attribute& attr);
+        void rebuildIndexes();
+
+        static bool toBool(const Attribute* attr, bool defaultValue);
+        static int toInt(const Attribute* attr, int defaultValue);
+        static unsigned int toUInt(const Attribute* attr, unsigned int defaultValue);
+        static float toFloat(const Attribute* attr, float defaultValue);
+        static double toDouble(const Attribute* attr, double defaultValue);
+        static std::string toString(const Attribute* attr, const std::string& defaultValue);
+        static uint32_t toGuid(const Attribute* attr, uint32_t defaultValue);
+        static std::array<float, 3> toFloat3(const Attribute* attr, std::array<float, 3> defaultValue);
+        static std::array<float, 4> toFloat4(const Attribute* attr, std::array<float, 4> defaultValue);
+        static vsg::vec3 toVec3(const Attribute* attr, const vsg::vec3& defaultValue);
+        static vsg::vec4 toColor(const Attribute* attr, const vsg::vec4& defaultValue);
+        static vsg::quat toQuat(const Attribute* attr, const vsg::quat& defaultValue);
+
+        FuelBlock* createChild();
+
+        //! @return the string as seen from this tree, copying it into our arena if it belongs to another tree
+        std::string_view adopt(std::string_view str, const FuelBlock* from) const;
 
     private:
-        std::string mName;
-        std::string mType;
+        // only set on the root block of a tree, needs to be declared first so it outlives the lists below
+        std::unique_ptr<FuelArena> mOwnedArena;
+        FuelArena* mArena;
+
+        std::string_view mName;
+        std::string_view mType;
         FuelBlock* mParent;
-        std::vector<FuelBlock*> mChildren;
-        std::vector<Attribute> mAttributes;
+        ChildList mChildren;
+        AttributeList mAttributes;
+        FuelNameIndex mChildIndex;
+        FuelNameIndex mAttributeIndex;
+
+        //! the source of a block whose children and attributes haven't been parsed yet, null once they have
+        std::string_view mLazyBody;
     };
 
     inline FuelBlock::FuelBlock(FuelBlock* parent) :
-        mParent(parent) {}
+        mOwnedArena(parent ? nullptr : std::make_unique<FuelArena>()),
+        mArena(parent ? parent->mArena : mOwnedArena.get()),
+        mParent(parent),
+        mChildren(mArena),
+        mAttributes(mArena) {}
 
     inline FuelBlock* FuelBlock::parent() const { return mParent; }
 
-    inline const std::string& FuelBlock::name() const { return mName; }
+    inline void FuelBlock::expand() const
+    {
+        // the tree is logically const, the body is only parsed once and nothing observes the difference
+        if (mLazyBody.data() != nullptr) { const_cast<FuelBlock*>(this)->expandLazyBody(); }
+    }
+
+    inline std::string_view FuelBlock::name() const { return mName; }
 
-    inline const std::string& FuelBlock::type() const { return mType; }
+    inline std::string_view FuelBlock::type() const { return mType; }
 
-    inline bool FuelBlock::isEmpty() const { return mChildren.empty() && mAttributes.empty(); }
+    inline bool FuelBlock::isEmpty() const
+    {
+        expand();
 
-    inline const std::vector<FuelBlock*>& FuelBlock::eachChild() const { return mChildren; }
+        return mChildren.empty() && mAttributes.empty();
+    }
 
-    inline bool FuelBlock::hasAttr(const std::string& name) const
+    inline const FuelBlock::ChildList& FuelBlock::eachChild() const
     {
-        for (const Attribute& attr : mAttributes)
-        {
-            if (attr.name == name) { return true; }
-        }
+        expand();
 
-        return false;
+        return mChildren;
     }
 
-    inline const std::vector<Attribute>& FuelBlock::eachAttribute() const { return mAttributes; }
+    inline bool FuelBlock::hasAttr(std::string_view name) const { return findAttribute(name) != nullptr; }
 
-    inline void FuelBlock::appendValue(const std::string& name, const std::string& value) { appendValue(name, "", value); }
+    inline bool FuelBlock::hasAttr(const FuelPath& path) const { return attribute(path) != nullptr; }
+
+    inline const FuelBlock::AttributeList& FuelBlock::eachAttribute() const
+    {
+        expand();
+
+        return mAttributes;
+    }
+
+    inline void FuelBlock::appendValue(std::string_view name, std::string_view value) { appendValue(name, {}, value); }
 
     inline unsigned int FuelBlock::valueCount() const
     {
+        expand();
+
         // it's pretty safe to safe we will never have a fuel block with more than 32 bits in it
         return static_cast<unsigned int>(mAttributes.size());
     }
 
-    inline const std::string& FuelBlock::valueOf(const std::string& name, const std::string& defaultValue) const
+    inline std::string_view FuelBlock::valueOf(std::string_view name, std::string_view defaultValue) const
     {
         if (const Attribute* attr = attribute(name)) { return attr->value; }
 
         return defaultValue;
     }
 
-    inline const std::string& FuelBlock::typeOf(const std::string& name, const std::string& defaultValue) const
+    inline std::string_view FuelBlock::typeOf(std::string_view name, std::string_view defaultValue) const
     {
         if (const Attribute* attr = attribute(name)) { return attr->type; }
 
         return defaultValue;
     }
 
-    inline const std::string& FuelBlock::nameOf(unsigned int index, const std::string& defaultValue) const
+    inline std::string_view FuelBlock::valueOf(const FuelPath& path, std::string_view defaultValue) const
+    {
+        if (const Attribute* attr = attribute(path)) { return attr->value; }
+
+        return defaultValue;
+    }
+
+    inline std::string_view FuelBlock::typeOf(const FuelPath& path, std::string_view defaultValue) const
     {
+        if (const Attribute* attr = attribute(path)) { return attr->type; }
+
+        return defaultValue;
+    }
+
+    inline std::string_view FuelBlock::nameOf(unsigned int index, std::string_view defaultValue) const
+    {
+        expand();
+
         if (index < mAttributes.size()) { return mAttributes[index].name; }
 
         return defaultValue;
     }
 
-    inline const std::string& FuelBlock::typeOf(unsigned int index, const std::string& defaultValue) const
+    inline std::string_view FuelBlock::typeOf(unsigned int index, std::string_view defaultValue) const
     {
+        expand();
+
         if (index < mAttributes.size()) { return mAttributes[index].type; }
 
         return defaultValue;
     }
 
-    inline const std::string& FuelBlock::valueOf(unsigned int index, const std::string& defaultValue) const
+    inline std::string_view FuelBlock::valueOf(unsigned int index, std::string_view defaultValue) const
     {
+        expand();
+
         if (index < mAttributes.size()) { return mAttributes[index].value; }
 
         return defaultValue;
     }
 
+    inline bool FuelBlock::valueAsBool(std::string_view name, bool defaultValue) const { return toBool(attribute(name), defaultValue); }
+
+    inline bool FuelBlock::valueAsBool(const FuelPath& path, bool defaultValue) const { return toBool(attribute(path), defaultValue); }
+
+    inline int FuelBlock::valueAsInt(std::string_view name, int defaultValue) const { return toInt(attribute(name), defaultValue); }
+
+    inline int FuelBlock::valueAsInt(const FuelPath& path, int defaultValue) const { return toInt(attribute(path), defaultValue); }
+
+    inline unsigned int FuelBlock::valueAsUInt(std::string_view name, unsigned int defaultValue) const { return toUInt(attribute(name), defaultValue); }
+
+    inline unsigned int FuelBlock::valueAsUInt(const FuelPath& path, unsigned int defaultValue) const { return toUInt(attribute(path), defaultValue); }
+
+    inline float FuelBlock::valueAsFloat(std::string_view name, float defaultValue) const { return toFloat(attribute(name), defaultValue); }
+
+    inline float FuelBlock::valueAsFloat(const FuelPath& path, float defaultValue) const { return toFloat(attribute(path), defaultValue); }
+
+    inline double FuelBlock::valueAsDouble(std::string_view name, double defaultValue) const { return toDouble(attribute(name), defaultValue); }
+
+    inline double FuelBlock::valueAsDouble(const FuelPath& path, double defaultValue) const { return toDouble(attribute(path), defaultValue); }
+
+    inline std::string FuelBlock::valueAsString(std::string_view name, const std::string& defaultValue) const { return toString(attribute(name), defaultValue); }
+
+    inline std::string FuelBlock::valueAsString(const FuelPath& path, const std::string& defaultValue) const { return toString(attribute(path), defaultValue); }
+
+    inline uint32_t FuelBlock::valueAsGuid(std::string_view name, uint32_t defaultValue) const { return toGuid(attribute(name), defaultValue); }
+
+    inline uint32_t FuelBlock::valueAsGuid(const FuelPath& path, uint32_t defaultValue) const { return toGuid(attribute(path), defaultValue); }
+
+    inline std::array<float, 3> FuelBlock::valueAsFloat3(std::string_view name, const std::array<float, 3> defaultValue) const { return toFloat3(attribute(name), defaultValue); }
+
+    inline std::array<float, 3> FuelBlock::valueAsFloat3(const FuelPath& path, const std::array<float, 3> defaultValue) const { return toFloat3(attribute(path), defaultValue); }
+
+    inline std::array<float, 4> FuelBlock::valueAsFloat4(std::string_view name, const std::array<float, 4> defaultValue) const { return toFloat4(attribute(name), defaultValue); }
+
+    inline std::array<float, 4> FuelBlock::valueAsFloat4(const FuelPath& path, const std::array<float, 4> defaultValue) const { return toFloat4(attribute(path), defaultValue); }
+
+    inline vsg::vec3 FuelBlock::valueAsVec3(std::string_view name, const vsg::vec3& defaultValue) const { return toVec3(attribute(name), defaultValue); }
+
+    inline vsg::vec3 FuelBlock::valueAsVec3(const FuelPath& path, const vsg::vec3& defaultValue) const { return toVec3(attribute(path), defaultValue); }
+
+    inline vsg::vec4 FuelBlock::valueAsColor(std::string_view name, const vsg::vec4& defaultValue) const { return toColor(attribute(name), defaultValue); }
+
+    inline vsg::vec4 FuelBlock::valueAsColor(const FuelPath& path, const vsg::vec4& defaultValue) const { return toColor(attribute(path), defaultValue); }
+
+    inline vsg::quat FuelBlock::valueAsQuat(std::string_view name, const vsg::quat& defaultValue) const { return toQuat(attribute(name), defaultValue); }
+
+    inline vsg::quat FuelBlock::valueAsQuat(const FuelPath& path, const vsg::quat& defaultValue) const { return toQuat(attribute(path), defaultValue); }
+
+    inline FuelArena& FuelBlock::arena() const { return *mArena; }
+
+    inline std::string_view FuelBlock::adopt(std::string_view str, const FuelBlock* from) const { return from->mArena == mArena ? str : mArena->copy(str); }
+
     class Fuel : public FuelBlock
     {
     public:
+        //! parse the stream, the text is retained in the arena of this document
         bool load(std::istream& stream);
         bool load(const std::string& filename);
 
+        enum class Parser
+        {
+            Bison,  //! the generated FuelParser / FuelScanner
+            Descent //! the hand written FuelDescentParser / FuelLexer, produces identical trees
+        };
+
+        //! parse gas text that has already been read into memory
+        bool parse(std::string data, Parser parser = Parser::Descent);
+
+        /**
+         * only read the name and type of the top level blocks and remember where their bodies are, a body is
+         * parsed the first time anything in it is looked at (with its own child blocks deferred the same way). this
+         * pays off for documents where only a handful of values are read, touching everything costs more
+         * than a regular parse. a document with a syntax error anywhere in it is parsed in full instead
+         * NOTE: expanding a block writes to the tree, so a lazy document can't be shared between threads
+         */
+        bool loadLazy(std::istream& stream);
+        bool parseLazy(std::string data);
+
         bool save(std::ostream& stream) const;
         bool save(const std::string& filename) const;
+
+        /**
+         * compiled binary (.gasb) support, see FuelBinary.cpp for the layout. loading doesn't parse
+         * anything, names and values point straight into the mapped file and scalars come pre-decoded
+         */
+        bool loadBinary(const std::string& filename);
+        bool loadBinary(std::shared_ptr<const void> owner, std::string_view data);
+
+        //! @param sourceCrc crc32 of the text this document was parsed from so caches can tell when they are stale
+        bool saveBinary(std::ostream& stream, uint32_t sourceCrc = 0) const;
+
+        //! @return the source crc stored in a compiled document or nothing if the data isn't one
+        static std::optional<uint32_t> binarySourceCrc(std::string_view data);
     };
 } // namespace ehb
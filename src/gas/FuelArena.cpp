@@ -0,0 +1,102 @@
+#include "FuelArena.hpp"
+
+#include <algorithm>
+
+namespace ehb
+{
+    void* FuelArena::allocate(size_t size, size_t alignment)
+    {
+        size_t padding = cursor ? (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment : 0;
+
+        if (cursor == nullptr || static_cast<size_t>(end - cursor) < size + padding)
+        {
+            // oversized requests get a chunk of their own so we don't waste the remainder of the current one
+            if (size + alignment > ChunkSize / 4)
+            {
+                chunks.push_back({std::unique_ptr<char[]>(new char[size + alignment]), size + alignment});
+                track(chunks.back().data.get(), chunks.back().size);
+
+                char* data = chunks.back().data.get();
+                data += (alignment - reinterpret_cast<uintptr_t>(data) % alignment) % alignment;
+
+                allocated += size;
+
+                // NOTE: the current chunk keeps being bumped from
+                return data;
+            }
+
+            chunks.push_back({std::unique_ptr<char[]>(new char[ChunkSize]), ChunkSize});
+            track(chunks.back().data.get(), ChunkSize);
+
+            cursor = chunks.back().data.get();
+            end = cursor + ChunkSize;
+            padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        }
+
+        char* result = cursor + padding;
+        cursor = result + size;
+        allocated += size;
+
+        return result;
+    }
+
+    std::string_view FuelArena::retain(std::string&& source)
+    {
+        auto owner = std::make_shared<std::string>(std::move(source));
+        const std::string_view range = *owner;
+
+        return retain(std::move(owner), range);
+    }
+
+    std::string_view FuelArena::retain(std::shared_ptr<const void> owner, std::string_view range)
+    {
+        sources.push_back(std::move(owner));
+        track(range.data(), range.size());
+
+        return range;
+    }
+
+    std::string_view FuelArena::concat(std::string_view lhs, std::string_view rhs)
+    {
+        if (lhs.empty()) { return store(rhs); }
+        if (rhs.empty()) { return store(lhs); }
+
+        // rhs can start where lhs ends without the arena owning it, so the joined view has to be owned as a whole
+        if (const std::string_view joined(lhs.data(), lhs.size() + rhs.size()); lhs.data() + lhs.size() == rhs.data() && owns(joined)) { return joined; }
+
+        char* data = static_cast<char*>(allocate(lhs.size() + rhs.size(), 1));
+        lhs.copy(data, lhs.size());
+        rhs.copy(data + lhs.size(), rhs.size());
+
+        return {data, lhs.size() + rhs.size()};
+    }
+
+    bool FuelArena::owns(std::string_view str) const
+    {
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(str.data());
+
+        // the last range starting at or before the string is the only one that can hold it
+        auto itr = std::upper_bound(ranges.begin(), ranges.end(), begin, [](uintptr_t address, const Range& range) { return address < range.begin; });
+
+        return itr != ranges.begin() && begin + str.size() <= (--itr)->end;
+    }
+
+    void FuelArena::track(const void* data, size_t size)
+    {
+        if (size == 0) { return; }
+
+        Range range = {reinterpret_cast<uintptr_t>(data), reinterpret_cast<uintptr_t>(data) + size};
+
+        // merged with everything it overlaps or touches, a merged source can be a range of one that is already here
+        auto first = std::lower_bound(ranges.begin(), ranges.end(), range.begin, [](const Range& other, uintptr_t address) { return other.end < address; });
+        auto last = first;
+
+        for (; last != ranges.end() && last->begin <= range.end; ++last)
+        {
+            range.begin = std::min(range.begin, last->begin);
+            range.end = std::max(range.end, last->end);
+        }
+
+        ranges.insert(ranges.erase(first, last), range);
+    }
+} // namespace ehb
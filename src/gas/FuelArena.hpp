@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ehb
+{
+    /**
+     * bump allocator backing a single fuel tree. blocks, attribute lists and any strings that
+     * can't be pointed at directly are carved out of large chunks and released all at once
+     * when the root block goes away. the source text a tree was parsed from is retained here
+     * as well so names and values can stay as views into it
+     */
+    class FuelArena final
+    {
+    public:
+        static constexpr size_t ChunkSize = 32 * 1024;
+
+        FuelArena() = default;
+
+        FuelArena(const FuelArena&) = delete;
+        FuelArena& operator=(const FuelArena&) = delete;
+
+        void* allocate(size_t size, size_t alignment);
+
+        //! keep the source text alive for the lifetime of the arena
+        std::string_view retain(std::string&& source);
+
+        //! keep an externally owned buffer (like a mapped file) alive for the lifetime of the arena
+        std::string_view retain(std::shared_ptr<const void> owner, std::string_view range);
+
+        //! copy the string into the arena
+        std::string_view copy(std::string_view str);
+
+        //! copy the string into the arena unless it already lives in it
+        std::string_view store(std::string_view str);
+
+        //! @return the concatenation of both strings, joined in place when they are adjacent in memory
+        std::string_view concat(std::string_view lhs, std::string_view rhs);
+
+        //! @return whether the string points into retained source text or arena memory
+        bool owns(std::string_view str) const;
+
+        //! @return the number of bytes handed out, excluding retained sources
+        size_t bytesAllocated() const;
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<char[]> data;
+            size_t size;
+        };
+
+        struct Range
+        {
+            uintptr_t begin;
+            uintptr_t end;
+        };
+
+        //! add memory that strings may point into
+        void track(const void* data, size_t size);
+
+        std::vector<Chunk> chunks;
+        std::vector<std::shared_ptr<const void>> sources;
+
+        //! sorted and merged where they touch, the memory of every chunk and retained source
+        std::vector<Range> ranges;
+
+        char* cursor = nullptr;
+        char* end = nullptr;
+        size_t allocated = 0;
+    };
+
+    //! lets standard containers live inside a fuel arena, deallocation is a no-op
+    template <typename T>
+    class FuelArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        FuelArenaAllocator(FuelArena* arena = nullptr) noexcept :
+            arena(arena) {}
+
+        template <typename U>
+        FuelArenaAllocator(const FuelArenaAllocator<U>& other) noexcept :
+            arena(other.arena) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+
+        void deallocate(T*, size_t) noexcept {}
+
+        FuelArena* arena;
+    };
+
+    template <typename T, typename U>
+    inline bool operator==(const FuelArenaAllocator<T>& lhs, const FuelArenaAllocator<U>& rhs) noexcept { return lhs.arena == rhs.arena; }
+
+    template <typename T, typename U>
+    inline bool operator!=(const FuelArenaAllocator<T>& lhs, const FuelArenaAllocator<U>& rhs) noexcept { return lhs.arena != rhs.arena; }
+
+    inline std::string_view FuelArena::copy(std::string_view str)
+    {
+        if (str.empty()) { return {}; }
+
+        char* data = static_cast<char*>(allocate(str.size(), 1));
+        str.copy(data, str.size());
+
+        return {data, str.size()};
+    }
+
+    inline std::string_view FuelArena::store(std::string_view str) { return str.empty() || owns(str) ? str : copy(str); }
+
+    inline size_t FuelArena::bytesAllocated() const { return allocated; }
+} // namespace ehb
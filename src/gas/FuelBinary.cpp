@@ -0,0 +1,268 @@
+#include "Fuel.hpp"
+
+#include "io/MappedFile.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * compiled gas (.gasb) layout, everything is stored in native (little endian) byte order
+ *
+ *   Header
+ *   Block[blockCount]          breadth first so the children of a block are a contiguous range, block 0 is the document root
+ *   Attribute[attributeCount]  attributes of a block are a contiguous range as well
+ *   char[stringsSize]          de-duplicated names, types and values referenced by offset / size
+ */
+
+namespace ehb
+{
+    namespace
+    {
+        constexpr char Magic[4] = {'G', 'A', 'S', 'B'};
+        constexpr uint32_t Version = 1;
+
+        struct Header
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t sourceCrc;
+            uint32_t flags;
+            uint32_t blockCount;
+            uint32_t attributeCount;
+            uint32_t stringsSize;
+            uint32_t reserved;
+        };
+
+        struct StringRef
+        {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        struct Block
+        {
+            StringRef name;
+            StringRef type;
+            uint32_t firstChild;
+            uint32_t childCount;
+            uint32_t firstAttribute;
+            uint32_t attributeCount;
+        };
+
+        struct Value
+        {
+            StringRef name;
+            StringRef type;
+            StringRef value;
+            uint8_t kind;
+            uint8_t padding[7];
+            uint64_t payload;
+        };
+
+        static_assert(sizeof(Header) == 32 && sizeof(Block) == 32 && sizeof(Value) == 40, "gasb records must be tightly packed");
+
+        class StringTable
+        {
+        public:
+            StringRef add(std::string_view str)
+            {
+                if (str.empty()) { return {0, 0}; }
+
+                auto [itr, inserted] = offsets.emplace(str, static_cast<uint32_t>(data.size()));
+
+                if (inserted) { data.append(str); }
+
+                return {itr->second, static_cast<uint32_t>(str.size())};
+            }
+
+            std::string data;
+
+        private:
+            // keys point into the tree being written which outlives the table
+            std::unordered_map<std::string_view, uint32_t> offsets;
+        };
+
+        template <typename T>
+        void writeRecords(std::ostream& stream, const std::vector<T>& records)
+        {
+            stream.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(T)));
+        }
+    } // namespace
+
+    bool Fuel::saveBinary(std::ostream& stream, uint32_t sourceCrc) const
+    {
+        std::vector<const FuelBlock*> order = {this};
+        std::vector<Block> blocks;
+        std::vector<Value> values;
+        StringTable strings;
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const FuelBlock* node = order[i];
+
+            // a lazily parsed document is written out in full
+            node->expand();
+
+            Block block;
+            block.name = strings.add(node->mName);
+            block.type = strings.add(node->mType);
+            block.firstChild = static_cast<uint32_t>(order.size());
+            block.childCount = static_cast<uint32_t>(node->mChildren.size());
+            block.firstAttribute = static_cast<uint32_t>(values.size());
+            block.attributeCount = static_cast<uint32_t>(node->mAttributes.size());
+
+            order.insert(order.end(), node->mChildren.begin(), node->mChildren.end());
+
+            for (const auto& attr : node->mAttributes)
+            {
+                Value value = {};
+                value.name = strings.add(attr.name);
+                value.type = strings.add(attr.type);
+                value.value = strings.add(attr.value);
+
+                const FuelValue typed = attr.typed.kind != FuelValue::Kind::None ? attr.typed : FuelValue::decode(attr.type, attr.value);
+
+                value.kind = static_cast<uint8_t>(typed.kind);
+                std::memcpy(&value.payload, &typed.i, sizeof(typed.i));
+
+                values.push_back(value);
+            }
+
+            blocks.push_back(block);
+        }
+
+        Header header = {};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.sourceCrc = sourceCrc;
+        header.blockCount = static_cast<uint32_t>(blocks.size());
+        header.attributeCount = static_cast<uint32_t>(values.size());
+        header.stringsSize = static_cast<uint32_t>(strings.data.size());
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeRecords(stream, blocks);
+        writeRecords(stream, values);
+        stream.write(strings.data.data(), static_cast<std::streamsize>(strings.data.size()));
+
+        return static_cast<bool>(stream);
+    }
+
+    std::optional<uint32_t> Fuel::binarySourceCrc(std::string_view data)
+    {
+        Header header;
+
+        if (data.size() < sizeof(header)) { return std::nullopt; }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) { return std::nullopt; }
+
+        return header.sourceCrc;
+    }
+
+    bool Fuel::loadBinary(const std::string& filename)
+    {
+        if (auto file = MappedFile::open(filename))
+        {
+            const std::string_view data = file->data();
+
+            return loadBinary(std::move(file), data);
+        }
+
+        return false;
+    }
+
+    bool Fuel::loadBinary(std::shared_ptr<const void> owner, std::string_view data)
+    {
+        if (!binarySourceCrc(data)) { return false; }
+
+        Header header;
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        const uint64_t expected = sizeof(Header) + uint64_t(header.blockCount) * sizeof(Block) + uint64_t(header.attributeCount) * sizeof(Value) + header.stringsSize;
+
+        if (header.blockCount == 0 || expected != data.size()) { return false; }
+
+        // the records are read in place so the mapping has to be suitably aligned, mmap and std::string both are
+        if (reinterpret_cast<uintptr_t>(data.data()) % alignof(Value) != 0) { return false; }
+
+        const Block* blocks = reinterpret_cast<const Block*>(data.data() + sizeof(Header));
+        const Value* values = reinterpret_cast<const Value*>(blocks + header.blockCount);
+        const char* strings = reinterpret_cast<const char*>(values + header.attributeCount);
+
+        const auto valid = [&header](const StringRef& ref) { return ref.offset <= header.stringsSize && ref.size <= header.stringsSize - ref.offset; };
+
+        // validate everything up front so a corrupt file can't leave a half built tree behind
+        for (uint32_t i = 0; i < header.blockCount; ++i)
+        {
+            const Block& block = blocks[i];
+
+            if (!valid(block.name) || !valid(block.type)) { return false; }
+
+            // children always come after their parent which also rules out cycles
+            if (block.childCount != 0 && (block.firstChild <= i || block.firstChild > header.blockCount || block.childCount > header.blockCount - block.firstChild)) { return false; }
+
+            if (block.firstAttribute > header.attributeCount || block.attributeCount > header.attributeCount - block.firstAttribute) { return false; }
+        }
+
+        for (uint32_t i = 0; i < header.attributeCount; ++i)
+        {
+            if (!valid(values[i].name) || !valid(values[i].type) || !valid(values[i].value) || values[i].kind > static_cast<uint8_t>(FuelValue::Kind::Bool)) { return false; }
+        }
+
+        std::vector<FuelBlock*> nodes(header.blockCount, nullptr);
+        nodes[0] = this;
+
+        // a block claimed by two parents would otherwise be created twice
+        for (uint32_t i = 0; i < header.blockCount; ++i)
+        {
+            for (uint32_t c = 0; c < blocks[i].childCount; ++c)
+            {
+                if (nodes[blocks[i].firstChild + c] != nullptr) { return false; }
+
+                nodes[blocks[i].firstChild + c] = this;
+            }
+        }
+
+        arena().retain(std::move(owner), data);
+
+        const auto view = [strings](const StringRef& ref) { return std::string_view(strings + ref.offset, ref.size); };
+
+        for (uint32_t i = 0; i < header.blockCount; ++i)
+        {
+            const Block& block = blocks[i];
+            FuelBlock* node = nodes[i];
+
+            // blocks that nobody references are skipped
+            if (node == nullptr) { continue; }
+
+            for (uint32_t c = 0; c < block.childCount; ++c)
+            {
+                const Block& source = blocks[block.firstChild + c];
+
+                FuelBlock* child = node->createChild();
+                child->mName = view(source.name);
+                child->mType = view(source.type);
+
+                node->addChild(child);
+                nodes[block.firstChild + c] = child;
+            }
+
+            for (uint32_t a = 0; a < block.attributeCount; ++a)
+            {
+                const Value& source = values[block.firstAttribute + a];
+
+                Attribute attr = {view(source.name), view(source.type), view(source.value)};
+                attr.typed.kind = static_cast<FuelValue::Kind>(source.kind);
+                std::memcpy(&attr.typed.i, &source.payload, sizeof(attr.typed.i));
+
+                node->addAttribute(attr);
+            }
+        }
+
+        return true;
+    }
+} // namespace ehb
@@ -0,0 +1,160 @@
+#include "FuelCache.hpp"
+#include "Fuel.hpp"
+
+#include "io/MappedFile.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#ifdef WIN32
+#    include <filesystem>
+#    include <process.h>
+namespace fs = std::filesystem;
+#else
+#    include <experimental/filesystem>
+#    include <unistd.h>
+namespace fs = std::experimental::filesystem;
+#endif
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+namespace ehb
+{
+    FuelCache::FuelCache(const std::string& directory) :
+        mDirectory(directory)
+    {
+        std::error_code ec;
+        fs::create_directories(mDirectory, ec);
+
+        if (ec) { spdlog::get("log")->error("unable to create gas cache directory {}: {}", mDirectory, ec.message()); }
+    }
+
+    namespace
+    {
+        // slice by 8 tables for the same crc32 zlib and miniz compute, which only go a nibble or a byte at a time
+        struct Crc32Tables
+        {
+            uint32_t table[8][256];
+
+            Crc32Tables()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc = i;
+
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+                    }
+
+                    table[0][i] = crc;
+                }
+
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    for (int slice = 1; slice < 8; ++slice)
+                    {
+                        table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xff];
+                    }
+                }
+            }
+        };
+    } // namespace
+
+    uint32_t FuelCache::checksum(std::string_view data)
+    {
+        static const Crc32Tables tables;
+        const auto& t = tables.table;
+
+        auto bytes = reinterpret_cast<const unsigned char*>(data.data());
+        size_t size = data.size();
+        uint32_t crc = 0xFFFFFFFFu;
+
+        for (; size >= 8; size -= 8, bytes += 8)
+        {
+            const uint32_t low = crc ^ (uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24);
+            const uint32_t high = uint32_t(bytes[4]) | uint32_t(bytes[5]) << 8 | uint32_t(bytes[6]) << 16 | uint32_t(bytes[7]) << 24;
+
+            crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24] ^ t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+        }
+
+        for (; size != 0; --size, ++bytes)
+        {
+            crc = (crc >> 8) ^ t[0][(crc ^ *bytes) & 0xff];
+        }
+
+        return ~crc;
+    }
+
+    std::unique_ptr<Fuel> FuelCache::load(std::istream& stream)
+    {
+        std::string text(std::istreambuf_iterator<char>(stream), {});
+
+        const uint32_t crc = checksum(text);
+        const std::string filename = (fs::path(mDirectory) / fmt::format("{:08x}-{:08x}.gasb", crc, text.size())).string();
+
+        if (auto file = MappedFile::open(filename))
+        {
+            const std::string_view data = file->data();
+
+            if (Fuel::binarySourceCrc(data) == crc)
+            {
+                if (auto doc = std::make_unique<Fuel>(); doc->loadBinary(std::move(file), data))
+                {
+                    ++mHits;
+
+                    return doc;
+                }
+            }
+
+            spdlog::get("log")->warn("ignoring stale or corrupt gas cache entry {}", filename);
+        }
+
+        ++mMisses;
+
+        auto doc = std::make_unique<Fuel>();
+
+        if (!doc->parse(std::move(text))) { return nullptr; }
+
+        // write to a unique temporary first so readers on other threads or processes never see a partial file
+        const std::string temporary = temporaryFor(filename);
+
+        if (std::ofstream out(temporary, std::ios::binary); out && doc->saveBinary(out, crc))
+        {
+            out.close();
+
+            // a stale entry is replaced, otherwise it would be rejected and compiled again on every run
+            if (replace(temporary, filename)) { return doc; }
+        }
+
+        spdlog::get("log")->warn("unable to write gas cache entry {}", filename);
+
+        std::remove(temporary.c_str());
+
+        return doc;
+    }
+
+    std::string FuelCache::temporaryFor(const std::string& filename)
+    {
+#ifdef WIN32
+        const int process = _getpid();
+#else
+        const int process = static_cast<int>(getpid());
+#endif
+
+        return fmt::format("{}.{}.{}.tmp", filename, process, std::hash<std::thread::id>()(std::this_thread::get_id()));
+    }
+
+    bool FuelCache::replace(const std::string& temporary, const std::string& filename)
+    {
+        // unlike std::rename this replaces an existing file on windows as well
+        std::error_code ec;
+        fs::rename(temporary, filename, ec);
+
+        return !ec;
+    }
+} // namespace ehb
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ehb
+{
+    class Fuel;
+
+    /**
+     * on disk cache of compiled gas documents. entries are keyed by the crc32 and size of the gas
+     * text so an edited file simply misses the cache, nothing has to be invalidated by hand.
+     * safe to use from several threads at once
+     */
+    class FuelCache final
+    {
+    public:
+        explicit FuelCache(const std::string& directory);
+
+        //! @return the compiled document for the text in the stream, compiling and storing it on a miss
+        std::unique_ptr<Fuel> load(std::istream& stream);
+
+        const std::string& directory() const;
+
+        //! the crc32 entries are keyed by
+        static uint32_t checksum(std::string_view data);
+
+        //! @return a name next to the file that no other thread or process writes to at the same time
+        static std::string temporaryFor(const std::string& filename);
+
+        //! move a fully written temporary onto the file, replacing it if it exists. @return false if the temporary is still there
+        static bool replace(const std::string& temporary, const std::string& filename);
+
+        size_t hits() const;
+        size_t misses() const;
+
+    private:
+        std::string mDirectory;
+
+        std::atomic<size_t> mHits = 0;
+        std::atomic<size_t> mMisses = 0;
+    };
+
+    inline const std::string& FuelCache::directory() const { return mDirectory; }
+
+    inline size_t FuelCache::hits() const { return mHits; }
+
+    inline size_t FuelCache::misses() const { return mMisses; }
+} // namespace ehb
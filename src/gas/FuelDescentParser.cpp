@@ -0,0 +1,300 @@
+#include "FuelDescentParser.hpp"
+#include "Fuel.hpp"
+
+#include <iostream>
+
+/*
+ * the grammar, see FuelParser.y:
+ *
+ *   body       := { attribute | block }
+ *   block      := '[' block_name ']' '{' body '}'
+ *   block_name := id | id ':' id ',' id ':' id | id ',' id ':' id ',' id ':' id
+ *   attribute  := [ id ] id { ':' id } expression
+ *
+ * bison recovers from a syntax error by unwinding to the closest block whose name has been read, skipping
+ * everything up to the next '{' and reading a new body for that block. the tree isn't rolled back while
+ * doing so, and neither is the current node, so the recovery below works on the same "node" the grammar
+ * actions do rather than on the call stack
+ */
+
+namespace ehb
+{
+    FuelDescentParser::FuelDescentParser(std::string_view content, FuelBlock* root, Mode mode) :
+        lexer(content, *root->mArena), node(root), mode(mode) {}
+
+    bool FuelDescentParser::parse()
+    {
+        advance();
+
+        const Result result = parseBody();
+
+        // an unterminated expression runs into the end of the input, which the grammar never accepts
+        if (result == Result::Ok && lookahead == Token::End && !lexer.dangling()) { return true; }
+
+        // there is no enclosing block to recover in at the top level
+        if (result == Result::Ok) { error(); }
+
+        return false;
+    }
+
+    void FuelDescentParser::advance() { lookahead = lexer.next(); }
+
+    bool FuelDescentParser::expect(Token token, std::string_view* text)
+    {
+        if (lookahead != token) { return false; }
+
+        if (text) { *text = lexer.text(); }
+
+        advance();
+
+        return true;
+    }
+
+    FuelDescentParser::Result FuelDescentParser::parseBody()
+    {
+        for (;;)
+        {
+            Result result;
+
+            if (lookahead == Token::Identifier) { result = parseAttribute(); }
+            else if (lookahead == Token::LeftBracket) { result = mode == Mode::Shallow ? skipBlock() : parseBlock(); }
+            else
+            {
+                return Result::Ok;
+            }
+
+            if (result != Result::Ok) { return result; }
+        }
+    }
+
+    FuelDescentParser::Result FuelDescentParser::parseBlock()
+    {
+        advance();
+
+        if (const Result result = parseBlockName(); result != Result::Ok) { return result; }
+
+        // errors before the closing bracket belong to the enclosing block
+        if (!expect(Token::RightBracket))
+        {
+            error();
+
+            return Result::Error;
+        }
+
+        // account for rogue characters found in gpg gas file
+        bool recovering = lookahead != Token::LeftBrace;
+
+        if (recovering) { error(); }
+
+        for (;;)
+        {
+            if (recovering)
+            {
+                while (lookahead != Token::LeftBrace)
+                {
+                    if (lookahead == Token::End) { return Result::Abort; }
+
+                    advance();
+                }
+            }
+
+            advance();
+
+            const Result result = parseBody();
+
+            if (result == Result::Abort) { return result; }
+
+            if (result == Result::Ok)
+            {
+                if (lookahead == Token::RightBrace)
+                {
+                    advance();
+
+                    node = node->parent();
+
+                    return Result::Ok;
+                }
+
+                error();
+            }
+
+            recovering = true;
+        }
+    }
+
+    FuelDescentParser::Result FuelDescentParser::skipBlock()
+    {
+        advance();
+
+        if (const Result result = parseBlockName(); result != Result::Ok) { return result; }
+
+        if (!expect(Token::RightBracket) || lookahead != Token::LeftBrace) { return Result::Error; }
+
+        const char* begin = lexer.position();
+
+        advance();
+
+        // the body is still checked in full, a document with an error anywhere in it is parsed up front instead
+        if (!checkBody() || lookahead != Token::RightBrace) { return Result::Error; }
+
+        // the lexer stands right behind the closing brace
+        node->mLazyBody = std::string_view(begin, lexer.position() - 1 - begin);
+        node = node->parent();
+
+        advance();
+
+        return Result::Ok;
+    }
+
+    bool FuelDescentParser::checkBody()
+    {
+        for (;;)
+        {
+            if (lookahead == Token::Identifier)
+            {
+                advance();
+
+                if (lookahead == Token::Identifier) { advance(); }
+
+                while (lookahead == Token::Colon)
+                {
+                    if (advance(), !expect(Token::Identifier)) { return false; }
+                }
+
+                if (!expect(Token::Expression)) { return false; }
+            }
+            else if (lookahead == Token::LeftBracket)
+            {
+                advance();
+
+                if (!expect(Token::Identifier)) { return false; }
+
+                if (lookahead == Token::Colon)
+                {
+                    if (advance(), !(expect(Token::Identifier) && expect(Token::Comma) && expect(Token::Identifier) && expect(Token::Colon) && expect(Token::Identifier))) { return false; }
+                }
+                else if (lookahead == Token::Comma)
+                {
+                    if (advance(), !(expect(Token::Identifier) && expect(Token::Colon) && expect(Token::Identifier) && expect(Token::Comma) && expect(Token::Identifier) && expect(Token::Colon) && expect(Token::Identifier))) { return false; }
+                }
+
+                if (!expect(Token::RightBracket) || !expect(Token::LeftBrace) || !checkBody() || !expect(Token::RightBrace)) { return false; }
+            }
+            else
+            {
+                return true;
+            }
+        }
+    }
+
+    FuelDescentParser::Result FuelDescentParser::parseBlockName()
+    {
+        std::string_view first, type, name, ignored;
+
+        if (!expect(Token::Identifier, &first))
+        {
+            error();
+
+            return Result::Error;
+        }
+
+        if (lookahead == Token::Colon)
+        {
+            // t:type,n:name
+            if (advance(), expect(Token::Identifier, &type) && expect(Token::Comma) && expect(Token::Identifier, &ignored) && expect(Token::Colon) && expect(Token::Identifier, &name))
+            {
+                node = node->appendChild(name, type);
+
+                return Result::Ok;
+            }
+        }
+        else if (lookahead == Token::Comma)
+        {
+            // dev,t:type,n:name
+            // TODO: do something with the first identifier... like check for "dev"?
+            if (advance(), expect(Token::Identifier, &ignored) && expect(Token::Colon) && expect(Token::Identifier, &type) && expect(Token::Comma) && expect(Token::Identifier, &ignored) && expect(Token::Colon) && expect(Token::Identifier, &name))
+            {
+                node = node->appendChild(name, type);
+
+                return Result::Ok;
+            }
+        }
+        else
+        {
+            // NOTE: bison reduces this before looking at the next token, so the child exists even if no ']' follows
+            node = node->appendChild(first);
+
+            return Result::Ok;
+        }
+
+        error();
+
+        return Result::Error;
+    }
+
+    FuelDescentParser::Result FuelDescentParser::parseAttribute()
+    {
+        std::string_view type, name = lexer.text();
+
+        advance();
+
+        if (lookahead == Token::Identifier)
+        {
+            type = name;
+            name = lexer.text();
+
+            advance();
+        }
+
+        while (lookahead == Token::Colon)
+        {
+            advance();
+
+            std::string_view item;
+
+            if (!expect(Token::Identifier, &item))
+            {
+                error();
+
+                return Result::Error;
+            }
+
+            // names are nearly always written without spaces around the colons so the joined name is still a view
+            if (name.data() + name.size() + 1 == item.data() && name.data()[name.size()] == ':')
+            {
+                name = std::string_view(name.data(), name.size() + 1 + item.size());
+            }
+            else
+            {
+                char* data = static_cast<char*>(node->mArena->allocate(name.size() + 1 + item.size(), 1));
+
+                name.copy(data, name.size());
+                data[name.size()] = ':';
+                item.copy(data + name.size() + 1, item.size());
+
+                name = std::string_view(data, name.size() + 1 + item.size());
+            }
+        }
+
+        std::string_view value;
+
+        if (!expect(Token::Expression, &value))
+        {
+            error();
+
+            return Result::Error;
+        }
+
+        node->appendValue(name, type, value);
+
+        return Result::Ok;
+    }
+
+    void FuelDescentParser::error()
+    {
+        if (mode == Mode::Shallow) { return; }
+
+        // TODO: don't print this to cerr, but somewhere else user defined
+        std::cerr << "syntax error" << std::endl;
+    }
+} // namespace ehb
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "FuelLexer.hpp"
+
+#include <string_view>
+
+namespace ehb
+{
+    class FuelBlock;
+
+    /**
+     * recursive descent version of the bison FuelParser, it builds the tree straight from the views handed
+     * out by FuelLexer. it accepts the same language and recovers from errors the same way, including the
+     * order in which blocks are appended, so both produce identical trees (siege-fuel-check verifies this)
+     */
+    class FuelDescentParser
+    {
+    public:
+        enum class Mode
+        {
+            Full,   //! build the whole tree
+            Shallow //! only read the top level, block bodies are checked and left for FuelBlock to parse on demand
+        };
+
+        //! NOTE: content has to be retained in the arena of root
+        FuelDescentParser(std::string_view content, FuelBlock* root, Mode mode = Mode::Full);
+
+        /**
+         * @return false if the input couldn't be parsed, root may hold a partial tree
+         * NOTE: a shallow parse doesn't recover from errors or report them, it stops at the first one
+         */
+        bool parse();
+
+    private:
+        using Token = FuelLexer::Token;
+
+        enum class Result
+        {
+            Ok,
+            Error, // recovered by the closest enclosing block
+            Abort  // the end of the input was hit while recovering
+        };
+
+        void advance();
+
+        //! @param text receives the text of the token if it matched
+        bool expect(Token token, std::string_view* text = nullptr);
+
+        Result parseBody();
+        Result parseBlock();
+        Result skipBlock();
+
+        //! walk the grammar without building anything
+        bool checkBody();
+        Result parseBlockName();
+        Result parseAttribute();
+
+        void error();
+
+        FuelLexer lexer;
+        Token lookahead = Token::End;
+
+        FuelBlock* node;
+
+        Mode mode;
+    };
+} // namespace ehb
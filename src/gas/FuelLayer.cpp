@@ -0,0 +1,265 @@
+#include "FuelLayer.hpp"
+
+namespace ehb
+{
+    namespace
+    {
+        constexpr uint32_t npos = FuelNameIndex::npos;
+
+        //! same layout rules as FuelNameIndex, the first entry with a name wins
+        template <typename NameOf>
+        void buildIndex(std::vector<uint32_t>& slots, uint32_t count, NameOf nameOf)
+        {
+            slots.clear();
+
+            if (count <= FuelNameIndex::Threshold) { return; }
+
+            uint32_t capacity = 16;
+            while (capacity < count * 4) { capacity *= 2; }
+
+            slots.assign(capacity, npos);
+
+            const uint32_t mask = capacity - 1;
+
+            for (uint32_t position = 0; position < count; ++position)
+            {
+                const std::string_view name = nameOf(position);
+
+                for (uint32_t slot = fuelHash(name) & mask;; slot = (slot + 1) & mask)
+                {
+                    if (slots[slot] == npos)
+                    {
+                        slots[slot] = position;
+                        break;
+                    }
+
+                    if (nameOf(slots[slot]) == name) { break; }
+                }
+            }
+        }
+
+        //! index the entry that was just appended, the table is only rebuilt when it needs to grow
+        template <typename NameOf>
+        void appendIndex(std::vector<uint32_t>& slots, uint32_t count, NameOf nameOf)
+        {
+            if (count <= FuelNameIndex::Threshold) { return; }
+
+            if (slots.size() < count * 2)
+            {
+                buildIndex(slots, count, nameOf);
+                return;
+            }
+
+            const uint32_t mask = static_cast<uint32_t>(slots.size()) - 1;
+            const uint32_t position = count - 1;
+            const std::string_view name = nameOf(position);
+
+            for (uint32_t slot = fuelHash(name) & mask;; slot = (slot + 1) & mask)
+            {
+                if (slots[slot] == npos)
+                {
+                    slots[slot] = position;
+                    break;
+                }
+
+                if (nameOf(slots[slot]) == name) { break; }
+            }
+        }
+
+        template <typename NameOf>
+        uint32_t findIndex(const std::vector<uint32_t>& slots, uint32_t count, std::string_view name, uint32_t hash, NameOf nameOf)
+        {
+            if (slots.empty())
+            {
+                for (uint32_t position = 0; position < count; ++position)
+                {
+                    if (nameOf(position) == name) { return position; }
+                }
+
+                return npos;
+            }
+
+            const uint32_t mask = static_cast<uint32_t>(slots.size()) - 1;
+
+            for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask)
+            {
+                if (slots[slot] == npos) { return npos; }
+                if (nameOf(slots[slot]) == name) { return slots[slot]; }
+            }
+        }
+    } // namespace
+
+    const FuelLayer* FuelLayer::create(const FuelBlock* block, const FuelLayer* base, Storage& storage)
+    {
+        FuelLayer& layer = storage.emplace_back();
+
+        layer.mBlock = block;
+
+        // without a base this is what clone would have made of the block, duplicate names included
+        if (base == nullptr)
+        {
+            layer.mAttributes.reserve(block->eachAttribute().size());
+
+            for (const Attribute& attr : block->eachAttribute())
+            {
+                layer.mAttributes.push_back(&attr);
+            }
+
+            layer.mChildren.reserve(block->eachChild().size());
+
+            for (const FuelBlock* child : block->eachChild())
+            {
+                layer.mChildren.push_back(create(child, nullptr, storage));
+            }
+
+            layer.rebuildIndexes();
+
+            return &layer;
+        }
+
+        // positions are the same in the copies so the indexes of the base carry over as they are
+        layer.mChildren = base->mChildren;
+        layer.mAttributes = base->mAttributes;
+        layer.mChildIndex = base->mChildIndex;
+        layer.mAttributeIndex = base->mAttributeIndex;
+
+        // merge leaves the base alone when the block is empty, apart from taking over its name and type
+        if (block->isEmpty()) { return &layer; }
+
+        // anything the block doesn't mention keeps pointing at the layers of the base
+        for (const FuelBlock* child : block->eachChild())
+        {
+            const uint32_t position = findIndex(layer.mChildIndex, static_cast<uint32_t>(layer.mChildren.size()), child->name(), fuelHash(child->name()), [&layer](uint32_t i) { return layer.mChildren[i]->name(); });
+
+            if (position != npos) { layer.mChildren[position] = create(child, layer.mChildren[position], storage); }
+            else
+            {
+                layer.mChildren.push_back(create(child, nullptr, storage));
+
+                appendIndex(layer.mChildIndex, static_cast<uint32_t>(layer.mChildren.size()), [&layer](uint32_t i) { return layer.mChildren[i]->name(); });
+            }
+        }
+
+        for (const Attribute& attr : block->eachAttribute())
+        {
+            const uint32_t position = findIndex(layer.mAttributeIndex, static_cast<uint32_t>(layer.mAttributes.size()), attr.name, fuelHash(attr.name), [&layer](uint32_t i) { return layer.mAttributes[i]->name; });
+
+            if (position != npos) { layer.mAttributes[position] = &attr; }
+            else
+            {
+                layer.mAttributes.push_back(&attr);
+
+                appendIndex(layer.mAttributeIndex, static_cast<uint32_t>(layer.mAttributes.size()), [&layer](uint32_t i) { return layer.mAttributes[i]->name; });
+            }
+        }
+
+        return &layer;
+    }
+
+    const FuelLayer* FuelLayer::restore(const FuelBlock* block, ChildList children, AttributeList attributes, Storage& storage)
+    {
+        FuelLayer& layer = storage.emplace_back();
+
+        layer.mBlock = block;
+        layer.mChildren = std::move(children);
+        layer.mAttributes = std::move(attributes);
+        layer.rebuildIndexes();
+
+        return &layer;
+    }
+
+    const FuelLayer* FuelLayer::child(std::string_view name) const
+    {
+        const FuelLayer* node = this;
+
+        for (;;)
+        {
+            const auto colon = name.find(':');
+            const std::string_view segment = name.substr(0, colon);
+
+            const FuelLayer* result = node->findChild(segment, fuelHash(segment));
+
+            if (!result || colon == std::string_view::npos) { return result; }
+
+            node = result;
+            name.remove_prefix(colon + 1);
+        }
+    }
+
+    const FuelLayer* FuelLayer::child(const FuelPath& path) const
+    {
+        const FuelLayer* node = this;
+
+        for (size_t i = 0; i < path.size() && node; ++i)
+        {
+            node = node->findChild(path.segment(i), path.hash(i));
+        }
+
+        return node;
+    }
+
+    FuelBlock* FuelLayer::flatten(FuelBlock* parent) const
+    {
+        FuelBlock* result = parent ? parent->createChild() : new FuelBlock();
+
+        result->mName = result->mArena->copy(name());
+        result->mType = result->mArena->copy(type());
+
+        for (const FuelLayer* child : mChildren)
+        {
+            result->addChild(child->flatten(result));
+        }
+
+        for (const Attribute* attr : mAttributes)
+        {
+            result->addAttribute({result->mArena->copy(attr->name), result->mArena->copy(attr->type), result->mArena->copy(attr->value), attr->typed});
+        }
+
+        return result;
+    }
+
+    const Attribute* FuelLayer::attribute(std::string_view name) const
+    {
+        const auto index = name.find_last_of(':');
+
+        const FuelLayer* node = index != std::string_view::npos ? child(name.substr(0, index)) : this;
+
+        if (index != std::string_view::npos) { name.remove_prefix(index + 1); }
+
+        return node ? node->findAttribute(name, fuelHash(name)) : nullptr;
+    }
+
+    const Attribute* FuelLayer::attribute(const FuelPath& path) const
+    {
+        const FuelLayer* node = this;
+
+        for (size_t i = 0; i + 1 < path.size() && node; ++i)
+        {
+            node = node->findChild(path.segment(i), path.hash(i));
+        }
+
+        const size_t last = path.size() - 1;
+
+        return node ? node->findAttribute(path.segment(last), path.hash(last)) : nullptr;
+    }
+
+    const FuelLayer* FuelLayer::findChild(std::string_view name, uint32_t hash) const
+    {
+        const uint32_t position = findIndex(mChildIndex, static_cast<uint32_t>(mChildren.size()), name, hash, [this](uint32_t i) { return mChildren[i]->name(); });
+
+        return position != npos ? mChildren[position] : nullptr;
+    }
+
+    const Attribute* FuelLayer::findAttribute(std::string_view name, uint32_t hash) const
+    {
+        const uint32_t position = findIndex(mAttributeIndex, static_cast<uint32_t>(mAttributes.size()), name, hash, [this](uint32_t i) { return mAttributes[i]->name; });
+
+        return position != npos ? mAttributes[position] : nullptr;
+    }
+
+    void FuelLayer::rebuildIndexes()
+    {
+        buildIndex(mChildIndex, static_cast<uint32_t>(mChildren.size()), [this](uint32_t i) { return mChildren[i]->name(); });
+        buildIndex(mAttributeIndex, static_cast<uint32_t>(mAttributes.size()), [this](uint32_t i) { return mAttributes[i]->name; });
+    }
+} // namespace ehb
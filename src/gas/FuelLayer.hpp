@@ -0,0 +1,196 @@
+#pragma once
+
+#include "Fuel.hpp"
+
+#include <deque>
+
+namespace ehb
+{
+    /**
+     * read only view of a block the way it ends up after inheritance: the block a template defines layered over
+     * the resolved block of the template it specializes, following the rules of FuelBlock::merge. a layer only
+     * points at the attributes and child layers it ends up with, none of the names or values are copied, and a
+     * block the template doesn't define at all is the very same layer the base has. the blocks and base layers a
+     * layer was built from have to outlive it
+     */
+    class FuelLayer final
+    {
+    public:
+        using ChildList = std::vector<const FuelLayer*>;
+        using AttributeList = std::vector<const Attribute*>;
+
+        //! the layers built for one template, the ones it shares with its base stay in the storage of the base
+        using Storage = std::deque<FuelLayer>;
+
+        /**
+         * @param block what the template itself says, its own children and attributes override those of the base
+         * @param base the resolved block the template inherits from, if any
+         * @return the layer for the block, the storage owns it along with any child layers that had to be created
+         */
+        static const FuelLayer* create(const FuelBlock* block, const FuelLayer* base, Storage& storage);
+
+        //! put a layer back together from lists that were resolved before, the child layers have to exist already
+        static const FuelLayer* restore(const FuelBlock* block, ChildList children, AttributeList attributes, Storage& storage);
+
+        std::string_view name() const;
+        std::string_view type() const;
+
+        //! the block this layer was created for
+        const FuelBlock* block() const;
+
+        const FuelLayer* child(std::string_view name) const;
+        const FuelLayer* child(const FuelPath& path) const;
+
+        const ChildList& eachChild() const;
+        const AttributeList& eachAttribute() const;
+
+        bool hasAttr(std::string_view name) const;
+        bool hasAttr(const FuelPath& path) const;
+
+        std::string_view valueOf(std::string_view name, std::string_view defaultValue = {}) const;
+        std::string_view typeOf(std::string_view name, std::string_view defaultValue = {}) const;
+        std::string_view valueOf(const FuelPath& path, std::string_view defaultValue = {}) const;
+        std::string_view typeOf(const FuelPath& path, std::string_view defaultValue = {}) const;
+
+        //! see the FuelBlock getters of the same name
+        bool valueAsBool(std::string_view name, bool defaultValue = false) const;
+        int valueAsInt(std::string_view name, int defaultValue = 0) const;
+        unsigned int valueAsUInt(std::string_view name, unsigned int defaultValue = 0) const;
+        float valueAsFloat(std::string_view name, float defaultValue = 0.f) const;
+        double valueAsDouble(std::string_view name, double defaultValue = 0.0) const;
+        std::string valueAsString(std::string_view name, const std::string& defaultValue = "") const;
+        uint32_t valueAsGuid(std::string_view name, uint32_t defaultValue = 0) const;
+        std::array<float, 3> valueAsFloat3(std::string_view name, const std::array<float, 3> defaultValue = {1.0, 1.0, 1.0}) const;
+        std::array<float, 4> valueAsFloat4(std::string_view name, const std::array<float, 4> defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+        vsg::vec3 valueAsVec3(std::string_view name, const vsg::vec3& defaultValue = {1.0, 1.0, 1.0}) const;
+        vsg::vec4 valueAsColor(std::string_view name, const vsg::vec4& defaultValue = {1.f, 1.f, 1.f, 1.f}) const;
+        vsg::quat valueAsQuat(std::string_view name, const vsg::quat& defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+
+        bool valueAsBool(const FuelPath& path, bool defaultValue = false) const;
+        int valueAsInt(const FuelPath& path, int defaultValue = 0) const;
+        unsigned int valueAsUInt(const FuelPath& path, unsigned int defaultValue = 0) const;
+        float valueAsFloat(const FuelPath& path, float defaultValue = 0.f) const;
+        double valueAsDouble(const FuelPath& path, double defaultValue = 0.0) const;
+        std::string valueAsString(const FuelPath& path, const std::string& defaultValue = "") const;
+        uint32_t valueAsGuid(const FuelPath& path, uint32_t defaultValue = 0) const;
+        std::array<float, 3> valueAsFloat3(const FuelPath& path, const std::array<float, 3> defaultValue = {1.0, 1.0, 1.0}) const;
+        std::array<float, 4> valueAsFloat4(const FuelPath& path, const std::array<float, 4> defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+        vsg::vec3 valueAsVec3(const FuelPath& path, const vsg::vec3& defaultValue = {1.0, 1.0, 1.0}) const;
+        vsg::vec4 valueAsColor(const FuelPath& path, const vsg::vec4& defaultValue = {1.f, 1.f, 1.f, 1.f}) const;
+        vsg::quat valueAsQuat(const FuelPath& path, const vsg::quat& defaultValue = {0.0, 0.0, 0.0, 1.0}) const;
+
+        /**
+         * copy the layer out into a regular block, this gives the same tree cloning the base and merging the
+         * block into it would have. without a parent the copy is a new root that must be deleted by the user
+         */
+        FuelBlock* flatten(FuelBlock* parent = nullptr) const;
+
+    private:
+        const Attribute* attribute(std::string_view name) const;
+        const Attribute* attribute(const FuelPath& path) const;
+
+        //! single segment lookups, hashed once the layer is as large as FuelNameIndex would index a block
+        const FuelLayer* findChild(std::string_view name, uint32_t hash) const;
+        const Attribute* findAttribute(std::string_view name, uint32_t hash) const;
+
+        void rebuildIndexes();
+
+        const FuelBlock* mBlock = nullptr;
+        ChildList mChildren;
+        AttributeList mAttributes;
+
+        //! open addressing over positions in the lists above, empty for small layers
+        std::vector<uint32_t> mChildIndex;
+        std::vector<uint32_t> mAttributeIndex;
+    };
+
+    inline std::string_view FuelLayer::name() const { return mBlock->name(); }
+
+    inline std::string_view FuelLayer::type() const { return mBlock->type(); }
+
+    inline const FuelBlock* FuelLayer::block() const { return mBlock; }
+
+    inline const FuelLayer::ChildList& FuelLayer::eachChild() const { return mChildren; }
+
+    inline const FuelLayer::AttributeList& FuelLayer::eachAttribute() const { return mAttributes; }
+
+    inline bool FuelLayer::hasAttr(std::string_view name) const { return attribute(name) != nullptr; }
+
+    inline bool FuelLayer::hasAttr(const FuelPath& path) const { return attribute(path) != nullptr; }
+
+    inline std::string_view FuelLayer::valueOf(std::string_view name, std::string_view defaultValue) const
+    {
+        if (const Attribute* attr = attribute(name)) { return attr->value; }
+
+        return defaultValue;
+    }
+
+    inline std::string_view FuelLayer::typeOf(std::string_view name, std::string_view defaultValue) const
+    {
+        if (const Attribute* attr = attribute(name)) { return attr->type; }
+
+        return defaultValue;
+    }
+
+    inline std::string_view FuelLayer::valueOf(const FuelPath& path, std::string_view defaultValue) const
+    {
+        if (const Attribute* attr = attribute(path)) { return attr->value; }
+
+        return defaultValue;
+    }
+
+    inline std::string_view FuelLayer::typeOf(const FuelPath& path, std::string_view defaultValue) const
+    {
+        if (const Attribute* attr = attribute(path)) { return attr->type; }
+
+        return defaultValue;
+    }
+
+    inline bool FuelLayer::valueAsBool(std::string_view name, bool defaultValue) const { return FuelBlock::toBool(attribute(name), defaultValue); }
+
+    inline bool FuelLayer::valueAsBool(const FuelPath& path, bool defaultValue) const { return FuelBlock::toBool(attribute(path), defaultValue); }
+
+    inline int FuelLayer::valueAsInt(std::string_view name, int defaultValue) const { return FuelBlock::toInt(attribute(name), defaultValue); }
+
+    inline int FuelLayer::valueAsInt(const FuelPath& path, int defaultValue) const { return FuelBlock::toInt(attribute(path), defaultValue); }
+
+    inline unsigned int FuelLayer::valueAsUInt(std::string_view name, unsigned int defaultValue) const { return FuelBlock::toUInt(attribute(name), defaultValue); }
+
+    inline unsigned int FuelLayer::valueAsUInt(const FuelPath& path, unsigned int defaultValue) const { return FuelBlock::toUInt(attribute(path), defaultValue); }
+
+    inline float FuelLayer::valueAsFloat(std::string_view name, float defaultValue) const { return FuelBlock::toFloat(attribute(name), defaultValue); }
+
+    inline float FuelLayer::valueAsFloat(const FuelPath& path, float defaultValue) const { return FuelBlock::toFloat(attribute(path), defaultValue); }
+
+    inline double FuelLayer::valueAsDouble(std::string_view name, double defaultValue) const { return FuelBlock::toDouble(attribute(name), defaultValue); }
+
+    inline double FuelLayer::valueAsDouble(const FuelPath& path, double defaultValue) const { return FuelBlock::toDouble(attribute(path), defaultValue); }
+
+    inline std::string FuelLayer::valueAsString(std::string_view name, const std::string& defaultValue) const { return FuelBlock::toString(attribute(name), defaultValue); }
+
+    inline std::string FuelLayer::valueAsString(const FuelPath& path, const std::string& defaultValue) const { return FuelBlock::toString(attribute(path), defaultValue); }
+
+    inline uint32_t FuelLayer::valueAsGuid(std::string_view name, uint32_t defaultValue) const { return FuelBlock::toGuid(attribute(name), defaultValue); }
+
+    inline uint32_t FuelLayer::valueAsGuid(const FuelPath& path, uint32_t defaultValue) const { return FuelBlock::toGuid(attribute(path), defaultValue); }
+
+    inline std::array<float, 3> FuelLayer::valueAsFloat3(std::string_view name, const std::array<float, 3> defaultValue) const { return FuelBlock::toFloat3(attribute(name), defaultValue); }
+
+    inline std::array<float, 3> FuelLayer::valueAsFloat3(const FuelPath& path, const std::array<float, 3> defaultValue) const { return FuelBlock::toFloat3(attribute(path), defaultValue); }
+
+    inline std::array<float, 4> FuelLayer::valueAsFloat4(std::string_view name, const std::array<float, 4> defaultValue) const { return FuelBlock::toFloat4(attribute(name), defaultValue); }
+
+    inline std::array<float, 4> FuelLayer::valueAsFloat4(const FuelPath& path, const std::array<float, 4> defaultValue) const { return FuelBlock::toFloat4(attribute(path), defaultValue); }
+
+    inline vsg::vec3 FuelLayer::valueAsVec3(std::string_view name, const vsg::vec3& defaultValue) const { return FuelBlock::toVec3(attribute(name), defaultValue); }
+
+    inline vsg::vec3 FuelLayer::valueAsVec3(const FuelPath& path, const vsg::vec3& defaultValue) const { return FuelBlock::toVec3(attribute(path), defaultValue); }
+
+    inline vsg::vec4 FuelLayer::valueAsColor(std::string_view name, const vsg::vec4& defaultValue) const { return FuelBlock::toColor(attribute(name), defaultValue); }
+
+    inline vsg::vec4 FuelLayer::valueAsColor(const FuelPath& path, const vsg::vec4& defaultValue) const { return FuelBlock::toColor(attribute(path), defaultValue); }
+
+    inline vsg::quat FuelLayer::valueAsQuat(std::string_view name, const vsg::quat& defaultValue) const { return FuelBlock::toQuat(attribute(name), defaultValue); }
+
+    inline vsg::quat FuelLayer::valueAsQuat(const FuelPath& path, const vsg::quat& defaultValue) const { return FuelBlock::toQuat(attribute(path), defaultValue); }
+} // namespace ehb
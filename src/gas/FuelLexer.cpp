@@ -0,0 +1,323 @@
+#include "FuelLexer.hpp"
+#include "FuelArena.hpp"
+
+#include <array>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define FUEL_LEXER_SSE2
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#    define FUEL_LEXER_NEON
+#    include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+namespace ehb
+{
+    namespace
+    {
+        inline unsigned int countTrailingZeros(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return static_cast<unsigned int>(index);
+#else
+            return static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+        }
+
+        /**
+         * @return the first position in [begin, end) whose byte is (Match = true) or isn't (Match = false)
+         * one of Chars, or end if there is none
+         */
+        template <bool Match, char... Chars>
+        inline const char* scan(const char* begin, const char* end)
+        {
+            const char* p = begin;
+
+#if defined(FUEL_LEXER_SSE2)
+            for (; end - p >= 16; p += 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+                __m128i hits = _mm_setzero_si128();
+                ((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(Chars)))), ...);
+
+                const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits)) ^ (Match ? 0u : 0xffffu);
+
+                if (mask != 0) { return p + countTrailingZeros(mask); }
+            }
+#elif defined(FUEL_LEXER_NEON)
+            for (; end - p >= 16; p += 16)
+            {
+                const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+
+                uint8x16_t hits = vdupq_n_u8(0);
+                ((hits = vorrq_u8(hits, vceqq_u8(block, vdupq_n_u8(static_cast<uint8_t>(Chars))))), ...);
+
+                if (!Match) { hits = vmvnq_u8(hits); }
+
+                // narrow every byte of the comparison to a nibble so the whole thing fits in 64 bits
+                const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+
+                if (mask != 0) { return p + (countTrailingZeros(mask) >> 2); }
+            }
+#endif
+
+            for (; p < end; ++p)
+            {
+                if (((*p == Chars) || ...) == Match) { return p; }
+            }
+
+            return end;
+        }
+
+        constexpr std::array<bool, 256> makeIdentifierTable()
+        {
+            std::array<bool, 256> table = {};
+
+            for (int c = '0'; c <= '9'; ++c) table[c] = true;
+            for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+            for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+
+            table['_'] = table['-'] = table['*'] = table['.'] = true;
+
+            return table;
+        }
+
+        constexpr std::array<bool, 256> identifierTable = makeIdentifierTable();
+
+        inline bool isIdentifier(char c) { return identifierTable[static_cast<unsigned char>(c)]; }
+    } // namespace
+
+    FuelLexer::Token FuelLexer::next()
+    {
+        for (;;)
+        {
+            cursor = scan<false, ' ', '\t', '\r', '\n'>(cursor, limit);
+
+            if (cursor == limit) { return Token::End; }
+
+            switch (*cursor)
+            {
+            case '\0': return Token::End;
+
+            case '[': ++cursor; return Token::LeftBracket;
+            case ']': ++cursor; return Token::RightBracket;
+            case '{': ++cursor; return Token::LeftBrace;
+            case '}': ++cursor; return Token::RightBrace;
+            case ':': ++cursor; return Token::Colon;
+            case ',':
+            case ';': ++cursor; return Token::Comma;
+
+            case '=': ++cursor; return scanExpression();
+
+            case '/':
+                if (cursor + 1 < limit && cursor[1] == '/')
+                {
+                    cursor = scan<true, '\r', '\n', '\0'>(cursor + 2, limit);
+
+                    continue;
+                }
+
+                if (cursor + 1 < limit && cursor[1] == '*' && skipBlockComment()) { continue; }
+
+                // the rest of the comment may still be on its way
+                if (partial && (cursor + 1 == limit || cutOff))
+                {
+                    cutOff = true;
+                    cursor = limit;
+
+                    return Token::End;
+                }
+
+                break;
+
+            default:
+                if (isIdentifier(*cursor))
+                {
+                    const char* start = cursor;
+
+                    while (cursor < limit && isIdentifier(*cursor)) { ++cursor; }
+
+                    value = std::string_view(start, cursor - start);
+
+                    return Token::Identifier;
+                }
+            }
+
+            invalid = true;
+
+            std::cerr << "unexpected character found: '" << cursor[0] << "' (" << static_cast<int>(cursor[0]) << ")" << std::endl;
+
+            // the scanner treats anything it doesn't understand as the end of the input
+            cursor = limit;
+
+            return Token::End;
+        }
+    }
+
+    bool FuelLexer::skipBlockComment()
+    {
+        // this mirrors "/*" ([^*] | ("*" [^/]))* "*/" so a star directly followed by another one is consumed as a
+        // pair, which is why "**/" only closes a comment when there is no later "*/" to extend the match to
+        for (const char* p = cursor + 2;;)
+        {
+            p = scan<true, '*', '\0'>(p, limit);
+
+            if (p == limit || *p == '\0' || ++p == limit || *p == '\0')
+            {
+                cutOff = partial && p == limit;
+
+                return false;
+            }
+
+            if (*p == '/')
+            {
+                cursor = p + 1;
+
+                return true;
+            }
+
+            ++p;
+        }
+    }
+
+    FuelLexer::Token FuelLexer::scanExpression()
+    {
+        // comments are the only thing that has to be cut out of an expression, everything else is kept verbatim
+        const char* pieceBegin = cursor;
+        std::string_view pieces[8];
+        size_t pieceCount = 0;
+        std::string joined;
+
+        const auto skipComment = [&](const char* p) {
+            const std::string_view piece(pieceBegin, p - pieceBegin);
+
+            // always leave room for the piece that ends at the ';'
+            if (pieceCount + 1 < std::size(pieces)) { pieces[pieceCount++] = piece; }
+            else
+            {
+                // plenty of comments in a single expression, give up on keeping views around
+                for (size_t i = 0; i < pieceCount; ++i) { joined.append(pieces[i]); }
+
+                joined.append(piece);
+                pieceCount = 0;
+            }
+
+            pieceBegin = scan<true, '\r', '\n', '\0'>(p + 2, limit);
+
+            return pieceBegin;
+        };
+
+        const auto isComment = [this](const char* p) { return p + 1 < limit && p[0] == '/' && p[1] == '/'; };
+
+        for (const char* p = cursor;;)
+        {
+            p = scan<true, ';', '[', '"', '/', '\0'>(p, limit);
+
+            if (p == limit || *p == '\0') { break; }
+
+            if (*p == ';')
+            {
+                const std::string_view last(pieceBegin, p - pieceBegin);
+
+                cursor = p + 1;
+
+                if (joined.empty() && pieceCount == 0)
+                {
+                    const auto first = last.find_first_not_of(" \n\r\t");
+
+                    value = first != std::string_view::npos ? last.substr(first, last.find_last_not_of(" \n\r\t") - first + 1) : std::string_view();
+
+                    return Token::Expression;
+                }
+
+                pieces[pieceCount++] = last;
+
+                // drop whitespace from both ends across the pieces so an expression that only lost a trailing
+                // comment (by far the most common case) can still be a view into the source
+                size_t front = 0, back = pieceCount;
+
+                if (joined.empty())
+                {
+                    while (front < back && pieces[front].find_first_not_of(" \n\r\t") == std::string_view::npos) { ++front; }
+                    while (back > front && pieces[back - 1].find_first_not_of(" \n\r\t") == std::string_view::npos) { --back; }
+
+                    if (back - front <= 1)
+                    {
+                        const std::string_view piece = front < back ? pieces[front] : std::string_view();
+                        const auto first = piece.find_first_not_of(" \n\r\t");
+
+                        value = first != std::string_view::npos ? piece.substr(first, piece.find_last_not_of(" \n\r\t") - first + 1) : std::string_view();
+
+                        return Token::Expression;
+                    }
+                }
+
+                for (size_t i = front; i < back; ++i) { joined.append(pieces[i]); }
+
+                const auto first = joined.find_first_not_of(" \n\r\t");
+
+                value = first != std::string::npos ? arena.copy(std::string_view(joined).substr(first, joined.find_last_not_of(" \n\r\t") - first + 1)) : std::string_view();
+
+                return Token::Expression;
+            }
+            else if (*p == '[')
+            {
+                if (p + 1 < limit && p[1] == '[')
+                {
+                    // embedded statements run until "]]" and may contain ';'
+                    for (p += 2;;)
+                    {
+                        p = scan<true, ']', '/', '\0'>(p, limit);
+
+                        if (p == limit || *p == '\0') { break; }
+
+                        if (*p == ']' && p + 1 < limit && p[1] == ']')
+                        {
+                            p += 2;
+                            break;
+                        }
+
+                        p = isComment(p) ? skipComment(p) : p + 1;
+                    }
+
+                    if (p == limit || *p == '\0') { break; }
+                }
+                else
+                {
+                    ++p;
+                }
+            }
+            else if (*p == '"')
+            {
+                p = scan<true, '"', '\0'>(p + 1, limit);
+
+                if (p == limit || *p == '\0') { break; }
+
+                ++p;
+            }
+            else
+            {
+                p = isComment(p) ? skipComment(p) : p + 1;
+            }
+        }
+
+        // the expression was never terminated, which is only an error once all of the content is there
+        if (!partial)
+        {
+            invalid = true;
+            unterminated = true;
+        }
+
+        cursor = limit;
+
+        return Token::End;
+    }
+} // namespace ehb
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ehb
+{
+    class FuelArena;
+
+    /**
+     * hand written replacement for the re2c FuelScanner, it recognizes the same language but hands out
+     * whole expressions instead of one token per character and skips whitespace, comments and the bodies
+     * of expressions 16 bytes at a time where SSE2 or NEON is available
+     */
+    class FuelLexer
+    {
+    public:
+        enum class Token : uint8_t
+        {
+            End,
+            LeftBracket,
+            RightBracket,
+            LeftBrace,
+            RightBrace,
+            Colon,
+            Comma, // ';' is accepted as well, see the HACK note in FuelScanner.r2c
+            Identifier,
+            Expression // '=' up to and including the terminating ';', text() is the trimmed expression
+        };
+
+        /**
+         * NOTE: names and expressions are views into content unless a comment had to be cut out of an expression
+         * @param partial whether content may end in the middle of a token because more of it is still to be read
+         */
+        FuelLexer(std::string_view content, FuelArena& arena, bool partial = false);
+
+        Token next();
+
+        std::string_view text() const;
+
+        //! @return where the next token starts looking, right behind the one just returned
+        const char* position() const;
+
+        //! @return whether End was returned because a partial content ran out in the middle of a comment
+        bool truncated() const;
+
+        //! @return whether End was returned because of a character the lexer doesn't understand or an unterminated expression
+        bool failed() const;
+
+        //! @return whether End was returned because an expression ran into the end of the content
+        bool dangling() const;
+
+    private:
+        Token scanExpression();
+
+        bool skipBlockComment();
+
+        const char* cursor;
+        const char* limit;
+
+        FuelArena& arena;
+
+        std::string_view value;
+
+        bool partial;
+        bool cutOff = false;
+        bool invalid = false;
+        bool unterminated = false;
+    };
+
+    inline FuelLexer::FuelLexer(std::string_view content, FuelArena& arena, bool partial) :
+        cursor(content.data()), limit(content.data() + content.size()), arena(arena), partial(partial) {}
+
+    inline std::string_view FuelLexer::text() const { return value; }
+
+    inline const char* FuelLexer::position() const { return cursor; }
+
+    inline bool FuelLexer::truncated() const { return cutOff; }
+
+    inline bool FuelLexer::failed() const { return invalid; }
+
+    inline bool FuelLexer::dangling() const { return unterminated; }
+} // namespace ehb
@@ -0,0 +1,211 @@
+#include "FuelNumeric.hpp"
+
+#include <charconv>
+#include <limits>
+
+namespace ehb
+{
+    namespace numeric
+    {
+        namespace
+        {
+            std::string_view trim(std::string_view str)
+            {
+                constexpr std::string_view whitespace = " \t\r\n";
+
+                const size_t first = str.find_first_not_of(whitespace);
+
+                if (first == std::string_view::npos) { return {}; }
+
+                return str.substr(first, str.find_last_not_of(whitespace) - first + 1);
+            }
+
+            ParseError check(std::errc ec, const char* ptr, const char* first, const char* last)
+            {
+                if (ec == std::errc::invalid_argument || ptr == first) { return ParseError::Invalid; }
+                if (ec == std::errc::result_out_of_range) { return ParseError::OutOfRange; }
+                if (ptr != last) { return ParseError::Trailing; }
+
+                return ParseError::None;
+            }
+
+            //! strips the sign and the hex prefix, from_chars takes neither
+            ParseError magnitude(std::string_view str, uint64_t& value, bool& negative, int base)
+            {
+                str = trim(str);
+
+                if (str.empty()) { return ParseError::Empty; }
+
+                negative = str.front() == '-';
+
+                if (negative || str.front() == '+') { str.remove_prefix(1); }
+
+                if (base == 16 && str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) { str.remove_prefix(2); }
+
+                // the magnitude is read unsigned so a second sign is rejected by from_chars
+                const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value, base);
+
+                return check(ec, ptr, str.data(), str.data() + str.size());
+            }
+
+            template <typename T>
+            ParseError parseSigned(std::string_view str, T& value, int base)
+            {
+                uint64_t result = 0;
+                bool negative = false;
+
+                if (const ParseError error = magnitude(str, result, negative, base); error != ParseError::None) { return error; }
+
+                constexpr uint64_t max = static_cast<uint64_t>(std::numeric_limits<T>::max());
+
+                if (result > max + (negative ? 1 : 0)) { return ParseError::OutOfRange; }
+
+                // negate in unsigned so the smallest value doesn't overflow
+                value = negative ? static_cast<T>(0 - result) : static_cast<T>(result);
+
+                return ParseError::None;
+            }
+
+            template <typename T>
+            ParseError parseUnsigned(std::string_view str, T& value, int base)
+            {
+                uint64_t result = 0;
+                bool negative = false;
+
+                if (const ParseError error = magnitude(str, result, negative, base); error != ParseError::None) { return error; }
+
+                if ((negative && result != 0) || result > std::numeric_limits<T>::max()) { return ParseError::OutOfRange; }
+
+                value = static_cast<T>(result);
+
+                return ParseError::None;
+            }
+
+            template <typename T>
+            ParseError parseFloating(std::string_view str, T& value)
+            {
+                str = trim(str);
+
+                if (str.empty()) { return ParseError::Empty; }
+
+                // from_chars only takes a '-' so a '+' is stripped, but not ahead of another sign
+                if (str.front() == '+')
+                {
+                    str.remove_prefix(1);
+
+                    if (!str.empty() && (str.front() == '+' || str.front() == '-')) { return ParseError::Invalid; }
+                }
+
+                T result = 0;
+
+                const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
+
+                if (const ParseError error = check(ec, ptr, str.data(), str.data() + str.size()); error != ParseError::None) { return error; }
+
+                value = result;
+
+                return ParseError::None;
+            }
+        } // namespace
+
+        const char* describe(ParseError error)
+        {
+            switch (error)
+            {
+            case ParseError::None: return "no error";
+            case ParseError::Empty: return "empty value";
+            case ParseError::Invalid: return "not a number";
+            case ParseError::Trailing: return "trailing characters";
+            case ParseError::OutOfRange: return "out of range";
+            case ParseError::MissingField: return "too few fields";
+            case ParseError::ExtraField: return "too many fields";
+            }
+
+            return "unknown error";
+        }
+
+        ParseError parse(std::string_view str, int64_t& value, int base) { return parseSigned(str, value, base); }
+
+        ParseError parse(std::string_view str, uint64_t& value, int base) { return parseUnsigned(str, value, base); }
+
+        ParseError parse(std::string_view str, int32_t& value, int base) { return parseSigned(str, value, base); }
+
+        ParseError parse(std::string_view str, uint32_t& value, int base) { return parseUnsigned(str, value, base); }
+
+        ParseError parse(std::string_view str, float& value) { return parseFloating(str, value); }
+
+        ParseError parse(std::string_view str, double& value) { return parseFloating(str, value); }
+
+        ParseError parseGuid(std::string_view str, uint32_t& value)
+        {
+            uint64_t result = 0;
+
+            if (const ParseError error = parseUnsigned(str, result, 16); error != ParseError::None) { return error; }
+
+            value = static_cast<uint32_t>(result);
+
+            return ParseError::None;
+        }
+
+        bool TupleReader::field(std::string_view& str)
+        {
+            if (error != ParseError::None) { return false; }
+
+            if (exhausted)
+            {
+                error = ParseError::MissingField;
+
+                return false;
+            }
+
+            const size_t comma = rest.find(',');
+
+            str = rest.substr(0, comma);
+
+            if (comma == std::string_view::npos) { exhausted = true; }
+            else
+            {
+                rest.remove_prefix(comma + 1);
+            }
+
+            return true;
+        }
+
+        ParseError TupleReader::finish() const
+        {
+            if (error != ParseError::None) { return error; }
+
+            return exhausted ? ParseError::None : ParseError::ExtraField;
+        }
+
+        ParseError parsePosition(std::string_view str, std::array<float, 3>& position, uint32_t& node)
+        {
+            std::array<float, 3> result;
+            uint32_t guid = 0;
+
+            TupleReader reader(str);
+            reader.read(result[0]).read(result[1]).read(result[2]).readGuid(guid);
+
+            const ParseError error = reader.finish();
+
+            if (error == ParseError::None) { position = result, node = guid; }
+
+            return error;
+        }
+
+        ParseError parseOrientation(std::string_view str, std::array<float, 4>& orientation, uint32_t& node)
+        {
+            std::array<float, 4> result;
+            uint32_t guid = 0;
+
+            TupleReader reader(str);
+            reader.read(result[0]).read(result[1]).read(result[2]).read(result[3]).readGuid(guid);
+
+            const ParseError error = reader.finish();
+
+            if (error == ParseError::None) { orientation = result, node = guid; }
+
+            return error;
+        }
+    } // namespace numeric
+} // namespace ehb
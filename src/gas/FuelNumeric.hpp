@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace ehb
+{
+    /**
+     * allocation free number parsing for gas values, built on std::from_chars. surrounding whitespace and
+     * a leading '+' are accepted, as is a 0x prefix for base 16, anything else left over is an error.
+     * values are only written when parsing succeeds
+     */
+    namespace numeric
+    {
+        enum class ParseError : uint8_t
+        {
+            None,
+            Empty,
+            Invalid,
+            Trailing, //! a number followed by something that isn't part of it
+            OutOfRange,
+            MissingField,
+            ExtraField
+        };
+
+        const char* describe(ParseError error);
+
+        ParseError parse(std::string_view str, int64_t& value, int base = 10);
+        ParseError parse(std::string_view str, uint64_t& value, int base = 10);
+        ParseError parse(std::string_view str, int32_t& value, int base = 10);
+        ParseError parse(std::string_view str, uint32_t& value, int base = 10);
+        ParseError parse(std::string_view str, float& value);
+        ParseError parse(std::string_view str, double& value);
+
+        //! guids are hex with or without the 0x, some are written with 64 bits of which only the low half counts
+        ParseError parseGuid(std::string_view str, uint32_t& value);
+
+        /**
+         * reads the comma separated fields of a tuple in order. the first error sticks and everything after
+         * it is skipped, so a whole tuple can be read before checking finish()
+         */
+        class TupleReader
+        {
+        public:
+            explicit TupleReader(std::string_view str);
+
+            template <typename T>
+            TupleReader& read(T& value);
+
+            TupleReader& readGuid(uint32_t& value);
+
+            //! @return the first error or ExtraField if not all of the fields have been read
+            ParseError finish() const;
+
+        private:
+            //! @return false and set the error if there are no fields left
+            bool field(std::string_view& str);
+
+            std::string_view rest;
+            bool exhausted = false;
+            ParseError error = ParseError::None;
+        };
+
+        template <size_t N>
+        ParseError parseFloats(std::string_view str, std::array<float, N>& values);
+
+        //! "x,y,z,node" as positions relative to a siege node are written
+        ParseError parsePosition(std::string_view str, std::array<float, 3>& position, uint32_t& node);
+
+        //! "x,y,z,w,node" as orientations relative to a siege node are written
+        ParseError parseOrientation(std::string_view str, std::array<float, 4>& orientation, uint32_t& node);
+
+        inline TupleReader::TupleReader(std::string_view str) :
+            rest(str) {}
+
+        template <typename T>
+        inline TupleReader& TupleReader::read(T& value)
+        {
+            if (std::string_view str; field(str)) { error = parse(str, value); }
+
+            return *this;
+        }
+
+        inline TupleReader& TupleReader::readGuid(uint32_t& value)
+        {
+            if (std::string_view str; field(str)) { error = parseGuid(str, value); }
+
+            return *this;
+        }
+
+        template <size_t N>
+        inline ParseError parseFloats(std::string_view str, std::array<float, N>& values)
+        {
+            std::array<float, N> result;
+            TupleReader reader(str);
+
+            for (float& value : result)
+            {
+                reader.read(value);
+            }
+
+            const ParseError error = reader.finish();
+
+            if (error == ParseError::None) { values = result; }
+
+            return error;
+        }
+    } // namespace numeric
+} // namespace ehb
@@ -38,11 +38,39 @@
 
 // Unqualified %code blocks.
 
-static int yylex(std::string* yylval, ehb::FuelScanner& scanner)
+static int yylex(std::string_view* yylval, ehb::FuelScanner& scanner)
 {
     return scanner.scan(yylval);
 }
 
+// tokens are views into the source text, so neighbouring tokens can usually be joined in place
+// and only fall back to the arena when something (like a comment) sits between them
+static std::string_view join(ehb::FuelArena& arena, std::string_view lhs, std::string_view rhs)
+{
+    if (lhs.data() + lhs.size() == rhs.data())
+    {
+        return std::string_view(lhs.data(), lhs.size() + rhs.size());
+    }
+
+    return arena.concat(lhs, rhs);
+}
+
+static std::string_view join(ehb::FuelArena& arena, std::string_view lhs, char separator, std::string_view rhs)
+{
+    if (lhs.data() + lhs.size() + 1 == rhs.data() && lhs.data()[lhs.size()] == separator)
+    {
+        return std::string_view(lhs.data(), lhs.size() + 1 + rhs.size());
+    }
+
+    char* data = static_cast<char*>(arena.allocate(lhs.size() + 1 + rhs.size(), 1));
+
+    lhs.copy(data, lhs.size());
+    data[lhs.size()] = separator;
+    rhs.copy(data + lhs.size() + 1, rhs.size());
+
+    return std::string_view(data, lhs.size() + 1 + rhs.size());
+}
+
 #ifndef YY_
 #    if defined YYENABLE_NLS && YYENABLE_NLS
 #        if ENABLE_NLS
@@ -613,23 +641,28 @@ namespace ehb
 
                     case 18: // expression_list: expression_list "expression"
                     {
-                        yylhs.value = yystack_[1].value + yystack_[0].value;
+                        yylhs.value = join(*node->mArena, yystack_[1].value, yystack_[0].value);
+                    }
+                    break;
+
+                    case 19: // expression_statement: %empty
+                    {
+                        yylhs.value = std::string_view();
                     }
                     break;
 
                     case 20: // expression_statement: expression_list
                     {
 
-                        yylhs.value = yystack_[0].value;
+                        const auto first = yystack_[0].value.find_first_not_of(" \n\r\t");
 
-                        yylhs.value.erase(0, yylhs.value.find_first_not_of(" \n\r\t"));
-                        yylhs.value.erase(yylhs.value.find_last_not_of(" \n\r\t") + 1);
+                        yylhs.value = first != std::string_view::npos ? yystack_[0].value.substr(first, yystack_[0].value.find_last_not_of(" \n\r\t") - first + 1) : std::string_view();
                     }
                     break;
 
                     case 23: // identifier: identifier ':' simple_identifier
                     {
-                        yylhs.value = yystack_[2].value + ':' + yystack_[0].value;
+                        yylhs.value = join(*node->mArena, yystack_[2].value, ':', yystack_[0].value);
                     }
                     break;
 
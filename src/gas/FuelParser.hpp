@@ -48,6 +48,7 @@
 #include "gas/Fuel.hpp"
 #include "gas/FuelScanner.hpp"
 #include <string>
+#include <string_view>
 
 #include <cassert>
 #include <cstdlib> // std::abort
@@ -182,7 +183,7 @@ namespace ehb
     public:
 #ifndef YYSTYPE
         /// Symbol semantic values.
-        typedef std::string semantic_type;
+        typedef std::string_view semantic_type;
 #else
         typedef YYSTYPE semantic_type;
 #endif
@@ -22,13 +22,14 @@
 %require "3.2"
 %defines
 %define api.namespace { ehb }
-%define api.value.type { std::string }
+%define api.value.type { std::string_view }
 %define parse.assert
 %define parser_class_name { FuelParser }
 
 %code requires {
 
     #include <string>
+    #include <string_view>
     #include "gas/Fuel.hpp"
     #include "gas/FuelScanner.hpp"
 
@@ -36,11 +37,39 @@
 
 %code {
 
-    static int yylex (std::string * yylval, ehb::FuelScanner & scanner)
+    static int yylex (std::string_view * yylval, ehb::FuelScanner & scanner)
     {
         return scanner.scan(yylval);
     }
 
+    // tokens are views into the source text, so neighbouring tokens can usually be joined in place
+    // and only fall back to the arena when something (like a comment) sits between them
+    static std::string_view join (ehb::FuelArena & arena, std::string_view lhs, std::string_view rhs)
+    {
+        if (lhs.data() + lhs.size() == rhs.data())
+        {
+            return std::string_view(lhs.data(), lhs.size() + rhs.size());
+        }
+
+        return arena.concat(lhs, rhs);
+    }
+
+    static std::string_view join (ehb::FuelArena & arena, std::string_view lhs, char separator, std::string_view rhs)
+    {
+        if (lhs.data() + lhs.size() + 1 == rhs.data() && lhs.data()[lhs.size()] == separator)
+        {
+            return std::string_view(lhs.data(), lhs.size() + 1 + rhs.size());
+        }
+
+        char * data = static_cast<char *>(arena.allocate(lhs.size() + 1 + rhs.size(), 1));
+
+        lhs.copy(data, lhs.size());
+        data[lhs.size()] = separator;
+        rhs.copy(data + lhs.size() + 1, rhs.size());
+
+        return std::string_view(data, lhs.size() + 1 + rhs.size());
+    }
+
 }
 
 %lex-param { ehb::FuelScanner & scanner }
@@ -105,17 +134,16 @@ type_id
 
 expression_list
     : "expression"
-    | expression_list "expression" { $$ = $1 + $2; }
+    | expression_list "expression" { $$ = join(*node->mArena, $1, $2); }
     ;
 
 expression_statement
-    :
+    : { $$ = std::string_view(); }
     | expression_list {
 
-        $$ = $1;
+        const auto first = $1.find_first_not_of(" \n\r\t");
 
-        $$.erase(0, $$.find_first_not_of(" \n\r\t"));
-        $$.erase($$.find_last_not_of(" \n\r\t") + 1);
+        $$ = first != std::string_view::npos ? $1.substr(first, $1.find_last_not_of(" \n\r\t") - first + 1) : std::string_view();
 
     }
     ;
@@ -126,7 +154,7 @@ simple_identifier
 
 identifier
     : simple_identifier
-    | identifier ':' simple_identifier { $$ = $1 + ':' + $3; }
+    | identifier ':' simple_identifier { $$ = join(*node->mArena, $1, ':', $3); }
     ;
 
 %%
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ehb
+{
+    //! FNV-1a over the exact bytes of a block or attribute name, comparisons in fuel are case sensitive
+    constexpr uint32_t fuelHash(std::string_view str) noexcept
+    {
+        uint32_t hash = 2166136261u;
+
+        for (char c : str)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+    /**
+     * a colon separated block / attribute path that has been split and hashed up front, use this
+     * for lookups that happen over and over again (e.g. once per node of a siege_node_list)
+     *
+     *   static const FuelPath guid("guid");
+     *   node->valueAsUInt(guid);
+     */
+    class FuelPath final
+    {
+    public:
+        FuelPath(std::string_view path);
+
+        const std::string& str() const;
+
+        //! @return the number of colon separated segments
+        size_t size() const;
+
+        std::string_view segment(size_t index) const;
+        uint32_t hash(size_t index) const;
+
+    private:
+        struct Segment
+        {
+            uint32_t offset;
+            uint32_t size;
+            uint32_t hash;
+        };
+
+        std::string mPath;
+        std::vector<Segment> mSegments;
+    };
+
+    inline FuelPath::FuelPath(std::string_view path) :
+        mPath(path)
+    {
+        for (size_t offset = 0;;)
+        {
+            const auto colon = path.find(':', offset);
+            const std::string_view item = path.substr(offset, colon - offset);
+
+            mSegments.push_back({static_cast<uint32_t>(offset), static_cast<uint32_t>(item.size()), fuelHash(item)});
+
+            if (colon == std::string_view::npos) { break; }
+
+            offset = colon + 1;
+        }
+    }
+
+    inline const std::string& FuelPath::str() const { return mPath; }
+
+    inline size_t FuelPath::size() const { return mSegments.size(); }
+
+    inline std::string_view FuelPath::segment(size_t index) const { return std::string_view(mPath).substr(mSegments[index].offset, mSegments[index].size); }
+
+    inline uint32_t FuelPath::hash(size_t index) const { return mSegments[index].hash; }
+} // namespace ehb
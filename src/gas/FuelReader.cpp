@@ -0,0 +1,274 @@
+#include "FuelReader.hpp"
+#include "FuelArena.hpp"
+#include "FuelLexer.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace ehb
+{
+    namespace
+    {
+        using Token = FuelLexer::Token;
+
+        //! FuelLexer over a window of the stream that only ever holds the statement being read and what follows it
+        class ChunkedLexer
+        {
+        public:
+            explicit ChunkedLexer(std::istream& stream);
+
+            Token next();
+
+            std::string_view text() const;
+
+            //! mark the start of a statement, reading starts over from here if it turns out to be cut off
+            void begin();
+
+            //! @return whether the statement since begin() was cut off, more of the input has been read if so
+            bool retry();
+
+        private:
+            void refill();
+
+            std::istream& stream;
+            std::string buffer;
+            bool eof = false;
+
+            std::unique_ptr<FuelArena> arena;
+            std::optional<FuelLexer> lexer;
+
+            size_t statement = 0;
+            bool incomplete = false;
+        };
+
+        ChunkedLexer::ChunkedLexer(std::istream& stream) :
+            stream(stream)
+        {
+            refill();
+        }
+
+        Token ChunkedLexer::next()
+        {
+            const Token token = lexer->next();
+
+            // unless all of the input is here a token that runs up to the end of the window may go on past it
+            if (!eof && !lexer->failed() && (lexer->truncated() || lexer->position() == buffer.data() + buffer.size())) { incomplete = true; }
+
+            return token;
+        }
+
+        std::string_view ChunkedLexer::text() const { return lexer->text(); }
+
+        void ChunkedLexer::begin()
+        {
+            statement = static_cast<size_t>(lexer->position() - buffer.data());
+            incomplete = false;
+        }
+
+        bool ChunkedLexer::retry()
+        {
+            if (!incomplete) { return false; }
+
+            buffer.erase(0, statement);
+            refill();
+
+            return true;
+        }
+
+        void ChunkedLexer::refill()
+        {
+            const size_t kept = buffer.size();
+
+            buffer.resize(kept + FuelReader::ChunkSize);
+            stream.read(&buffer[kept], FuelReader::ChunkSize);
+            buffer.resize(kept + static_cast<size_t>(stream.gcount()));
+
+            eof = !stream;
+
+            // anything the lexer had to join was part of statements that have been reported already
+            lexer.reset();
+            arena = std::make_unique<FuelArena>();
+            lexer.emplace(std::string_view(buffer), *arena, !eof);
+
+            statement = 0;
+            incomplete = false;
+        }
+
+        struct Statement
+        {
+            enum class Kind
+            {
+                Attribute,
+                BlockBegin,
+                BlockEnd,
+                End,
+                Error
+            };
+
+            Kind kind = Kind::Error;
+            std::string_view name, type, value;
+        };
+
+        //! the same grammar FuelDescentParser reads, one attribute, block header or closing brace at a time
+        Statement readStatement(ChunkedLexer& lexer, std::string& joined)
+        {
+            Statement result;
+
+            switch (lexer.next())
+            {
+            case Token::Identifier: {
+                std::string_view name = lexer.text();
+                Token token = lexer.next();
+
+                if (token == Token::Identifier)
+                {
+                    result.type = name;
+                    name = lexer.text();
+                    token = lexer.next();
+                }
+
+                while (token == Token::Colon)
+                {
+                    if (lexer.next() != Token::Identifier) { return result; }
+
+                    const std::string_view item = lexer.text();
+
+                    if (name.data() + name.size() + 1 == item.data() && name.data()[name.size()] == ':')
+                    {
+                        name = std::string_view(name.data(), name.size() + 1 + item.size());
+                    }
+                    else
+                    {
+                        if (name.data() != joined.data()) { joined.assign(name); }
+
+                        joined.append(1, ':').append(item);
+                        name = joined;
+                    }
+
+                    token = lexer.next();
+                }
+
+                if (token != Token::Expression) { return result; }
+
+                result.kind = Statement::Kind::Attribute;
+                result.name = name;
+                result.value = lexer.text();
+            }
+            break;
+
+            case Token::LeftBracket: {
+                if (lexer.next() != Token::Identifier) { return result; }
+
+                const std::string_view first = lexer.text();
+                std::string_view type, name = first;
+                Token token = lexer.next();
+
+                // t:type,n:name and dev,t:type,n:name
+                if (token == Token::Colon || token == Token::Comma)
+                {
+                    if (token == Token::Comma && !(lexer.next() == Token::Identifier && lexer.next() == Token::Colon)) { return result; }
+
+                    if (lexer.next() != Token::Identifier) { return result; }
+
+                    type = lexer.text();
+
+                    if (!(lexer.next() == Token::Comma && lexer.next() == Token::Identifier && lexer.next() == Token::Colon && lexer.next() == Token::Identifier)) { return result; }
+
+                    name = lexer.text();
+                    token = lexer.next();
+                }
+
+                if (token != Token::RightBracket || lexer.next() != Token::LeftBrace) { return result; }
+
+                result.kind = Statement::Kind::BlockBegin;
+                result.name = name;
+                result.type = type;
+            }
+            break;
+
+            case Token::RightBrace: result.kind = Statement::Kind::BlockEnd; break;
+
+            case Token::End: result.kind = Statement::Kind::End; break;
+
+            default: break;
+            }
+
+            return result;
+        }
+
+        //! @return false if the input ends before the block does
+        bool skipBlock(ChunkedLexer& lexer)
+        {
+            for (size_t depth = 1; depth != 0;)
+            {
+                lexer.begin();
+
+                const Token token = lexer.next();
+
+                if (lexer.retry()) { continue; }
+
+                if (token == Token::End) { return false; }
+
+                if (token == Token::LeftBrace) { ++depth; }
+                else if (token == Token::RightBrace)
+                {
+                    --depth;
+                }
+            }
+
+            return true;
+        }
+    } // namespace
+
+    bool FuelReader::read(std::istream& stream)
+    {
+        ChunkedLexer lexer(stream);
+        std::string joined;
+
+        for (size_t depth = 0;;)
+        {
+            lexer.begin();
+
+            const Statement statement = readStatement(lexer, joined);
+
+            if (lexer.retry()) { continue; }
+
+            Next next = Next::Continue;
+
+            switch (statement.kind)
+            {
+            case Statement::Kind::Attribute:
+                if (attribute) { next = attribute(statement.name, statement.type, statement.value); }
+                break;
+
+            case Statement::Kind::BlockBegin:
+                if (beginBlock) { next = beginBlock(statement.name, statement.type); }
+
+                if (next == Next::Skip)
+                {
+                    if (!skipBlock(lexer)) { return false; }
+                }
+                else
+                {
+                    ++depth;
+                }
+                break;
+
+            case Statement::Kind::BlockEnd:
+                if (depth == 0) { return false; }
+
+                --depth;
+
+                if (endBlock) { next = endBlock(); }
+                break;
+
+            case Statement::Kind::End: return depth == 0;
+
+            case Statement::Kind::Error: return false;
+            }
+
+            if (next == Next::Stop) { return true; }
+        }
+    }
+} // namespace ehb
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <string_view>
+
+namespace ehb
+{
+    /**
+     * event driven gas reader for when building a tree isn't worth it. the input is read in chunks and only
+     * the statement being read has to be held in memory, so the size of the file doesn't matter. attributes
+     * whose name is a path ("a:b = 1;") are reported with that name instead of as blocks and the views handed
+     * to the callbacks are only valid during the call. unlike Fuel this stops at the first syntax error
+     * instead of recovering from it
+     */
+    class FuelReader final
+    {
+    public:
+        static constexpr size_t ChunkSize = 64 * 1024;
+
+        enum class Next
+        {
+            Continue,
+            Skip, //! from beginBlock: nothing inside the block is reported, its endBlock included
+            Stop
+        };
+
+        //! unset callbacks continue
+        std::function<Next(std::string_view name, std::string_view type)> beginBlock;
+        std::function<Next(std::string_view name, std::string_view type, std::string_view value)> attribute;
+        std::function<Next()> endBlock;
+
+        //! @return false on a syntax error, stopping from a callback isn't one
+        bool read(std::istream& stream);
+    };
+} // namespace ehb
@@ -24,7 +24,7 @@
 
 namespace ehb
 {
-    int FuelScanner::scan(std::string* yylval)
+    int FuelScanner::scan(std::string_view* yylval)
     {
 #define YYCTYPE char
 #define YYCURSOR cursor
@@ -32,12 +32,15 @@ namespace ehb
 #define YYMARKER marker
 #define YYFILL(n)
 
-#define yytext std::string(start, cursor - start)
+#define yytext std::string_view(start, cursor - start)
 
         while (1)
         {
             const char* start = cursor;
 
+            // only the top level matches the terminator, an expression that runs into it would read on past the end
+            if (cursor >= limit) { return 0; }
+
             if (state.empty())
             {
                 /*
@@ -302,6 +305,7 @@ namespace ehb
                     yych = *YYCURSOR;
                     switch (yych)
                     {
+                    case 0x00: goto yy39;
                     case '*': goto yy37;
                     default: goto yy32;
                     }
@@ -325,6 +329,7 @@ namespace ehb
                     yych = *YYCURSOR;
                     switch (yych)
                     {
+                    case 0x00: goto yy39;
                     case '/': goto yy38;
                     default: goto yy32;
                     }
@@ -333,6 +338,12 @@ namespace ehb
                     {
                         continue;
                     }
+                yy39:
+                    ++YYCURSOR;
+                    {
+                        std::cerr << "unterminated comment found" << std::endl;
+                        return 0;
+                    }
                 }
             }
             else if (state.top() == embedded_statement)
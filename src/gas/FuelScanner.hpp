@@ -20,18 +20,19 @@
 
 #pragma once
 
-#include <cstring>
 #include <stack>
-#include <string>
+#include <string_view>
 
 namespace ehb
 {
     class FuelScanner
     {
     public:
-        FuelScanner(const char* content);
+        //! NOTE: content must be followed by a null terminator which marks the end of the input
+        FuelScanner(std::string_view content);
 
-        int scan(std::string* yylval);
+        //! tokens are returned as views into content
+        int scan(std::string_view* yylval);
 
     private:
         enum
@@ -50,6 +51,6 @@ namespace ehb
         const char* marker;
     };
 
-    inline FuelScanner::FuelScanner(const char* content) :
-        content(content), cursor(content) { limit = content + strlen(content); }
+    inline FuelScanner::FuelScanner(std::string_view content) :
+        content(content.data()), cursor(content.data()), limit(content.data() + content.size()) {}
 } // namespace ehb
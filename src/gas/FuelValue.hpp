@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ehb
+{
+    /**
+     * attribute value decoded according to its declared gas type so the typed getters don't have to
+     * convert the string on every call. only the scalar types are decoded, anything else (vectors,
+     * untyped values, values that fail to convert) stays None and is read from the string instead
+     *
+     *   i - Int, base 10
+     *   x - Int, base 16
+     *   f - Float
+     *   b - Bool
+     */
+    struct FuelValue
+    {
+        enum class Kind : uint8_t
+        {
+            None,
+            Int,
+            Float,
+            Bool
+        };
+
+        Kind kind = Kind::None;
+
+        union
+        {
+            int64_t i;
+            float f;
+            bool b;
+        };
+
+        FuelValue() :
+            i(0) {}
+
+        //! decode the value with the same rules the string based getters use
+        static FuelValue decode(std::string_view type, std::string_view value);
+    };
+} // namespace ehb
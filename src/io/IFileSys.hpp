@@ -2,12 +2,19 @@
 #pragma once
 
 #include "gas/Fuel.hpp"
+#include "gas/FuelCache.hpp"
+#include "io/ThreadPool.hpp"
 #include <algorithm>
+#include <condition_variable>
 #include <functional>
 #include <istream>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <vsg/io/FileSystem.h>
 
@@ -24,6 +31,28 @@ namespace ehb
     using FileList = std::set<std::string>;
     using InputStream = std::unique_ptr<std::istream>;
 
+    //! how the parallel eachGasFile hands documents to the callback
+    enum class GasFileOrder
+    {
+        Sorted,   //! in filename order, one at a time on the calling thread
+        Unordered //! as soon as they are parsed, from the worker threads so the callback has to be thread safe
+    };
+
+    //! how much of a gas document is parsed up front, see Fuel::parseLazy
+    enum class GasLoad
+    {
+        Full,
+        Lazy //! for callers that only read a few values, the document can't be read from several threads at once
+    };
+
+    //! identifies the content a file or an archive holding it had when something was built from it
+    struct SourceCrc
+    {
+        std::string name;
+        uint32_t crc = 0;
+        uint64_t size = 0;
+    };
+
     class IConfig;
     class IFileSys
     {
@@ -38,7 +67,30 @@ namespace ehb
         virtual FileList getDirectoryContents(const std::string& directory) const = 0;
 
         void eachGasFile(const std::string& directory, std::function<void(const std::string&, std::unique_ptr<Fuel>)> func);
-        std::unique_ptr<Fuel> openGasFile(const std::string& file);
+
+        /**
+         * open and parse the gas files on a pool of worker threads
+         * @param threads the number of workers, 0 picks one per hardware thread
+         * NOTE: createInputStream and the gas cache are called from the workers
+         */
+        void eachGasFile(const std::string& directory, GasFileOrder order, std::function<void(const std::string&, std::unique_ptr<Fuel>)> func, unsigned int threads = 0);
+
+        std::unique_ptr<Fuel> openGasFile(const std::string& file, GasLoad load = GasLoad::Full);
+
+        //! parse a gas document, going through the compiled gas cache when one is set
+        std::unique_ptr<Fuel> readGasFile(std::istream& stream, GasLoad load = GasLoad::Full);
+
+        /**
+         * crcs covering every gas file under the directory so whatever is built from them can tell when it is stale.
+         * the default reads each file, filesystems that already know checksums for their content override it
+         */
+        virtual std::vector<SourceCrc> gasSourceCrcs(const std::string& directory);
+
+        void setGasCache(std::shared_ptr<FuelCache> cache);
+        FuelCache* gasCache() const;
+
+    private:
+        std::shared_ptr<FuelCache> mGasCache;
     };
 
     inline std::string getSimpleFileName(const std::string& fileName)
@@ -57,7 +109,7 @@ namespace ehb
                 {
                     if (auto stream = createInputStream(filename))
                     {
-                        if (auto doc = std::make_unique<Fuel>(); doc->load(*stream)) { func(filename, std::move(doc)); }
+                        if (auto doc = readGasFile(*stream)) { func(filename, std::move(doc)); }
                         else
                         {
                             // log->error("{}: could not parse", filename);
@@ -72,16 +124,180 @@ namespace ehb
         }
     }
 
-    inline std::unique_ptr<Fuel> IFileSys::openGasFile(const std::string& file)
+    inline void IFileSys::eachGasFile(const std::string& directory, GasFileOrder order, std::function<void(const std::string&, std::unique_ptr<Fuel>)> func, unsigned int threads)
     {
-        if (InputStream stream = createInputStream(file))
+        std::vector<std::string> filenames;
+
+        for (const auto& filename : getFiles())
+        {
+            if (vsg::lowerCaseFileExtension(filename) == ".gas" && filename.find(directory) == 0) { filenames.push_back(filename); }
+        }
+
+        if (order == GasFileOrder::Unordered)
         {
-            if (std::unique_ptr<Fuel> gas = std::make_unique<Fuel>(); gas->load(*stream))
+            parallelFor(filenames.size(), threads, [&](unsigned int, size_t index) {
+                if (auto doc = openGasFile(filenames[index])) { func(filenames[index], std::move(doc)); }
+            });
+
+            return;
+        }
+
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+        threads = std::min(threads, static_cast<unsigned int>(ThreadPool::instance().size() + 1));
+
+        // the workers don't get further ahead of the callback than this so a slow one doesn't end up with every
+        // document of the directory in memory at once
+        const size_t window = 2 * static_cast<size_t>(threads);
+
+        std::vector<std::unique_ptr<Fuel>> slots(filenames.size());
+        std::vector<bool> ready(filenames.size(), false);
+        size_t next = 0, delivered = 0;
+        bool cancelled = false;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        // the calling thread hands the documents over in order and parses the next one itself when nobody else has
+        // taken it yet, so it never waits on a worker that the pool hasn't gotten around to starting
+        auto consume = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (!cancelled && delivered < filenames.size())
             {
-                return gas;
+                if (ready[delivered])
+                {
+                    const size_t index = delivered;
+                    std::unique_ptr<Fuel> doc = std::move(slots[index]);
+
+                    lock.unlock();
+
+                    if (doc) { func(filenames[index], std::move(doc)); }
+
+                    lock.lock();
+
+                    ++delivered;
+                }
+                else if (next == delivered)
+                {
+                    const size_t index = next++;
+
+                    lock.unlock();
+
+                    auto doc = openGasFile(filenames[index]);
+
+                    lock.lock();
+
+                    slots[index] = std::move(doc);
+                    ready[index] = true;
+                }
+                else
+                {
+                    condition.wait(lock);
+
+                    continue;
+                }
+
+                condition.notify_all();
             }
+        };
+
+        auto produce = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            for (;;)
+            {
+                condition.wait(lock, [&]() { return cancelled || next >= filenames.size() || next < delivered + window; });
+
+                if (cancelled || next >= filenames.size()) { return; }
+
+                const size_t index = next++;
+
+                lock.unlock();
+
+                auto doc = openGasFile(filenames[index]);
+
+                lock.lock();
+
+                slots[index] = std::move(doc);
+                ready[index] = true;
+
+                condition.notify_all();
+            }
+        };
+
+        // one call per worker rather than one per file, index 0 always runs on the calling thread
+        parallelFor(threads, threads, [&](unsigned int, size_t index) {
+            try
+            {
+                if (index == 0) { consume(); }
+                else
+                {
+                    produce();
+                }
+            }
+            catch (...)
+            {
+                // the slot that threw is never filled or handed over, so everyone waiting on it has to give up
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    cancelled = true;
+                }
+
+                condition.notify_all();
+
+                throw;
+            }
+        });
+    }
+
+    inline std::unique_ptr<Fuel> IFileSys::openGasFile(const std::string& file, GasLoad load)
+    {
+        if (InputStream stream = createInputStream(file))
+        {
+            return readGasFile(*stream, load);
         }
 
         return nullptr;
     }
+
+    inline std::unique_ptr<Fuel> IFileSys::readGasFile(std::istream& stream, GasLoad load)
+    {
+        // a compiled document is cheaper to load than even a lazy parse
+        if (mGasCache) { return mGasCache->load(stream); }
+
+        if (std::unique_ptr<Fuel> gas = std::make_unique<Fuel>(); load == GasLoad::Lazy ? gas->loadLazy(stream) : gas->load(stream))
+        {
+            return gas;
+        }
+
+        return nullptr;
+    }
+
+    inline std::vector<SourceCrc> IFileSys::gasSourceCrcs(const std::string& directory)
+    {
+        std::vector<SourceCrc> result;
+
+        for (const auto& filename : getFiles())
+        {
+            if (vsg::lowerCaseFileExtension(filename) == ".gas" && filename.find(directory) == 0)
+            {
+                if (auto stream = createInputStream(filename))
+                {
+                    std::ostringstream text;
+                    text << stream->rdbuf();
+
+                    const std::string data = text.str();
+
+                    result.push_back({filename, FuelCache::checksum(data), data.size()});
+                }
+            }
+        }
+
+        return result;
+    }
+
+    inline void IFileSys::setGasCache(std::shared_ptr<FuelCache> cache) { mGasCache = std::move(cache); }
+
+    inline FuelCache* IFileSys::gasCache() const { return mGasCache.get(); }
 } // namespace ehb
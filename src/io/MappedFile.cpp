@@ -0,0 +1,78 @@
+#include "MappedFile.hpp"
+
+#ifdef WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace ehb
+{
+#ifdef WIN32
+    std::shared_ptr<MappedFile> MappedFile::open(const std::string& filename)
+    {
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE) { return nullptr; }
+
+        std::shared_ptr<MappedFile> result(new MappedFile);
+        result->mFile = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) { return nullptr; }
+
+        // mapping an empty file fails, treat it as an empty view instead
+        if (size.QuadPart == 0) { return result; }
+
+        result->mMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (result->mMapping == nullptr) { return nullptr; }
+
+        result->mData = static_cast<const char*>(MapViewOfFile(result->mMapping, FILE_MAP_READ, 0, 0, 0));
+        if (result->mData == nullptr) { return nullptr; }
+
+        result->mSize = static_cast<size_t>(size.QuadPart);
+
+        return result;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData) { UnmapViewOfFile(mData); }
+        if (mMapping) { CloseHandle(mMapping); }
+        if (mFile) { CloseHandle(mFile); }
+    }
+#else
+    std::shared_ptr<MappedFile> MappedFile::open(const std::string& filename)
+    {
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+
+        if (fd == -1) { return nullptr; }
+
+        std::shared_ptr<MappedFile> result;
+
+        if (struct stat info; fstat(fd, &info) == 0)
+        {
+            if (info.st_size == 0) { result.reset(new MappedFile); }
+            else if (void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0); data != MAP_FAILED)
+            {
+                result.reset(new MappedFile);
+                result->mData = static_cast<const char*>(data);
+                result->mSize = static_cast<size_t>(info.st_size);
+            }
+        }
+
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+
+        return result;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData) { munmap(const_cast<char*>(mData), mSize); }
+    }
+#endif
+} // namespace ehb
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ehb
+{
+    /**
+     * read only memory mapping of a whole file, the mapping stays valid for as long as
+     * somebody holds on to the shared pointer
+     */
+    class MappedFile final
+    {
+    public:
+        //! @return nullptr if the file doesn't exist or couldn't be mapped
+        static std::shared_ptr<MappedFile> open(const std::string& filename);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view data() const;
+
+    private:
+        MappedFile() = default;
+
+        const char* mData = nullptr;
+        size_t mSize = 0;
+
+#ifdef WIN32
+        void* mFile = nullptr;
+        void* mMapping = nullptr;
+#endif
+    };
+
+    inline std::string_view MappedFile::data() const { return {mData, mSize}; }
+} // namespace ehb
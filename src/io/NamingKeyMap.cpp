@@ -137,41 +137,119 @@ namespace ehb
                 parseTree(keyMap, *stream);
             }
         }
-    }
 
-    std::string ehb::NamingKeyMap::findDataFile(const std::string& filename) const
-    {
-        std::string actualFileName = filename;
+        trie.assign(1, TrieNode{});
 
-        if (filename.find_first_of('/') == std::string::npos)
+        for (const auto& [key, directory] : keyMap)
         {
-            std::string resolvedFileName;
+            uint32_t node = 0;
 
-            for (std::string::size_type index = filename.rfind('_'); index != std::string::npos && index != 0; index = filename.rfind('_', index - 1))
+            for (char c : key)
             {
-                auto itr = keyMap.find(filename.substr(0, index));
+                auto& children = trie[node].children;
+                auto itr = std::lower_bound(children.begin(), children.end(), c, [](const auto& child, char c) { return child.first < c; });
 
-                if (itr != keyMap.end())
+                if (itr == children.end() || itr->first != c)
                 {
-                    resolvedFileName = itr->second + filename;
-                    break;
+                    // trie is grown below so the iterator can't be used after this
+                    const auto next = static_cast<uint32_t>(trie.size());
+
+                    children.emplace(itr, c, next);
+                    trie.emplace_back();
+
+                    node = next;
+                }
+                else
+                {
+                    node = itr->second;
                 }
             }
 
-            if (!resolvedFileName.empty())
+            trie[node].directory = &directory;
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        cache.clear();
+        previousCache.clear();
+    }
+
+    const std::string* NamingKeyMap::findDirectory(const std::string& filename) const
+    {
+        if (trie.empty()) { return nullptr; }
+
+        const std::string* directory = nullptr;
+        uint32_t node = 0;
+
+        // walking down once finds every key that is a prefix of the name, the last one that ends in front of a '_' wins
+        for (size_t index = 0; index < filename.size(); ++index)
+        {
+            if (filename[index] == '_' && index != 0 && trie[node].directory != nullptr) { directory = trie[node].directory; }
+
+            const auto& children = trie[node].children;
+            const auto itr = std::lower_bound(children.begin(), children.end(), filename[index], [](const auto& child, char c) { return child.first < c; });
+
+            if (itr == children.end() || itr->first != filename[index]) { break; }
+
+            node = itr->second;
+        }
+
+        return directory;
+    }
+
+    std::string NamingKeyMap::findDataFile(const std::string& filename) const
+    {
+        // only the art prefixes are ever resolved, anything else and full paths are handed back as they are
+        if (filename.find_first_of('/') != std::string::npos || filename.size() < 2 || filename[1] != '_') { return filename; }
+
+        if (const char prefix = filename[0]; prefix != 'a' && prefix != 'b' && prefix != 'm' && prefix != 't') { return filename; }
+
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+
+            if (const auto itr = cache.find(filename); itr != cache.end()) { return itr->second; }
+
+            if (auto itr = previousCache.find(filename); itr != previousCache.end())
             {
-                const std::string prefix = filename.substr(0, 2);
+                std::string actualFileName = std::move(itr->second);
 
-                if (prefix == "a_" || prefix == "b_" || prefix == "m_" || prefix == "t_")
-                {
-                    actualFileName.clear();
+                previousCache.erase(itr);
 
-                    actualFileName += "/art/";
-                    actualFileName += resolvedFileName;
+                if (cache.size() >= CacheCapacity)
+                {
+                    previousCache = std::move(cache);
+                    cache.clear();
                 }
+
+                return cache.emplace(filename, std::move(actualFileName)).first->second;
             }
         }
 
+        std::string actualFileName;
+
+        if (const std::string* directory = findDirectory(filename))
+        {
+            actualFileName.reserve(5 + directory->size() + filename.size());
+
+            actualFileName += "/art/";
+            actualFileName += *directory;
+            actualFileName += filename;
+        }
+        else
+        {
+            actualFileName = filename;
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        if (cache.size() >= CacheCapacity)
+        {
+            previousCache = std::move(cache);
+            cache.clear();
+        }
+
+        cache.emplace(filename, actualFileName);
+
         return actualFileName;
     }
 } // namespace ehb
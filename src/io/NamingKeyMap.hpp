@@ -1,8 +1,10 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <vsg/core/Inherit.h>
 #include <vsg/core/Object.h>
@@ -21,9 +23,30 @@ namespace ehb
 
         void init(IFileSys& fileSys);
 
+        //! safe to call from several threads at once, the loaders resolve their textures and meshes through it
         std::string findDataFile(const std::string& filename) const;
 
     private:
+        //! each generation of the cache holds at most this many names before it is aged out
+        static constexpr size_t CacheCapacity = 4096;
+
+        //! one node per character of the TREE keys, the children are kept sorted by character
+        struct TrieNode
+        {
+            std::vector<std::pair<char, uint32_t>> children;
+            const std::string* directory = nullptr; //! set when a key ends here
+        };
+
+        //! @return the directory of the longest key that is followed by a '_' in the filename
+        const std::string* findDirectory(const std::string& filename) const;
+
         std::unordered_map<std::string, std::string> keyMap;
+
+        std::vector<TrieNode> trie;
+
+        // names are looked up in the current generation and then the previous one, which is dropped once the current
+        // one fills up. that keeps the names still in use around without having to track the order of every lookup
+        mutable std::mutex cacheMutex;
+        mutable std::unordered_map<std::string, std::string> cache, previousCache;
     };
 } // namespace ehb
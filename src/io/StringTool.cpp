@@ -65,7 +65,7 @@ namespace ehb
             return elements;
         }
 
-        std::string convertToLowerCase(const std::string& str) noexcept
+        std::string convertToLowerCase(std::string_view str) noexcept
         {
             std::string lowcase_str(str);
             std::transform(lowcase_str.begin(), lowcase_str.end(), lowcase_str.begin(), ::tolower);
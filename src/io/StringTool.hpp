@@ -41,7 +41,7 @@ namespace ehb
         std::vector<std::string> split(std::string_view str, const char& separator) noexcept;
 
         // every time you assume characters are ascii - god kills a kitten
-        std::string convertToLowerCase(const std::string& str) noexcept;
+        std::string convertToLowerCase(std::string_view str) noexcept;
 
         std::string wideStringToStdString(const WideString& wStr);
 
@@ -6,6 +6,7 @@
 
 #include <vsg/io/FileSystem.h>
 
+#include <fstream>
 #include <sstream>
 
 // TODO: move or remove - legacy from: https://github.com/openscenegraph/OpenSceneGraph/blob/34a1d8bc9bba5c415c4ff590b3ea5229fa876ba8/src/osgDB/FileNameUtils.cpp#L86
@@ -107,6 +108,50 @@ namespace ehb
         return result;
     }
 
+    std::vector<SourceCrc> TankFileSys::gasSourceCrcs(const std::string& directory)
+    {
+        std::vector<SourceCrc> result;
+
+        for (const std::string& filename : cache)
+        {
+            if (vsg::lowerCaseFileExtension(filename) != ".gas" || filename.find(directory) != 0) { continue; }
+
+            // anything in the bits shadows the tanks so those files have to be read
+            if (bits)
+            {
+                if (std::ifstream stream(*bits / fs::path(filename.substr(1)), std::ios_base::binary); stream.is_open())
+                {
+                    std::ostringstream text;
+                    text << stream.rdbuf();
+
+                    const std::string data = text.str();
+
+                    result.push_back({filename, FuelCache::checksum(data), data.size()});
+
+                    continue;
+                }
+            }
+
+            // the first tank holding the file is the one it is read from, its index already knows the crc of every file
+            for (const auto& entry : eachTank)
+            {
+                if (const TankFile::FileEntry* file = entry->reader.findFile(filename))
+                {
+                    result.push_back({filename, file->crc32, file->size});
+
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    bool TankFileSys::isTankFileExtension(const fs::path& ext)
+    {
+        return ext == ".dsm" || ext == ".dsmap" || ext == ".dsmod" || ext == ".dsr" || ext == ".dsres";
+    }
+
     bool TankFileSys::init(IConfig& config)
     {
         log = spdlog::get("filesystem");
@@ -194,9 +239,7 @@ namespace ehb
             // TODO: this will crash if there is an empty directory
             for (const auto& entry : fs::directory_iterator(directory))
             {
-                const fs::path ext = entry.path().extension();
-
-                if (ext == ".dsm" || ext == ".dsmap" || ext == ".dsmod" || ext == ".dsr" || ext == ".dsres")
+                if (isTankFileExtension(entry.path().extension()))
                 {
                     const std::string fullFileName = entry.path().generic_string();
 
@@ -32,6 +32,12 @@ namespace ehb
         virtual FileList getFiles() const override;
         virtual FileList getDirectoryContents(const std::string& directory) const override;
 
+        //! files in the bits are read, files in the tanks use the crc and size of their index entry
+        virtual std::vector<SourceCrc> gasSourceCrcs(const std::string& directory) override;
+
+        //! @return whether the extension (including the leading '.') belongs to a tank file we know how to mount
+        static bool isTankFileExtension(const fs::path& ext);
+
     private:
         struct TankEntry
         {
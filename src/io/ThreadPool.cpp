@@ -0,0 +1,174 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace ehb
+{
+    namespace
+    {
+        //! shared with the pool as a task that hasn't started yet may only get to run once the job is over
+        struct Job
+        {
+            const std::function<void(unsigned int, size_t)>* work;
+            size_t count;
+
+            //! index 0 is kept for the calling thread
+            std::atomic<size_t> next = 1;
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            unsigned int started = 0;
+            unsigned int active = 0;
+            bool finished = false;
+            std::exception_ptr error;
+
+            void run(unsigned int thread, size_t index)
+            {
+                try
+                {
+                    for (; index < count; index = next++)
+                    {
+                        (*work)(thread, index);
+                    }
+                }
+                catch (...)
+                {
+                    next = count;
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) { error = std::current_exception(); }
+                }
+            }
+        };
+    } // namespace
+
+    ThreadPool& ThreadPool::instance()
+    {
+        // at least one worker so loading still overlaps with whatever the caller is doing on a single core
+        static ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+
+        return pool;
+    }
+
+    ThreadPool::ThreadPool(unsigned int workers)
+    {
+        for (unsigned int i = 0; i < workers; ++i)
+        {
+            threads.emplace_back(&ThreadPool::run, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_all();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+
+        condition.notify_one();
+    }
+
+    void ThreadPool::run()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+                if (tasks.empty()) { return; }
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    void parallelFor(size_t count, unsigned int threads, const std::function<void(unsigned int, size_t)>& work)
+    {
+        ThreadPool& pool = ThreadPool::instance();
+
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+        threads = static_cast<unsigned int>(std::min<size_t>({threads, count, pool.size() + 1}));
+
+        if (threads <= 1)
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                work(0, index);
+            }
+
+            return;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->work = &work;
+        job->count = count;
+
+        for (unsigned int i = 1; i < threads; ++i)
+        {
+            pool.submit([job]() {
+                unsigned int thread = 0;
+
+                {
+                    std::lock_guard<std::mutex> lock(job->mutex);
+
+                    // work is gone along with the caller by then
+                    if (job->finished) { return; }
+
+                    thread = ++job->started;
+                    ++job->active;
+                }
+
+                job->run(thread, job->next++);
+
+                {
+                    std::lock_guard<std::mutex> lock(job->mutex);
+                    --job->active;
+                }
+
+                job->condition.notify_all();
+            });
+        }
+
+        job->run(0, 0);
+
+        std::exception_ptr error;
+
+        {
+            std::unique_lock<std::mutex> lock(job->mutex);
+
+            job->finished = true;
+            job->condition.wait(lock, [&job]() { return job->active == 0; });
+
+            // taken out of the job, the last reference to it may go away on a pool thread
+            error = std::move(job->error);
+        }
+
+        if (error) { std::rethrow_exception(error); }
+    }
+} // namespace ehb
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ehb
+{
+    /**
+     * the worker threads shared by everything that loads in parallel. there is one of them per hardware thread
+     * besides the one a job is started from, so jobs started from inside of other jobs (the meshes of a region
+     * loading on a streamer thread) queue up behind each other instead of each spawning a full set of threads
+     */
+    class ThreadPool final
+    {
+    public:
+        static ThreadPool& instance();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool();
+
+        void submit(std::function<void()> task);
+
+        size_t size() const;
+
+    private:
+        explicit ThreadPool(unsigned int workers);
+
+        void run();
+
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+    };
+
+    /**
+     * call work(thread, index) for every index below count with up to threads of them running at once, thread is
+     * unique among the calls running at the same time and below threads. the calling thread takes part as thread 0
+     * and always gets index 0, so this never waits on the pool to get to it. once anything throws no further
+     * indices are handed out and the first exception is rethrown after every call that was already running has
+     * returned
+     * @param threads the most calls at once, 0 picks one per hardware thread
+     */
+    void parallelFor(size_t count, unsigned int threads, const std::function<void(unsigned int, size_t)>& work);
+
+    inline size_t ThreadPool::size() const { return threads.size(); }
+} // namespace ehb
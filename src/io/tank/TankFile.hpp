@@ -494,6 +494,10 @@ public:
 		// CRC32 of the extracted file is not computed if 'validateCRCs' is false.
 		ByteArray extractResourceToMemory(TankFile & tank, const std::string & resourcePath, bool validateCRCs) const;
 
+		// Index entry of a resource, null if the path isn't a file in this Tank.
+		// The size and CRC32 come straight from the index, nothing is extracted.
+		const FileEntry * findFile(const std::string & resourcePath) const;
+
 		// Directory and file lists for printing.
 		// NOTE: Lists are not sorted!
 		std::vector<std::string> getFileList() const;
@@ -520,6 +520,17 @@ ByteArray TankFile::Reader::extractResourceToMemory(TankFile & tank, const std::
 	return fileContents;
 }
 
+const TankFile::FileEntry * TankFile::Reader::findFile(const std::string & resourcePath) const
+{
+	const auto it = fileTable.find(resourcePath);
+	if (it == std::end(fileTable) || it->second.type != TankEntry::Type::TypeFile)
+	{
+		return nullptr;
+	}
+
+	return it->second.ptr.file;
+}
+
 std::vector<std::string> TankFile::Reader::getFileList() const
 {
 	std::vector<std::string> fileList;
@@ -11,7 +11,6 @@
 
 #include <vsg/utils/SharedObjects.h>
 
-#include <stdlib.h> // strtoul
 #include <spdlog/spdlog.h>
 
 namespace ehb
@@ -19,9 +18,10 @@ namespace ehb
     // hook into our virtual filesystem
     vsg::Path findFileCallback(const vsg::Path& filename, const vsg::Options* options)
     {
-        static auto namingKeyMap = options->getObject<NamingKeyMap>("NamingKeyMap");
+        // looked up every time as the options and the map they hold can be swapped out, e.g. when the content is reloaded
+        if (auto namingKeyMap = options ? options->getObject<NamingKeyMap>("NamingKeyMap") : nullptr) { return namingKeyMap->findDataFile(filename.string()); }
 
-        return namingKeyMap->findDataFile(filename.string());
+        return filename;
     }
 
     void InitState::enter()
@@ -47,6 +47,14 @@ namespace ehb
         // sanity check to stop errors from being thrown when using vsgExamples
         if (dsContentAvailable)
         {
+            // compiled gas documents are keyed by the crc of their source so the cache never has to be cleared by hand
+            if (const std::string& gasCache = config.getString("gas-cache"); !gasCache.empty())
+            {
+                log->info("using compiled gas cache at {}", gasCache);
+
+                fileSys.setGasCache(std::make_shared<FuelCache>(gasCache));
+            }
+
             namingKeyMap.init(fileSys);
 
             systems.worldMap = std::make_unique<WorldMap>(fileSys);
@@ -54,11 +62,12 @@ namespace ehb
             options->setObject("NamingKeyMap", &namingKeyMap);
 
             // setup the node database for our mesh guid to filename mappings
+            // the files are parsed in parallel but handed over in filename order so duplicate guids resolve the same way every run
             {
                 static const std::string directory = "/world/global/siege_nodes";
 
                 fileSys.eachGasFile(
-                    directory,
+                    directory, GasFileOrder::Sorted,
                     [this, &meshDatabase](const std::string& filename, auto doc) {
                         for (auto root : doc->eachChild())
                         {
@@ -66,7 +75,7 @@ namespace ehb
                             {
 
                                 // auto test = std::stoul(node->valueOf("guid"));
-                                auto guid = std::strtoul(node->valueOf("guid").c_str(), nullptr, 0);
+                                auto guid = node->valueAsGuid("guid");
                                 auto filename = stringtool::convertToLowerCase(node->valueOf("filename"));
 
                                 meshDatabase.InsertMeshMapping(guid, filename);
@@ -86,6 +95,7 @@ namespace ehb
 
             // accessed by the ReaderWriters to setup pipelines and layouts
             options->setObject("SiegeNodeGraphicsPipeline", readerWriterSNO->createOrShareGraphicsPipeline());
+            options->setObject("SiegeNodeInterleavedGraphicsPipeline", readerWriterSNO->createOrShareInterleavedGraphicsPipeline());
             options->setObject("SiegeNodeLayout", readerWriterSNO->createOrShareGraphicsPipeline()->pipeline->layout);
 
             options->readerWriters = {readerWriterRAW, readerWriterSNO, readerWriterASP, readerWriterSiegeNodeList, readerWriterRegion};
@@ -2,17 +2,14 @@
 #include "FullMapTestState.hpp"
 
 #include "Systems.hpp"
-#include "world/SiegeNode.hpp"
 #include "world/WorldMapData.hpp"
-#include "world/Region.hpp"
 
-#include <filesystem>
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 
-#include <vsg/io/read.h>
-#include <vsg/nodes/MatrixTransform.h>
 #include <vsg/nodes/StateGroup.h>
-#include <vsg/threading/OperationThreads.h>
+#include <vsg/viewer/ViewMatrix.h>
 
 namespace ehb
 {
@@ -21,11 +18,12 @@ namespace ehb
         log->info("Entered Region Test State");
 
         IFileSys& fileSys = systems.fileSys;
+        IConfig& config = systems.config;
         vsg::StateGroup& scene3d = *systems.scene3d;
         auto options = systems.options;
 
-        WorldMapDataCache worldMapDataCache;
-        worldMapDataCache.init(fileSys);
+        // the streamer holds on to the world data so it has to outlive this function
+        if (systems.worldMapData.data.empty()) { systems.worldMapData.init(fileSys); }
 
         vsg::ref_ptr<vsg::BindGraphicsPipeline> pipeline(options->getObject<vsg::BindGraphicsPipeline>("SiegeNodeGraphicsPipeline"));
 
@@ -38,123 +36,57 @@ namespace ehb
 
         scene3d.addChild(pipeline);
 
-        const auto& world = worldMapDataCache.data["multiplayer_world"];
+        auto& world = systems.worldMapData.data["multiplayer_world"];
         static std::string startingRegion = "town_center";
         auto targetRegionGuid = world.regionGuidFromName(startingRegion);
 
-        log->info("world will be assembled around the starting region {}:0x{:x}", startingRegion, targetRegionGuid);
-
-        // the below code is chunked out for easier modification
-        // we could probably do everything below in a single pass but that gets little complicated
+        log->info("world will be streamed in around the starting region {}:0x{:x}", startingRegion, targetRegionGuid);
 
-        // populated by the stitch data for the incoming region - we use a set to ensure uniqueness when looping
-        std::set<uint32_t> eachRegionGuidToLoad;
+        // only the regions around the camera are loaded, the rest are read in the background as it gets close to them
+        RegionStreamer::Settings settings;
+        settings.radius = config.getFloat("stream-radius", static_cast<float>(settings.radius));
+        settings.hops = static_cast<uint32_t>(std::max(0, config.getInt("stream-hops", static_cast<int>(settings.hops))));
+        settings.budget = static_cast<size_t>(std::max(0, config.getInt("stream-budget-mb", 0))) * 1024 * 1024;
 
-        // loop all available regions and load them into memory
-        for (const auto& [region, stitch] : world.stitchIndex.data)
+        // placing the whole world up front means a region never has to wait for a neighbour to be stitched onto
+        if (config.getBool("world-placement", false))
         {
-            for (const auto& stitch : world.stitchIndex.eachStitch(region))
-            {
-                eachRegionGuidToLoad.emplace(stitch.first);
-            }
-        }
+            worldPlacement = std::make_unique<WorldPlacement>();
 
-        // global map of all our nodes in the graph
-        std::unordered_map<uint32_t, vsg::ref_ptr<vsg::MatrixTransform>> eachNode;
-
-        // hold our loaded regions prior to adding them to the graph
-        std::unordered_map<uint32_t, vsg::ref_ptr<vsg::MatrixTransform>> loadedRegions;
-
-        vsg::ref_ptr<vsg::Options> threadedOptions(options);
-        threadedOptions->operationThreads = vsg::OperationThreads::create(2);
-
-        // loop and load our regions
-        // its important to use the set defined above as if we don't we will get duplicated regions for loading
-        vsg::Paths allRegionPaths;
-        for (const uint32_t regionGuid : eachRegionGuidToLoad)
-        {
-            auto r = world.regionNameAndPathFromRegionGuid(regionGuid).first;
-            allRegionPaths.emplace_back(r);
-        }
-
-        auto regions = vsg::read(allRegionPaths, threadedOptions);
-        for (auto& [path, region] : regions)
-        {
-            vsg::ref_ptr<Region> regionData(region->cast<Region>());
-            uint32_t guid = regionData->guid;
-
-            if (guid != 0)
-            {
-                for (auto [guid, node] : regionData->placedNodeXformMap)
-                {
-                    eachNode.emplace(guid, node);
-                }
-
-                // a region is just a group and not a transform
-                auto transform = vsg::MatrixTransform::create();
-                transform->children.push_back(regionData);
-
-                loadedRegions.emplace(guid, transform);
-            }
+            if (!worldPlacement->init(fileSys, world, options, targetRegionGuid)) { worldPlacement.reset(); }
             else
             {
-                log->critical("unable to retrieve guid for 0x{:x} - did the loader set it properly?", guid);
+                world.nodes.place(*worldPlacement);
             }
         }
 
-        log->info("{} regions are ready to be placed and rendered, we are also storing {} nodes in the global map", loadedRegions.size(), eachNode.size());
-
-        // a set to the already processed regions - maybe we can do a std::pair in a set with a loaded flag?
-        std::set<uint32_t> placedRegions;
-        placedRegions.emplace(targetRegionGuid);           // our starting region doesn't need processing
-        scene3d.addChild(loadedRegions[targetRegionGuid]); // make sure its in the graph
-
-        std::function<void(uint32_t guid)> recurse = [&, this](uint32_t guid) {
-            for (const auto& entry : world.stitchIndex.eachStitch(guid))
-            {
-                const uint32_t region2Guid = entry.first;
-                const auto& stitch = entry.second;
-
-                // quick check to ensure this region hasn't already been placed
-                if (placedRegions.count(region2Guid) == 0)
-                {
-                    vsg::ref_ptr<vsg::MatrixTransform> targetRegion = loadedRegions[guid];
-                    vsg::ref_ptr<vsg::MatrixTransform> region2Xform = loadedRegions[region2Guid];
-                    vsg::ref_ptr<vsg::MatrixTransform> node1Xform = eachNode[stitch.node1];
-                    vsg::ref_ptr<vsg::MatrixTransform> node2Xform = eachNode[stitch.node2];
-
-                    if (targetRegion == nullptr || region2Xform == nullptr || node1Xform == nullptr || node2Xform == nullptr)
-                    {
-                        log->critical("target region: 0x{:x}, region2xform: 0x{:x} or stitched nodes are null - you're hosed", guid, region2Guid);
-                    }
-
-                    if (world.regionForNode(stitch.node1) != guid) { log->critical("mismatch between stitch and guid"); }
-
-                    log->info("stitching region 0x{:x} to region 0x{:x}", region2Guid, guid);
+        streamer = std::make_unique<RegionStreamer>(world, options, systems.scene3d, settings, worldPlacement.get());
 
-                    // Hold onto ur butts.
-                    SiegeNode::connect(targetRegion, node1Xform, stitch.door1, region2Xform, node2Xform, stitch.door2);
-
-                    scene3d.addChild(region2Xform);
-
-                    placedRegions.emplace(region2Guid);
-
-                    recurse(region2Guid);
-                }
-                else
-                {
-                    // log->warn("already placed region, skipping");
-                }
-            }
-        };
+        if (!streamer->start(targetRegionGuid))
+        {
+            streamer.reset();
 
-        recurse(targetRegionGuid);
+            return;
+        }
 
         // workaround
         compile(systems, systems.scene3d);
     }
 
-    void FullMapTestState::leave() {}
+    void FullMapTestState::leave()
+    {
+        streamer.reset();
+        worldPlacement.reset();
+    }
 
-    void FullMapTestState::update(double deltaTime) {}
+    void FullMapTestState::update(double deltaTime)
+    {
+        if (streamer == nullptr) { return; }
+
+        if (auto lookAt = systems.camera->viewMatrix.cast<vsg::LookAt>())
+        {
+            // workaround
+            if (streamer->update(lookAt->eye, lookAt->center - lookAt->eye, deltaTime)) { compile(systems, systems.scene3d); }
+        }
+    }
 } // namespace ehb
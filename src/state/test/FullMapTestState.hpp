@@ -2,6 +2,10 @@
 #pragma once
 
 #include "state/IGameState.hpp"
+#include "world/RegionStreamer.hpp"
+#include "world/WorldPlacement.hpp"
+
+#include <memory>
 
 namespace ehb
 {
@@ -20,6 +24,9 @@ namespace ehb
 
     private:
         Systems& systems;
+
+        std::unique_ptr<WorldPlacement> worldPlacement;
+        std::unique_ptr<RegionStreamer> streamer;
     };
 
     inline FullMapTestState::FullMapTestState(Systems& systems) :
@@ -0,0 +1,273 @@
+// checks that the hand written fuel parser builds the same trees as the bison one
+//
+// usage: siege-fuel-check [<file.gas | directory>...] [--ds-install-path <path>] [--bits <path>] [--iterations <n>]
+//
+// a set of built in cases covering the odd corners of the grammar (comments inside expressions, embedded
+// statements, error recovery, ...) is always checked. on top of that every .gas file in the given files or
+// directories and, when --ds-install-path or --bits is passed, every .gas file of the game content is parsed
+// with both parsers and the resulting trees are compared, along with the tree of a lazy parse once all of it has
+// been expanded. the throughput of both parsers is reported at the end
+
+#include "cfg/WritableConfig.hpp"
+#include "gas/Fuel.hpp"
+#include "io/LocalFileSys.hpp"
+#include "io/TankFileSys.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <vsg/utils/CommandLine.h>
+
+namespace ehb
+{
+    namespace tools
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // each of these has tripped up a gas parser at some point
+        const char* const builtinCases[] = {
+            "",
+            "[a]{}",
+            "[t:template,n:actor]{ doc = \"some actor\"; i health = 10; }",
+            "[dev,t:template,n:actor]{ specializes = base; }",
+            "[a]{ [b]{ [c]{ x = 1; } } y = 2; }",
+            "[a]{ b:c:d = 1; e : f = 2; g h:i = 3; }",
+            "[a]{ x = 1 // trailing comment\n; y = // leading comment\n 2; z = 3 // one\n + 4 // two\n; }",
+            "[a]{ x = [[ a; b; // comment ]]\n ]]; y = [[]]; z = [ [ not embedded ]; }",
+            "[a]{ x = \"a;b//c[[d\"; y = \"\"; z = \" padded \"; }",
+            "[a]{ x = a/b; y = /; z = ; w =; }",
+            "// comment\n/* block */[a]/* between */{ /* in */ x = 1; }",
+            "/* stars **/ [a]{} /* more */ [b]{}",
+            "/* odd ***/ [a]{}",
+            "[a]\r\n{\r\n\tx = 1;\r\n\ty = two words ;\r\n}\r\n",
+            "[t:window;n:rollover_console]{ x = 1; }",
+            "[a]{ x = 1; } [a]{ y = 2; } [a:b]{ z = 3; }",
+            "[a] rogue { x = 1; }",
+            "[a] = junk; { x = 1; }",
+            "[a]{ x = 1; [b { y = 2; } z = 3; }",
+            "[a]{ [b]{ x y z = 1; } w = 2; }",
+            "[a]{ [b:c]{ x = 1; } } }",
+            "[a]{ x = 1; ] y = 2; }",
+            "[a]{ x = 1; }}",
+            "[a]{ x = 1;",
+            "[a]{ x @ 1; }",
+            "x = 1; [a]{} y = 2;",
+            "[a]{} = 1",
+            "= 1",
+            "[a]{} x = 1",
+            "[a]{ f x = 1.5; i y = -2; x z = 0x10; b w = true; }",
+            "[a]{ /* x",
+            "[a]{} /* x *",
+        };
+
+        void dump(std::ostream& stream, const FuelBlock* node, size_t level = 0)
+        {
+            const std::string indent(level * 2, ' ');
+
+            stream << indent << "[" << node->type() << "|" << node->name() << "]\n";
+
+            for (const auto& attr : node->eachAttribute())
+            {
+                stream << indent << "  " << attr.type << "|" << attr.name << " = <" << attr.value << ">\n";
+            }
+
+            for (const FuelBlock* child : node->eachChild())
+            {
+                dump(stream, child, level + 1);
+            }
+        }
+
+        struct Stats
+        {
+            size_t inputs = 0;
+            size_t mismatches = 0;
+            size_t bytes = 0;
+            size_t bytesParsed = 0;
+            double bisonSeconds = 0;
+            double descentSeconds = 0;
+        };
+
+        struct Outcome
+        {
+            bool result;
+            std::string tree;
+        };
+
+        Outcome run(const std::string& text, Fuel::Parser parser, unsigned int iterations, double& seconds)
+        {
+            Outcome outcome;
+
+            // the first iteration is kept for the comparison, any further ones are only timed
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                Fuel doc;
+                std::string copy = text;
+
+                const auto start = Clock::now();
+                const bool result = doc.parse(std::move(copy), parser);
+                seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+                if (i == 0)
+                {
+                    std::ostringstream stream;
+                    dump(stream, &doc);
+
+                    outcome = {result, stream.str()};
+                }
+            }
+
+            return outcome;
+        }
+
+        void check(const std::string& label, const std::string& text, unsigned int iterations, Stats& stats)
+        {
+            ++stats.inputs;
+            stats.bytes += text.size();
+            stats.bytesParsed += text.size() * iterations;
+
+            const Outcome bison = run(text, Fuel::Parser::Bison, iterations, stats.bisonSeconds);
+            const Outcome descent = run(text, Fuel::Parser::Descent, iterations, stats.descentSeconds);
+
+            auto log = spdlog::get("log");
+
+            {
+                Fuel doc;
+                const bool result = doc.parseLazy(text);
+
+                std::ostringstream stream;
+                dump(stream, &doc);
+
+                if (result != descent.result || stream.str() != descent.tree)
+                {
+                    ++stats.mismatches;
+
+                    log->error("{}: the lazily parsed tree doesn't match", label);
+                }
+            }
+
+            if (bison.result == descent.result && bison.tree == descent.tree) { return; }
+
+            ++stats.mismatches;
+
+            if (bison.result != descent.result) { log->error("{}: bison returned {}, descent returned {}", label, bison.result, descent.result); }
+
+            std::istringstream lhs(bison.tree), rhs(descent.tree);
+
+            for (size_t line = 1;; ++line)
+            {
+                std::string a, b;
+
+                const bool moreA = static_cast<bool>(std::getline(lhs, a));
+                const bool moreB = static_cast<bool>(std::getline(rhs, b));
+
+                if (!moreA && !moreB) { break; }
+
+                if (a != b)
+                {
+                    log->error("{}: trees differ at line {}\n  bison:   {}\n  descent: {}", label, line, a, b);
+
+                    break;
+                }
+            }
+        }
+
+        std::string readAll(std::istream& stream) { return std::string(std::istreambuf_iterator<char>(stream), {}); }
+    } // namespace tools
+} // namespace ehb
+
+int main(int argc, char* argv[])
+{
+    using namespace ehb;
+    using namespace ehb::tools;
+
+    auto log = spdlog::stdout_color_mt("log");
+    spdlog::stdout_color_mt("filesystem")->set_level(spdlog::level::warn);
+
+    std::string installPath, bitsPath;
+    unsigned int iterations = 1;
+
+    vsg::CommandLine args(&argc, argv);
+    args.read("--ds-install-path", installPath);
+    args.read("--bits", bitsPath);
+    args.read("--iterations", iterations);
+
+    iterations = std::max(1u, iterations);
+
+    Stats stats;
+
+    for (size_t i = 0; i < std::size(builtinCases); ++i)
+    {
+        check("builtin case " + std::to_string(i), builtinCases[i], 1, stats);
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::filesystem::path input(argv[i]);
+
+        const auto checkFile = [&](const std::filesystem::path& path) {
+            std::ifstream stream(path, std::ios::binary);
+
+            check(path.string(), readAll(stream), iterations, stats);
+        };
+
+        if (std::filesystem::is_directory(input))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".gas") { checkFile(entry.path()); }
+            }
+        }
+        else
+        {
+            checkFile(input);
+        }
+    }
+
+    const auto checkFileSys = [&](IFileSys& fileSys, WritableConfig& config) {
+        if (!fileSys.init(config))
+        {
+            log->error("unable to initialize the filesystem");
+
+            return;
+        }
+
+        for (const auto& filename : fileSys.getFiles())
+        {
+            if (std::filesystem::path(filename).extension() != ".gas") { continue; }
+
+            if (auto stream = fileSys.createInputStream(filename)) { check(filename, readAll(*stream), iterations, stats); }
+        }
+    };
+
+    if (!installPath.empty())
+    {
+        WritableConfig config;
+        config.setString("ds-install-path", installPath);
+
+        TankFileSys fileSys;
+        checkFileSys(fileSys, config);
+    }
+
+    if (!bitsPath.empty())
+    {
+        WritableConfig config;
+        config.setString("bits", bitsPath);
+
+        LocalFileSys fileSys;
+        checkFileSys(fileSys, config);
+    }
+
+    const double megabytes = stats.bytesParsed / (1024.0 * 1024.0);
+
+    log->info("checked {} inputs ({:.2f} MB), {} mismatches", stats.inputs, stats.bytes / (1024.0 * 1024.0), stats.mismatches);
+    log->info("bison: {:.3f} ms ({:.1f} MB/s), descent: {:.3f} ms ({:.1f} MB/s)", stats.bisonSeconds * 1000.0, megabytes / std::max(stats.bisonSeconds, 1e-9),
+              stats.descentSeconds * 1000.0, megabytes / std::max(stats.descentSeconds, 1e-9));
+
+    return stats.mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+// compiles gas text into the binary .gasb format
+//
+// usage: siege-gasc <file.gas | directory> [--output <directory>] [--verify]
+//
+// every .gas file found is compiled to a .gasb next to it (or below --output, mirroring the input
+// layout). --verify loads the compiled document back and compares it against the parsed one. the
+// time spent parsing the text and loading the binaries is reported at the end
+
+#include "gas/Fuel.hpp"
+
+#include "miniz.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <vsg/utils/CommandLine.h>
+
+namespace ehb
+{
+    namespace tools
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Totals
+        {
+            size_t files = 0;
+            size_t failed = 0;
+            size_t textBytes = 0;
+            size_t binaryBytes = 0;
+            double parseSeconds = 0;
+            double loadSeconds = 0;
+        };
+
+        //! documents are equal when the text they write out is
+        std::string dump(const Fuel& doc)
+        {
+            std::ostringstream stream;
+            doc.save(stream);
+
+            return stream.str();
+        }
+
+        bool compile(const std::filesystem::path& input, const std::filesystem::path& output, bool verify, Totals& totals)
+        {
+            auto log = spdlog::get("log");
+
+            std::ifstream stream(input, std::ios::binary);
+            std::string text(std::istreambuf_iterator<char>(stream), {});
+
+            const auto crc = static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(text.data()), text.size()));
+
+            totals.textBytes += text.size();
+
+            Fuel doc;
+
+            const auto parseStart = Clock::now();
+            const bool parsed = doc.parse(std::move(text));
+            totals.parseSeconds += std::chrono::duration<double>(Clock::now() - parseStart).count();
+
+            if (!parsed)
+            {
+                log->error("{}: could not parse", input.string());
+
+                return false;
+            }
+
+            std::filesystem::create_directories(output.parent_path());
+
+            if (std::ofstream out(output, std::ios::binary); !out || !doc.saveBinary(out, crc))
+            {
+                log->error("{}: could not write {}", input.string(), output.string());
+
+                return false;
+            }
+
+            totals.binaryBytes += std::filesystem::file_size(output);
+
+            Fuel compiled;
+
+            const auto loadStart = Clock::now();
+            const bool loaded = compiled.loadBinary(output.string());
+            totals.loadSeconds += std::chrono::duration<double>(Clock::now() - loadStart).count();
+
+            if (!loaded)
+            {
+                log->error("{}: could not load the compiled document back", output.string());
+
+                return false;
+            }
+
+            if (verify && dump(doc) != dump(compiled))
+            {
+                log->error("{}: compiled document doesn't match the source", input.string());
+
+                return false;
+            }
+
+            return true;
+        }
+    } // namespace tools
+} // namespace ehb
+
+int main(int argc, char* argv[])
+{
+    using namespace ehb;
+    using namespace ehb::tools;
+
+    auto log = spdlog::stdout_color_mt("log");
+
+    std::string output;
+    bool verify = false;
+
+    vsg::CommandLine args(&argc, argv);
+    args.read("--output", output);
+    verify = args.read("--verify");
+
+    if (argc != 2)
+    {
+        log->error("usage: siege-gasc <file.gas | directory> [--output <directory>] [--verify]");
+
+        return 1;
+    }
+
+    const std::filesystem::path input(argv[1]);
+    const std::filesystem::path base = std::filesystem::is_directory(input) ? input : input.parent_path();
+
+    const auto target = [&](const std::filesystem::path& path) {
+        std::filesystem::path result = output.empty() ? path : std::filesystem::path(output) / std::filesystem::relative(path, base);
+
+        return result.replace_extension(".gasb");
+    };
+
+    Totals totals;
+
+    const auto process = [&](const std::filesystem::path& path) {
+        ++totals.files;
+
+        if (!compile(path, target(path), verify, totals)) { ++totals.failed; }
+    };
+
+    if (std::filesystem::is_directory(input))
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".gas") { process(entry.path()); }
+        }
+    }
+    else
+    {
+        process(input);
+    }
+
+    log->info("compiled {} of {} files, {} bytes of text into {} bytes", totals.files - totals.failed, totals.files, totals.textBytes, totals.binaryBytes);
+    log->info("parsing text took {:.3f} ms, loading binaries took {:.3f} ms", totals.parseSeconds * 1000.0, totals.loadSeconds * 1000.0);
+
+    return totals.failed == 0 ? 0 : 1;
+}
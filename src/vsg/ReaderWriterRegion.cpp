@@ -59,11 +59,11 @@ namespace ehb
 
     vsg::ref_ptr<vsg::Object> ReaderWriterRegion::read(std::istream& stream, vsg::ref_ptr<const vsg::Options> options) const
     {
-        if (Fuel doc; doc.load(stream))
+        if (auto doc = fileSys.readGasFile(stream))
         {
             auto region = Region::create();
 
-            region->guid = doc.valueAsUInt("region:guid");
+            region->guid = doc->valueAsGuid("region:guid");
 
             return region;
         }
@@ -5,6 +5,8 @@
 #include "io/LocalFileSys.hpp"
 #include "world/SiegeNode.hpp"
 
+#include <cstddef>
+
 #include <vsg/io/read.h>
 
 #include <vsg/state/ColorBlendState.h>
@@ -87,17 +89,9 @@ namespace ehb
     {
         BinaryReader reader(stream);
 
-        // prefer auto since the template provides the type and it's easier to change if we have to
-
-        auto header = reader.read<SiegeMeshHeader>();
-
-        if (header.m_majorVersion > 6 ||
-            (header.m_majorVersion == 6 && header.m_minorVersion >= 2))
-        {
-            uint32_t checksum = reader.read<uint32_t>();
-        }
+        SiegeMeshHeader header;
 
-        if (header.m_id != SNO_MAGIC) return {};
+        if (!readHeader(reader, header)) return {};
 
         // Construct our vsg::Group for the graph
         vsg::ref_ptr<SiegeNode> group = SiegeNode::create();
@@ -113,6 +107,36 @@ namespace ehb
         return group;
     };
 
+    bool ReaderWriterSiegeMesh::readDoors(std::istream& stream, SiegeMesh::SiegeMeshDoorList& doors, SiegeMeshHeader* header)
+    {
+        BinaryReader reader(stream);
+
+        SiegeMeshHeader local;
+
+        if (header == nullptr) { header = &local; }
+
+        if (!readHeader(reader, *header)) return false;
+
+        doors = SiegeMesh::readDoors(reader, *header);
+
+        return true;
+    }
+
+    bool ReaderWriterSiegeMesh::readHeader(BinaryReader& reader, SiegeMeshHeader& header)
+    {
+        // prefer auto since the template provides the type and it's easier to change if we have to
+
+        header = reader.read<SiegeMeshHeader>();
+
+        if (header.m_majorVersion > 6 ||
+            (header.m_majorVersion == 6 && header.m_minorVersion >= 2))
+        {
+            uint32_t checksum = reader.read<uint32_t>();
+        }
+
+        return header.m_id == SNO_MAGIC;
+    }
+
     vsg::ref_ptr<vsg::BindGraphicsPipeline> ReaderWriterSiegeMesh::createOrShareGraphicsPipeline()
     {
         if (!bindGraphicsPipeline)
@@ -155,8 +179,33 @@ namespace ehb
             auto pipelineLayout = vsg::PipelineLayout::create(descriptorSetLayouts, pushConstantRanges);
             auto graphicsPipeline = vsg::GraphicsPipeline::create(pipelineLayout, vsg::ShaderStages{vertexShader, fragmentShader}, pipelineStates);
             bindGraphicsPipeline = vsg::BindGraphicsPipeline::create(graphicsPipeline);
+
+            // siege nodes hand over their vertices as one buffer of sVertex, the layout is shared so the descriptor
+            // sets bound against it work with either pipeline
+            vsg::VertexInputState::Bindings interleavedBindingsDescriptions{
+                VkVertexInputBindingDescription{0, sizeof(sVertex), VK_VERTEX_INPUT_RATE_VERTEX} // position, colour and tex coord
+            };
+
+            vsg::VertexInputState::Attributes interleavedAttributeDescriptions{
+                VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(sVertex, x)},     // vertex data
+                VkVertexInputAttributeDescription{1, 0, VK_FORMAT_B8G8R8A8_UNORM, offsetof(sVertex, color)},   // colour data, stored as argb
+                VkVertexInputAttributeDescription{2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(sVertex, uv)},       // tex coord data
+            };
+
+            vsg::GraphicsPipelineStates interleavedPipelineStates = pipelineStates;
+            interleavedPipelineStates[0] = vsg::VertexInputState::create(interleavedBindingsDescriptions, interleavedAttributeDescriptions);
+
+            auto interleavedGraphicsPipeline = vsg::GraphicsPipeline::create(pipelineLayout, vsg::ShaderStages{vertexShader, fragmentShader}, interleavedPipelineStates);
+            bindInterleavedGraphicsPipeline = vsg::BindGraphicsPipeline::create(interleavedGraphicsPipeline);
         }
 
         return bindGraphicsPipeline;
     }
+
+    vsg::ref_ptr<vsg::BindGraphicsPipeline> ReaderWriterSiegeMesh::createOrShareInterleavedGraphicsPipeline()
+    {
+        createOrShareGraphicsPipeline();
+
+        return bindInterleavedGraphicsPipeline;
+    }
 } // namespace ehb
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include "world/SiegeMesh.hpp"
+
 namespace ehb
 {
     class IFileSys;
@@ -21,10 +23,19 @@ namespace ehb
 
         vsg::ref_ptr<vsg::BindGraphicsPipeline> createOrShareGraphicsPipeline();
 
+        //! the same pipeline taking a single interleaved buffer of sVertex, which is what siege nodes are drawn with
+        vsg::ref_ptr<vsg::BindGraphicsPipeline> createOrShareInterleavedGraphicsPipeline();
+
+        //! only read the doors of a mesh, for placing nodes without loading them. the header is handed back if asked for
+        static bool readDoors(std::istream& stream, SiegeMesh::SiegeMeshDoorList& doors, SiegeMeshHeader* header = nullptr);
+
     private:
+        static bool readHeader(BinaryReader& reader, SiegeMeshHeader& header);
+
         IFileSys& fileSys;
 
         vsg::ref_ptr<vsg::BindGraphicsPipeline> bindGraphicsPipeline;
+        vsg::ref_ptr<vsg::BindGraphicsPipeline> bindInterleavedGraphicsPipeline;
 
         std::shared_ptr<spdlog::logger> log;
     };
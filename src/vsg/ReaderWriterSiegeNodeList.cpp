@@ -2,12 +2,16 @@
 #include "ReaderWriterSiegeNodeList.hpp"
 #include "io/IFileSys.hpp"
 #include "io/StringTool.hpp"
+#include "io/ThreadPool.hpp"
 #include "vsg/ReaderWriterSiegeMesh.hpp"
-#include "world/SiegeNode.hpp"
 #include "world/MeshDatabase.hpp"
+#include "world/PlacementSolver.hpp"
+#include "world/SiegeNode.hpp"
+
+#include <algorithm>
+#include <unordered_set>
 
 #include <vsg/io/read.h>
-#include <vsg/utils/SharedObjects.h>
 
 namespace ehb
 {
@@ -33,7 +37,15 @@ namespace ehb
 
     vsg::ref_ptr<vsg::Object> ReaderWriterSiegeNodeList::read(std::istream& stream, vsg::ref_ptr<const vsg::Options> options) const
     {
-        static auto meshDatabase = options->getObject<MeshDatabase>("MeshDatabase");
+        // these are looked up for every node of every region so split and hash them once
+        static const struct
+        {
+            FuelPath siegeNodeList{"siege_node_list"}, targetNode{"siege_node_list:targetnode"};
+            FuelPath guid{"guid"}, meshGuid{"mesh_guid"}, texSetAbbr{"texsetabbr"};
+            FuelPath id{"id"}, farDoor{"fardoor"}, farGuid{"farguid"};
+            FuelPath boundsCamera{"bounds_camera"}, cameraFade{"camera_fade"}, nodeLevel{"nodelevel"}, nodeObject{"nodeobject"};
+            FuelPath nodeSection{"nodesection"}, occludesCamera{"occludes_camera"}, occludesLight{"occludes_light"};
+        } keys;
 
         struct DoorEntry
         {
@@ -44,20 +56,37 @@ namespace ehb
 
         std::unordered_multimap<uint32_t, DoorEntry> doorMap;
         std::unordered_map<uint32_t, vsg::MatrixTransform*> nodeMap;
-        std::set<uint32_t> completeSet;
 
-        if (Fuel doc; doc.load(stream))
+        // nodes sharing a mesh share its doors in the solver
+        PlacementSolver solver;
+        std::unordered_map<const SiegeMesh*, uint32_t> meshIndex;
+
+        if (auto doc = fileSys.readGasFile(stream))
         {
             auto group = vsg::Group::create();
 
-            for (const auto node : doc.eachChildOf("siege_node_list"))
+            // a mesh is usually used by a lot of nodes so the unique ones are read first and only once
+            std::vector<uint32_t> meshGuids;
+
+            {
+                std::unordered_set<uint32_t> seen;
+
+                for (const auto node : doc->eachChildOf(keys.siegeNodeList))
+                {
+                    if (const uint32_t meshGuid = node->valueAsGuid(keys.meshGuid); seen.insert(meshGuid).second) { meshGuids.push_back(meshGuid); }
+                }
+            }
+
+            const auto meshes = loadMeshes(meshGuids, options);
+
+            for (const auto node : doc->eachChildOf(keys.siegeNodeList))
             {
-                const uint32_t nodeGuid = node->valueAsUInt("guid");
+                const uint32_t nodeGuid = node->valueAsGuid(keys.guid);
                 // const uint64_t meshGuid = node->valueAsUInt("mesh_guid");
                 // const std::string meshGuid = stringtool::convertToLowerCase(node->valueOf("mesh_guid"));
-                const auto meshGuid = std::strtoul(stringtool::convertToLowerCase(node->valueOf("mesh_guid")).c_str(), nullptr, 0);
+                const uint32_t meshGuid = node->valueAsGuid(keys.meshGuid);
 
-                const std::string& texSetAbbr = node->valueOf("texsetabbr");
+                const std::string_view texSetAbbr = node->valueOf(keys.texSetAbbr);
 
                 // log->info("nodeGuid: {}, meshGuid: {}, texSetAbbr: '{}'", nodeGuid, meshGuid, texSetAbbr);
 
@@ -65,62 +94,62 @@ namespace ehb
                 {
                     DoorEntry e;
 
-                    e.id = child->valueAsInt("id");
-                    e.farDoor = child->valueAsInt("fardoor");
+                    e.id = child->valueAsInt(keys.id);
+                    e.farDoor = child->valueAsInt(keys.farDoor);
                     // NOTE: explicitly not using valueAsUInt because of 64bit value
-                    e.farGuid = std::stoul(child->valueOf("farguid"), nullptr, 16);
+                    e.farGuid = child->valueAsGuid(keys.farGuid);
 
                     doorMap.emplace(nodeGuid, std::move(e));
                 }
 
-                auto meshFileName = meshDatabase->FindFileName(meshGuid);
-
-                if (auto mesh = vsg::read_cast<SiegeNode>(meshFileName, options); mesh != nullptr)
+                if (const auto itr = meshes.find(meshGuid); itr != meshes.end() && itr->second != nullptr)
                 {
-                    options->sharedObjects->share(mesh);
+                    const auto& mesh = itr->second;
 
                     auto xform = vsg::MatrixTransform::create();
 
-                    xform->setValue("bounds_camera", node->valueAsBool("bounds_camera"));
-                    xform->setValue("camera_fade", node->valueAsBool("camera_fade"));
-                    xform->setValue<uint32_t>("guid", node->valueAsUInt("guid"));
-                    xform->setValue<uint32_t>("nodelevel", node->valueAsUInt("nodelevel"));
-                    xform->setValue<uint32_t>("nodeobject", node->valueAsUInt("nodeobject"));
-                    xform->setValue<uint32_t>("nodesection", node->valueAsUInt("nodesection"));
-                    xform->setValue("occludes_camera", node->valueAsBool("occludes_camera"));
-                    xform->setValue("occludes_light", node->valueAsBool("occludes_light"));
+                    xform->setValue("bounds_camera", node->valueAsBool(keys.boundsCamera));
+                    xform->setValue("camera_fade", node->valueAsBool(keys.cameraFade));
+                    xform->setValue<uint32_t>("guid", nodeGuid);
+                    xform->setValue<uint32_t>("nodelevel", node->valueAsUInt(keys.nodeLevel));
+                    xform->setValue<uint32_t>("nodeobject", node->valueAsUInt(keys.nodeObject));
+                    xform->setValue<uint32_t>("nodesection", node->valueAsUInt(keys.nodeSection));
+                    xform->setValue("occludes_camera", node->valueAsBool(keys.occludesCamera));
+                    xform->setValue("occludes_light", node->valueAsBool(keys.occludesLight));
 
                     group->addChild(xform);
                     xform->addChild(mesh);
 
                     nodeMap.emplace(nodeGuid, xform);
+
+                    auto [itr, inserted] = meshIndex.emplace(mesh->mesh(), 0);
+                    if (inserted) { itr->second = solver.addMesh(mesh->mesh()->doors()); }
+
+                    solver.addNode(nodeGuid, itr->second);
                 }
             }
 
             // now position it all
-            const uint32_t targetGuid = doc.valueAsUInt("siege_node_list:targetnode");
+            const uint32_t targetGuid = doc->valueAsGuid(keys.targetNode);
 
-            std::function<void(const uint32_t)> func;
-
-            func = [&func, &doorMap, &nodeMap, &completeSet](const uint32_t guid) {
-                if (completeSet.insert(guid).second)
-                {
-                    auto targetNode = nodeMap[guid];
-
-                    const auto range = doorMap.equal_range(guid);
+            for (const auto& [guid, entry] : doorMap)
+            {
+                solver.addConnection(guid, entry.id, entry.farGuid, entry.farDoor);
+            }
 
-                    for (auto entry = range.first; entry != range.second; ++entry)
-                    {
-                        auto connectNode = nodeMap[entry->second.farGuid];
+            const size_t placed = solver.solve(targetGuid);
 
-                        SiegeNode::connect(targetNode, entry->second.id, connectNode, entry->second.farDoor);
+            for (const auto& [guid, xform] : nodeMap)
+            {
+                if (auto transform = solver.transform(guid)) { xform->matrix = *transform; }
+            }
 
-                        if (completeSet.count(entry->second.farGuid) == 0) { func(entry->second.farGuid); }
-                    }
-                }
-            };
+            if (placed != nodeMap.size()) { log->warn("only {} of the {} nodes of the region could be reached from 0x{:x}", placed, nodeMap.size(), targetGuid); }
 
-            func(targetGuid);
+            for (const auto& cycle : solver.inconsistencies())
+            {
+                log->warn("nodes 0x{:x} and 0x{:x} don't line up through their doors, off by {} and {} in rotation", cycle.node1, cycle.node2, cycle.distance, cycle.rotation);
+            }
 
             log->debug("region loaded with {} nodes, targetGuid: 0x{:x}", group->children.size(), targetGuid);
 
@@ -129,4 +158,72 @@ namespace ehb
 
         return {};
     };
+
+    std::unordered_map<uint32_t, vsg::ref_ptr<SiegeNode>> ReaderWriterSiegeNodeList::loadMeshes(const std::vector<uint32_t>& meshGuids, vsg::ref_ptr<const vsg::Options> options) const
+    {
+        std::unordered_map<uint32_t, vsg::ref_ptr<SiegeNode>> meshes;
+
+        // looked up every time like the naming key map, the options can be swapped out when the content is reloaded
+        auto meshDatabase = options ? options->getObject<MeshDatabase>("MeshDatabase") : nullptr;
+
+        if (meshDatabase == nullptr)
+        {
+            log->error("the MeshDatabase isn't set on the options, none of the {} meshes can be found", meshGuids.size());
+
+            return meshes;
+        }
+
+        std::vector<vsg::ref_ptr<SiegeNode>> loaded(meshGuids.size());
+
+        // the streamer already reads several regions at once, going through the shared pool keeps the meshes of all of them from asking for a thread each
+        parallelFor(meshGuids.size(), 0, [&](unsigned int, size_t index) { loaded[index] = loadMesh(meshGuids[index], *meshDatabase, options); });
+
+        for (size_t index = 0; index < meshGuids.size(); ++index)
+        {
+            meshes.emplace(meshGuids[index], std::move(loaded[index]));
+        }
+
+        return meshes;
+    }
+
+    vsg::ref_ptr<SiegeNode> ReaderWriterSiegeNodeList::loadMesh(uint32_t meshGuid, const MeshDatabase& meshDatabase, vsg::ref_ptr<const vsg::Options> options) const
+    {
+        MeshSlot* slot = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(meshCacheMutex);
+
+            auto& entry = meshCache[meshGuid];
+            if (entry == nullptr) { entry = std::make_unique<MeshSlot>(); }
+
+            slot = entry.get();
+        }
+
+        // only this mesh is locked, the other ones keep loading
+        std::lock_guard<std::mutex> lock(slot->mutex);
+
+        if (auto mesh = slot->node.ref_ptr()) { return mesh; }
+
+        auto meshFileName = meshDatabase.FindFileName(meshGuid);
+
+        if (meshFileName == nullptr)
+        {
+            log->error("mesh 0x{:x} isn't in the mesh database", meshGuid);
+
+            return {};
+        }
+
+        auto mesh = vsg::read_cast<SiegeNode>(meshFileName, options);
+
+        if (mesh == nullptr)
+        {
+            log->error("unable to read mesh 0x{:x} from {}", meshGuid, meshFileName);
+
+            return {};
+        }
+
+        slot->node = mesh;
+
+        return mesh;
+    }
 } // namespace ehb
@@ -2,13 +2,22 @@
 #pragma once
 
 #include "io/NamingKeyMap.hpp"
+#include <vsg/core/observer_ptr.h>
 #include <vsg/io/ReaderWriter.h>
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <spdlog/spdlog.h>
 
 namespace ehb
 {
     class IFileSys;
+    class MeshDatabase;
+    class SiegeNode;
+
     class ReaderWriterSiegeNodeList final : public vsg::Inherit<vsg::ReaderWriter, ReaderWriterSiegeNodeList>
     {
     public:
@@ -18,8 +27,24 @@ namespace ehb
         virtual vsg::ref_ptr<vsg::Object> read(std::istream& stream, vsg::ref_ptr<const vsg::Options> = {}) const override;
 
     private:
+        //! one per mesh guid, it only observes the mesh so the mesh goes away with the last region that uses it
+        struct MeshSlot
+        {
+            std::mutex mutex;
+            vsg::observer_ptr<SiegeNode> node;
+        };
+
+        //! read every mesh once, spread over the shared thread pool
+        std::unordered_map<uint32_t, vsg::ref_ptr<SiegeNode>> loadMeshes(const std::vector<uint32_t>& meshGuids, vsg::ref_ptr<const vsg::Options> options) const;
+
+        //! @return the mesh if any region still holds it, otherwise it is read. other regions asking for it at the same time wait for it
+        vsg::ref_ptr<SiegeNode> loadMesh(uint32_t meshGuid, const MeshDatabase& meshDatabase, vsg::ref_ptr<const vsg::Options> options) const;
+
         IFileSys& fileSys;
 
+        mutable std::mutex meshCacheMutex;
+        mutable std::unordered_map<uint32_t, std::unique_ptr<MeshSlot>> meshCache;
+
         std::shared_ptr<spdlog::logger> log;
     };
 
@@ -1,7 +1,7 @@
 
 #include "DatabaseGuid.hpp"
 
-#include "DatabaseGuid.hpp"
+#include "gas/FuelNumeric.hpp"
 
 namespace ehb
 {
@@ -29,7 +29,13 @@ namespace ehb
 
     bool DatabaseGuid::fromString(const char* str)
     {
-        return false;
+        uint32_t guid = 0;
+
+        if (str == nullptr || numeric::parseGuid(str, guid) != numeric::ParseError::None) { return false; }
+
+        setValue(guid);
+
+        return true;
     }
 } // namespace ehb
 
@@ -0,0 +1,405 @@
+#include "NodeBVH.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace ehb
+{
+    namespace
+    {
+        inline vsg::dbox merge(const vsg::dbox& a, const vsg::dbox& b)
+        {
+            return vsg::dbox(vsg::dvec3(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)),
+                             vsg::dvec3(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)));
+        }
+
+        //! the cost of a box in the tree is how likely a query is to hit it, which goes with its surface
+        inline double area(const vsg::dbox& box)
+        {
+            const double x = box.max.x - box.min.x, y = box.max.y - box.min.y, z = box.max.z - box.min.z;
+            return 2.0 * (x * y + y * z + z * x);
+        }
+
+        inline bool overlaps(const vsg::dbox& a, const vsg::dbox& b)
+        {
+            return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+        }
+
+        inline bool contains(const vsg::dbox& box, const vsg::dvec3& point)
+        {
+            return point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y && point.y <= box.max.y && point.z >= box.min.z && point.z <= box.max.z;
+        }
+
+        //! a box is outside when the corner furthest along the normal of any plane is behind it
+        inline bool inside(const NodeBVH::Frustum& frustum, const vsg::dbox& box)
+        {
+            for (const auto& plane : frustum)
+            {
+                const double x = plane.x >= 0.0 ? box.max.x : box.min.x;
+                const double y = plane.y >= 0.0 ? box.max.y : box.min.y;
+                const double z = plane.z >= 0.0 ? box.max.z : box.min.z;
+
+                if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0) { return false; }
+            }
+
+            return true;
+        }
+
+        //! slab test, @return the distance along the ray to where it enters the box or a negative number for a miss
+        inline double enter(const NodeBVH::Ray& ray, const vsg::dvec3& inverse, const vsg::dbox& box)
+        {
+            double entry = 0.0, exit = ray.length;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                double t0 = (box.min[axis] - ray.origin[axis]) * inverse[axis];
+                double t1 = (box.max[axis] - ray.origin[axis]) * inverse[axis];
+
+                if (t0 > t1) { std::swap(t0, t1); }
+
+                // a ray parallel to the slab and on its boundary makes 0 * inf, which fails both comparisons
+                if (t0 > entry) { entry = t0; }
+                if (t1 < exit) { exit = t1; }
+
+                if (entry > exit) { return -1.0; }
+            }
+
+            return entry;
+        }
+    } // namespace
+
+    NodeBVH::Frustum NodeBVH::frustum(const vsg::dmat4& projection, const vsg::dmat4& view)
+    {
+        const vsg::dmat4 m = projection * view;
+
+        auto row = [&m](int index) { return vsg::dvec4(m[0][index], m[1][index], m[2][index], m[3][index]); };
+
+        const vsg::dvec4 x = row(0), y = row(1), z = row(2), w = row(3);
+
+        // clip space is -w to w in x and y and 0 to w in depth, reversed depth just swaps the last two
+        Frustum planes = {w + x, w - x, w + y, w - y, z, w - z};
+
+        for (auto& plane : planes)
+        {
+            const double length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+
+            if (length > 0.0) { plane = plane / length; }
+        }
+
+        return planes;
+    }
+
+    vsg::dbox NodeBVH::transform(const vsg::dmat4& m, const vsg::box& box)
+    {
+        vsg::dbox result;
+
+        if (!box.valid()) { return result; }
+
+        // every corner goes through the matrix since a rotated box is bigger than its rotated min and max
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const double x = (corner & 1) ? box.max.x : box.min.x;
+            const double y = (corner & 2) ? box.max.y : box.min.y;
+            const double z = (corner & 4) ? box.max.z : box.min.z;
+
+            result.add(vsg::dvec3(m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0],
+                                  m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1],
+                                  m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2]));
+        }
+
+        return result;
+    }
+
+    void NodeBVH::insert(uint32_t nodeGuid, const vsg::dbox& bounds)
+    {
+        if (auto itr = leaves.find(nodeGuid); itr != leaves.end())
+        {
+            removeLeaf(itr->second);
+
+            entries[itr->second].bounds = bounds;
+            insertLeaf(itr->second);
+
+            return;
+        }
+
+        const int32_t leaf = allocate();
+
+        entries[leaf].bounds = bounds;
+        entries[leaf].node = nodeGuid;
+
+        leaves.emplace(nodeGuid, leaf);
+
+        insertLeaf(leaf);
+    }
+
+    bool NodeBVH::remove(uint32_t nodeGuid)
+    {
+        const auto itr = leaves.find(nodeGuid);
+
+        if (itr == leaves.end()) { return false; }
+
+        removeLeaf(itr->second);
+        release(itr->second);
+
+        leaves.erase(itr);
+
+        return true;
+    }
+
+    void NodeBVH::clear()
+    {
+        entries.clear();
+        leaves.clear();
+
+        root = Null;
+        freeList = Null;
+    }
+
+    template<typename Accept, typename Visit>
+    void NodeBVH::traverse(Accept&& accept, Visit&& visit) const
+    {
+        if (root == Null) { return; }
+
+        // depth first with both children pushed never holds more than the height plus one
+        int32_t fixed[64];
+        std::vector<int32_t> spill;
+
+        int32_t* stack = fixed;
+
+        if (entries[root].height + 1 > std::size(fixed))
+        {
+            spill.resize(entries[root].height + 1);
+            stack = spill.data();
+        }
+
+        size_t count = 0;
+        stack[count++] = root;
+
+        while (count != 0)
+        {
+            const Entry& entry = entries[stack[--count]];
+
+            if (!accept(entry.bounds)) { continue; }
+
+            if (entry.left == Null) { visit(entry); }
+            else
+            {
+                stack[count++] = entry.left;
+                stack[count++] = entry.right;
+            }
+        }
+    }
+
+    void NodeBVH::intersect(const vsg::dvec3& point, std::vector<uint32_t>& nodes) const
+    {
+        traverse([&point](const vsg::dbox& box) { return contains(box, point); }, [&nodes](const Entry& leaf) { nodes.push_back(leaf.node); });
+    }
+
+    void NodeBVH::intersect(const vsg::dbox& box, std::vector<uint32_t>& nodes) const
+    {
+        traverse([&box](const vsg::dbox& other) { return overlaps(box, other); }, [&nodes](const Entry& leaf) { nodes.push_back(leaf.node); });
+    }
+
+    void NodeBVH::intersect(const Frustum& frustum, std::vector<uint32_t>& nodes) const
+    {
+        traverse([&frustum](const vsg::dbox& box) { return inside(frustum, box); }, [&nodes](const Entry& leaf) { nodes.push_back(leaf.node); });
+    }
+
+    void NodeBVH::intersect(const Ray& ray, std::vector<Hit>& hits) const
+    {
+        const vsg::dvec3 inverse(1.0 / ray.direction.x, 1.0 / ray.direction.y, 1.0 / ray.direction.z);
+
+        const size_t first = hits.size();
+
+        traverse([&](const vsg::dbox& box) { return enter(ray, inverse, box) >= 0.0; }, [&](const Entry& leaf) { hits.push_back({leaf.node, enter(ray, inverse, leaf.bounds)}); });
+
+        std::sort(hits.begin() + first, hits.end(), [](const Hit& l, const Hit& r) { return l.distance < r.distance; });
+    }
+
+    const vsg::dbox* NodeBVH::bounds(uint32_t nodeGuid) const
+    {
+        if (const auto itr = leaves.find(nodeGuid); itr != leaves.end()) { return &entries[itr->second].bounds; }
+
+        return nullptr;
+    }
+
+    int32_t NodeBVH::allocate()
+    {
+        if (freeList == Null)
+        {
+            entries.emplace_back();
+
+            return static_cast<int32_t>(entries.size() - 1);
+        }
+
+        const int32_t index = freeList;
+        freeList = entries[index].right;
+
+        entries[index] = Entry();
+
+        return index;
+    }
+
+    void NodeBVH::release(int32_t index)
+    {
+        entries[index].right = freeList;
+        entries[index].height = 0;
+        freeList = index;
+    }
+
+    void NodeBVH::insertLeaf(int32_t leaf)
+    {
+        entries[leaf].parent = Null;
+
+        if (root == Null)
+        {
+            root = leaf;
+
+            return;
+        }
+
+        const vsg::dbox bounds = entries[leaf].bounds;
+
+        // walk down to the sibling that grows the tree the least, the boxes above it grow either way
+        int32_t index = root;
+
+        while (entries[index].left != Null)
+        {
+            const Entry& entry = entries[index];
+
+            const double combined = area(merge(entry.bounds, bounds));
+
+            const double cost = 2.0 * combined;
+            const double inherited = 2.0 * (combined - area(entry.bounds));
+
+            auto descend = [&](int32_t child) {
+                const Entry& other = entries[child];
+
+                const double grown = area(merge(other.bounds, bounds));
+
+                return other.left == Null ? grown + inherited : grown - area(other.bounds) + inherited;
+            };
+
+            const double left = descend(entry.left), right = descend(entry.right);
+
+            if (cost < left && cost < right) { break; }
+
+            index = left < right ? entry.left : entry.right;
+        }
+
+        const int32_t sibling = index;
+        const int32_t oldParent = entries[sibling].parent;
+        const int32_t newParent = allocate();
+
+        entries[newParent].parent = oldParent;
+        entries[newParent].bounds = merge(bounds, entries[sibling].bounds);
+        entries[newParent].height = entries[sibling].height + 1;
+        entries[newParent].left = sibling;
+        entries[newParent].right = leaf;
+
+        entries[sibling].parent = newParent;
+        entries[leaf].parent = newParent;
+
+        if (oldParent == Null) { root = newParent; }
+        else if (entries[oldParent].left == sibling) { entries[oldParent].left = newParent; }
+        else
+        {
+            entries[oldParent].right = newParent;
+        }
+
+        refit(newParent);
+    }
+
+    void NodeBVH::removeLeaf(int32_t leaf)
+    {
+        if (leaf == root)
+        {
+            root = Null;
+
+            return;
+        }
+
+        const int32_t parent = entries[leaf].parent;
+        const int32_t grandParent = entries[parent].parent;
+        const int32_t sibling = entries[parent].left == leaf ? entries[parent].right : entries[parent].left;
+
+        // the sibling takes the place of the parent
+        entries[sibling].parent = grandParent;
+
+        if (grandParent == Null) { root = sibling; }
+        else if (entries[grandParent].left == parent) { entries[grandParent].left = sibling; }
+        else
+        {
+            entries[grandParent].right = sibling;
+        }
+
+        release(parent);
+
+        refit(grandParent);
+    }
+
+    void NodeBVH::refit(int32_t index)
+    {
+        while (index != Null)
+        {
+            index = balance(index);
+
+            Entry& entry = entries[index];
+
+            entry.height = 1 + std::max(entries[entry.left].height, entries[entry.right].height);
+            entry.bounds = merge(entries[entry.left].bounds, entries[entry.right].bounds);
+
+            index = entry.parent;
+        }
+    }
+
+    int32_t NodeBVH::balance(int32_t a)
+    {
+        if (entries[a].left == Null || entries[a].height < 2) { return a; }
+
+        const int32_t b = entries[a].left, c = entries[a].right;
+
+        const int32_t difference = static_cast<int32_t>(entries[c].height) - static_cast<int32_t>(entries[b].height);
+
+        if (difference >= -1 && difference <= 1) { return a; }
+
+        // the deeper child takes the place of a, a keeps its other child and the shallower grandchild
+        const int32_t up = difference > 1 ? c : b;
+        const int32_t stays = difference > 1 ? b : c;
+
+        const int32_t f = entries[up].left, g = entries[up].right;
+
+        entries[up].left = a;
+        entries[up].parent = entries[a].parent;
+        entries[a].parent = up;
+
+        if (entries[up].parent == Null) { root = up; }
+        else if (entries[entries[up].parent].left == a) { entries[entries[up].parent].left = up; }
+        else
+        {
+            entries[entries[up].parent].right = up;
+        }
+
+        const int32_t deeper = entries[f].height > entries[g].height ? f : g;
+        const int32_t shallower = deeper == f ? g : f;
+
+        entries[up].right = deeper;
+
+        if (difference > 1) { entries[a].right = shallower; }
+        else
+        {
+            entries[a].left = shallower;
+        }
+
+        entries[shallower].parent = a;
+
+        entries[a].bounds = merge(entries[stays].bounds, entries[shallower].bounds);
+        entries[a].height = 1 + std::max(entries[stays].height, entries[shallower].height);
+
+        entries[up].bounds = merge(entries[a].bounds, entries[deeper].bounds);
+        entries[up].height = 1 + std::max(entries[a].height, entries[deeper].height);
+
+        return up;
+    }
+} // namespace ehb
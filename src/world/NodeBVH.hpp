@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <vsg/maths/box.h>
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/vec3.h>
+#include <vsg/maths/vec4.h>
+
+namespace ehb
+{
+    /**
+     * bounding volume hierarchy over the world space boxes of siege nodes. leaves are inserted next to whichever part
+     * of the tree grows the least from taking them and the tree is rotated on the way back up to keep it balanced, so
+     * regions can be added and taken out as they stream without ever rebuilding it. the tree lives in one array with
+     * indices instead of pointers and freed entries are reused
+     */
+    class NodeBVH final
+    {
+    public:
+        struct Ray
+        {
+            vsg::dvec3 origin;
+            vsg::dvec3 direction; //! doesn't have to be normalized, distances are in multiples of it
+            double length = std::numeric_limits<double>::max();
+        };
+
+        struct Hit
+        {
+            uint32_t node;
+            double distance; //! along the ray to where it enters the box, 0 when it starts inside
+        };
+
+        //! inward facing planes as (a, b, c, d) with ax + by + cz + d >= 0 inside
+        using Frustum = std::array<vsg::dvec4, 6>;
+
+        //! the planes of the volume a projection and view matrix see, with the depth range vulkan uses
+        static Frustum frustum(const vsg::dmat4& projection, const vsg::dmat4& view);
+
+        //! @return the world space box around a box in the space of a node, an invalid box stays invalid
+        static vsg::dbox transform(const vsg::dmat4& matrix, const vsg::box& box);
+
+        //! inserting a node that is already in the tree moves it
+        void insert(uint32_t nodeGuid, const vsg::dbox& bounds);
+
+        //! @return false when the node isn't in the tree
+        bool remove(uint32_t nodeGuid);
+
+        void clear();
+
+        //! the nodes whose box holds the point
+        void intersect(const vsg::dvec3& point, std::vector<uint32_t>& nodes) const;
+
+        //! the nodes whose box overlaps the box
+        void intersect(const vsg::dbox& box, std::vector<uint32_t>& nodes) const;
+
+        //! the nodes whose box is at least partly inside of the frustum
+        void intersect(const Frustum& frustum, std::vector<uint32_t>& nodes) const;
+
+        //! the nodes whose box the ray goes through, nearest first
+        void intersect(const Ray& ray, std::vector<Hit>& hits) const;
+
+        //! @return the box of a node in the tree or nullptr
+        const vsg::dbox* bounds(uint32_t nodeGuid) const;
+
+        //! @return the box around everything in the tree, invalid when it is empty
+        vsg::dbox bounds() const;
+
+        size_t size() const;
+
+        //! @return the longest path from the root to a leaf, 0 for an empty tree
+        uint32_t height() const;
+
+    private:
+        static constexpr int32_t Null = -1;
+
+        struct Entry
+        {
+            vsg::dbox bounds;
+            int32_t parent = Null;
+            int32_t left = Null;  //! Null for a leaf
+            int32_t right = Null; //! the next free entry while on the free list
+            uint32_t node = 0;    //! the guid of a leaf
+            uint32_t height = 0;  //! 0 for a leaf
+        };
+
+        int32_t allocate();
+        void release(int32_t index);
+
+        void insertLeaf(int32_t leaf);
+        void removeLeaf(int32_t leaf);
+
+        //! rotate the children of an entry if one side is deeper than the other, @return what took its place
+        int32_t balance(int32_t index);
+
+        //! recompute the bounds and heights from the entry to the root, balancing on the way
+        void refit(int32_t index);
+
+        //! visit every leaf whose box and whose parents' boxes are accepted
+        template<typename Accept, typename Visit>
+        void traverse(Accept&& accept, Visit&& visit) const;
+
+        std::vector<Entry> entries;
+        int32_t root = Null;
+        int32_t freeList = Null;
+
+        //! key: node guid, value: its leaf
+        std::unordered_map<uint32_t, int32_t> leaves;
+    };
+
+    inline size_t NodeBVH::size() const { return leaves.size(); }
+
+    inline uint32_t NodeBVH::height() const { return root == Null ? 0 : entries[root].height; }
+
+    inline vsg::dbox NodeBVH::bounds() const { return root == Null ? vsg::dbox() : entries[root].bounds; }
+} // namespace ehb
@@ -0,0 +1,245 @@
+#include "NodeDatabase.hpp"
+
+#include "gas/FuelNumeric.hpp"
+#include "gas/FuelReader.hpp"
+#include "io/IFileSys.hpp"
+#include "io/ThreadPool.hpp"
+#include "world/NodeBVH.hpp"
+#include "world/WorldPlacement.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace ehb
+{
+    namespace
+    {
+        struct Entry
+        {
+            uint32_t guid, region, meshGuid;
+        };
+
+        //! the node guids listed in the streamer_node_index.gas of a region
+        void readStreamerIndex(IFileSys& fileSys, const std::string& path, uint32_t region, std::vector<Entry>& entries)
+        {
+            auto stream = fileSys.createInputStream(path);
+
+            if (stream == nullptr) { return; }
+
+            size_t depth = 0;
+
+            FuelReader reader;
+
+            reader.beginBlock = [&](std::string_view name, std::string_view) {
+                if (depth != 0 || name != "streamer_node_index") { return FuelReader::Next::Skip; }
+
+                ++depth;
+
+                return FuelReader::Next::Continue;
+            };
+
+            reader.endBlock = [&]() {
+                --depth;
+
+                return FuelReader::Next::Continue;
+            };
+
+            reader.attribute = [&](std::string_view, std::string_view, std::string_view value) {
+                if (depth != 1) { return FuelReader::Next::Continue; }
+
+                uint32_t nodeGuid = 0;
+
+                if (const auto error = numeric::parseGuid(value, nodeGuid); error != numeric::ParseError::None)
+                {
+                    spdlog::get("log")->error("{}: invalid node guid '{}', {}", path, value, numeric::describe(error));
+
+                    return FuelReader::Next::Continue;
+                }
+
+                entries.push_back({nodeGuid, region, 0});
+
+                return FuelReader::Next::Continue;
+            };
+
+            if (!reader.read(*stream)) { spdlog::get("log")->error("{}: syntax error", path); }
+        }
+
+        //! the node guids of a region along with their meshes, the doors aren't needed so they are skipped
+        void readNodes(IFileSys& fileSys, const std::string& path, uint32_t region, std::vector<Entry>& entries)
+        {
+            auto stream = fileSys.createInputStream(path);
+
+            if (stream == nullptr) { return; }
+
+            // the snode being read, the blocks inside of it are skipped so there is no depth past it to track
+            Entry* node = nullptr;
+
+            FuelReader reader;
+
+            reader.beginBlock = [&](std::string_view name, std::string_view type) {
+                if (node != nullptr) { return FuelReader::Next::Skip; }
+
+                if (type != "snode") { return FuelReader::Next::Continue; }
+
+                uint32_t nodeGuid = 0;
+
+                if (numeric::parseGuid(name, nodeGuid) != numeric::ParseError::None)
+                {
+                    spdlog::get("log")->warn("{}: snode '{}' doesn't have a valid guid", path, name);
+
+                    return FuelReader::Next::Skip;
+                }
+
+                node = &entries.emplace_back(Entry{nodeGuid, region, 0});
+
+                return FuelReader::Next::Continue;
+            };
+
+            reader.endBlock = [&]() {
+                node = nullptr;
+
+                return FuelReader::Next::Continue;
+            };
+
+            reader.attribute = [&](std::string_view name, std::string_view, std::string_view value) {
+                if (node != nullptr && name == "mesh_guid") { numeric::parseGuid(value, node->meshGuid); }
+
+                return FuelReader::Next::Continue;
+            };
+
+            if (!reader.read(*stream)) { spdlog::get("log")->error("{}: syntax error", path); }
+        }
+    } // namespace
+
+    void NodeDatabase::init(IFileSys& fileSys, std::vector<Region> regions, unsigned int threads)
+    {
+        auto log = spdlog::get("log");
+
+        // sorted so the same world always ends up with the same indices and the same winner for a duplicate node
+        std::stable_sort(regions.begin(), regions.end(), [](const Region& l, const Region& r) { return l.guid < r.guid; });
+
+        regionList.clear();
+        regionList.reserve(regions.size());
+
+        for (auto& region : regions)
+        {
+            if (!regionList.empty() && regionList.back().guid == region.guid)
+            {
+                log->error("redefined region id {:08x} in {}, keeping {}", region.guid, region.name, regionList.back().name);
+
+                continue;
+            }
+
+            regionList.push_back(std::move(region));
+        }
+
+        nodeGuids.clear();
+        nodeList.clear();
+        nodeTransforms.clear();
+
+        std::vector<std::vector<Entry>> loaded(regionList.size());
+
+        parallelFor(regionList.size(), threads, [&](unsigned int, size_t index) {
+            auto& entries = loaded[index];
+
+            const uint32_t region = static_cast<uint32_t>(index);
+
+            readStreamerIndex(fileSys, regionList[index].folder + "/index/streamer_node_index.gas", region, entries);
+            readNodes(fileSys, regionList[index].folder + "/terrain_nodes/nodes.gas", region, entries);
+
+            // a node is normally in both files, only nodes.gas knows its mesh
+            std::sort(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) { return l.guid < r.guid || (l.guid == r.guid && l.meshGuid > r.meshGuid); });
+            entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) { return l.guid == r.guid; }), entries.end());
+        });
+
+        size_t total = 0;
+
+        for (const auto& entries : loaded)
+        {
+            total += entries.size();
+        }
+
+        std::vector<Entry> all;
+        all.reserve(total);
+
+        for (auto& entries : loaded)
+        {
+            all.insert(all.end(), entries.begin(), entries.end());
+            std::vector<Entry>().swap(entries);
+        }
+
+        // stable so a node that shows up in two regions stays with the region that sorts first
+        std::stable_sort(all.begin(), all.end(), [](const Entry& l, const Entry& r) { return l.guid < r.guid; });
+
+        nodeGuids.reserve(all.size());
+        nodeList.reserve(all.size());
+
+        for (const Entry& entry : all)
+        {
+            if (!nodeGuids.empty() && nodeGuids.back() == entry.guid)
+            {
+                log->error("node 0x{:08x} is in both {} and {}", entry.guid, regionList[nodeList.back().region].name, regionList[entry.region].name);
+
+                continue;
+            }
+
+            nodeGuids.push_back(entry.guid);
+            nodeList.push_back({entry.region, entry.meshGuid, NoTransform, {}});
+        }
+
+        log->info("node database has {} nodes in {} regions", nodeGuids.size(), regionList.size());
+    }
+
+    void NodeDatabase::place(const WorldPlacement& placement)
+    {
+        nodeTransforms.clear();
+
+        size_t placed = 0;
+
+        for (size_t index = 0; index < nodeGuids.size(); ++index)
+        {
+            Node& node = nodeList[index];
+
+            const vsg::dmat4* transform = placement.nodeTransform(nodeGuids[index]);
+
+            if (transform == nullptr)
+            {
+                node.transform = NoTransform;
+                node.bounds = vsg::dbox();
+
+                continue;
+            }
+
+            node.transform = static_cast<uint32_t>(nodeTransforms.size());
+            nodeTransforms.push_back(*transform);
+
+            // a mesh whose box isn't known is just its origin
+            const vsg::box* box = placement.meshBounds(node.meshGuid);
+
+            node.bounds = NodeBVH::transform(*transform, box != nullptr ? *box : vsg::box(vsg::vec3(), vsg::vec3()));
+
+            ++placed;
+        }
+
+        spdlog::get("log")->info("node database placed {} of {} nodes", placed, nodeGuids.size());
+    }
+
+    const NodeDatabase::Node* NodeDatabase::find(uint32_t nodeGuid) const
+    {
+        const auto itr = std::lower_bound(nodeGuids.begin(), nodeGuids.end(), nodeGuid);
+
+        if (itr != nodeGuids.end() && *itr == nodeGuid) { return &nodeList[static_cast<size_t>(itr - nodeGuids.begin())]; }
+
+        return nullptr;
+    }
+
+    const NodeDatabase::Region* NodeDatabase::findRegion(uint32_t regionGuid) const
+    {
+        const auto itr = std::lower_bound(regionList.begin(), regionList.end(), regionGuid, [](const Region& region, uint32_t guid) { return region.guid < guid; });
+
+        if (itr != regionList.end() && itr->guid == regionGuid) { return &*itr; }
+
+        return nullptr;
+    }
+} // namespace ehb
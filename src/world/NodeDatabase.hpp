@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vsg/maths/box.h>
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/vec3.h>
+
+namespace ehb
+{
+    class IFileSys;
+    class WorldPlacement;
+
+    /**
+     * every node of a world in one place: which region it is in, the mesh it uses and, once the world has been
+     * placed, its transform and world space bounds. the guids are kept sorted in their own array so a lookup is a
+     * binary search over 4 bytes a node and the rest of the node is only touched once it is found
+     */
+    class NodeDatabase final
+    {
+    public:
+        struct Region
+        {
+            uint32_t guid;
+            std::string name;
+            std::string folder; //! the directory holding main.gas, terrain_nodes and index
+        };
+
+        struct Node
+        {
+            uint32_t region;    //! index into regions()
+            uint32_t meshGuid;  //! 0 when the node isn't in nodes.gas
+            uint32_t transform; //! index into transforms() or NoTransform until place has found one
+            vsg::dbox bounds;   //! world space, invalid until placed
+        };
+
+        static constexpr uint32_t NoTransform = 0xFFFFFFFF;
+
+        /**
+         * read the streamer_node_index.gas and nodes.gas of every region, one region per worker thread
+         * @param threads the number of workers, 0 picks one per hardware thread
+         */
+        void init(IFileSys& fileSys, std::vector<Region> regions, unsigned int threads = 0);
+
+        //! fill in the transform and bounds of every node the placement was able to place
+        void place(const WorldPlacement& placement);
+
+        //! @return the node or nullptr if it isn't part of the world
+        const Node* find(uint32_t nodeGuid) const;
+
+        //! @return the guid of the region the node is in or 0
+        uint32_t regionForNode(uint32_t nodeGuid) const;
+
+        //! @return the region the node is in or nullptr
+        const Region* regionOf(uint32_t nodeGuid) const;
+
+        //! @return the region with the guid or nullptr
+        const Region* findRegion(uint32_t regionGuid) const;
+
+        const std::vector<Region>& regions() const;
+
+        //! sorted, nodes()[i] belongs to guids()[i]
+        const std::vector<uint32_t>& guids() const;
+        const std::vector<Node>& nodes() const;
+
+        const std::vector<vsg::dmat4>& transforms() const;
+
+        size_t size() const;
+
+    private:
+        std::vector<Region> regionList;
+
+        std::vector<uint32_t> nodeGuids;
+        std::vector<Node> nodeList;
+
+        std::vector<vsg::dmat4> nodeTransforms;
+    };
+
+    inline uint32_t NodeDatabase::regionForNode(uint32_t nodeGuid) const
+    {
+        const Node* node = find(nodeGuid);
+        return node != nullptr ? regionList[node->region].guid : 0;
+    }
+
+    inline const NodeDatabase::Region* NodeDatabase::regionOf(uint32_t nodeGuid) const
+    {
+        const Node* node = find(nodeGuid);
+        return node != nullptr ? &regionList[node->region] : nullptr;
+    }
+
+    inline const std::vector<NodeDatabase::Region>& NodeDatabase::regions() const { return regionList; }
+
+    inline const std::vector<uint32_t>& NodeDatabase::guids() const { return nodeGuids; }
+
+    inline const std::vector<NodeDatabase::Node>& NodeDatabase::nodes() const { return nodeList; }
+
+    inline const std::vector<vsg::dmat4>& NodeDatabase::transforms() const { return nodeTransforms; }
+
+    inline size_t NodeDatabase::size() const { return nodeGuids.size(); }
+} // namespace ehb
@@ -0,0 +1,216 @@
+#include "PlacementSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include <vsg/maths/quat.h>
+#include <vsg/maths/transform.h>
+
+namespace ehb
+{
+    uint32_t PlacementSolver::addMesh(const SiegeMesh::SiegeMeshDoorList& doors)
+    {
+        std::vector<std::pair<uint32_t, vsg::dmat4>> list;
+        list.reserve(doors.size());
+
+        for (const auto& door : doors)
+        {
+            list.emplace_back(door->id(), door->transform());
+        }
+
+        return addMesh(list);
+    }
+
+    uint32_t PlacementSolver::addMesh(const std::vector<std::pair<uint32_t, vsg::dmat4>>& list)
+    {
+        // the same flip SiegeNode::connect does from one side of a door to the other
+        static const auto oneEightyRotate = vsg::rotate(vsg::dquat(0.00000000000000000, 1.00000000000000000, 0.0, 6.1232339957367660e-17));
+
+        meshes.push_back({static_cast<uint32_t>(doors.size()), static_cast<uint32_t>(list.size())});
+
+        for (const auto& [id, transform] : list)
+        {
+            doors.push_back({id, transform, oneEightyRotate * vsg::inverse(transform)});
+        }
+
+        return static_cast<uint32_t>(meshes.size() - 1);
+    }
+
+    void PlacementSolver::addNode(uint32_t guid, uint32_t mesh)
+    {
+        if (auto [itr, inserted] = nodeIndex.emplace(guid, static_cast<uint32_t>(nodeGuids.size())); inserted)
+        {
+            nodeGuids.push_back(guid);
+            nodeMeshes.push_back(mesh);
+        }
+        else
+        {
+            nodeMeshes[itr->second] = mesh;
+        }
+    }
+
+    void PlacementSolver::addConnection(uint32_t node1, uint32_t door1, uint32_t node2, uint32_t door2)
+    {
+        connections.push_back({node1, door1, node2, door2});
+    }
+
+    size_t PlacementSolver::solve(uint32_t rootGuid, const vsg::dmat4& root)
+    {
+        const size_t count = nodeGuids.size();
+
+        transforms.assign(count, vsg::dmat4());
+        placed.assign(count, false);
+        inconsistent.clear();
+        unresolved = 0;
+
+        // resolve the guids and door ids once, every connection ends up from the lower node index to the higher one
+        std::vector<Connection> resolved;
+        resolved.reserve(connections.size());
+
+        for (const Connection& connection : connections)
+        {
+            const auto node1 = nodeIndex.find(connection.node1), node2 = nodeIndex.find(connection.node2);
+
+            if (node1 == nodeIndex.end() || node2 == nodeIndex.end())
+            {
+                ++unresolved;
+                continue;
+            }
+
+            Connection entry = {node1->second, findDoor(node1->second, connection.door1), node2->second, findDoor(node2->second, connection.door2)};
+
+            if (entry.door1 == std::numeric_limits<uint32_t>::max() || entry.door2 == std::numeric_limits<uint32_t>::max())
+            {
+                ++unresolved;
+                continue;
+            }
+
+            if (entry.node2 < entry.node1 || (entry.node2 == entry.node1 && entry.door2 < entry.door1))
+            {
+                std::swap(entry.node1, entry.node2);
+                std::swap(entry.door1, entry.door2);
+            }
+
+            resolved.push_back(entry);
+        }
+
+        auto key = [](const Connection& c) { return std::tie(c.node1, c.door1, c.node2, c.door2); };
+
+        std::sort(resolved.begin(), resolved.end(), [&key](const Connection& l, const Connection& r) { return key(l) < key(r); });
+        resolved.erase(std::unique(resolved.begin(), resolved.end(), [&key](const Connection& l, const Connection& r) { return key(l) == key(r); }), resolved.end());
+
+        // both directions of every connection in one array, the ones of a node are offsets[node] to offsets[node + 1]
+        struct Edge
+        {
+            uint32_t node, door, otherDoor;
+        };
+
+        std::vector<uint32_t> offsets(count + 1, 0);
+
+        for (const Connection& connection : resolved)
+        {
+            ++offsets[connection.node1 + 1];
+            ++offsets[connection.node2 + 1];
+        }
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            offsets[index + 1] += offsets[index];
+        }
+
+        std::vector<Edge> edges(offsets[count]);
+
+        {
+            std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+
+            for (const Connection& connection : resolved)
+            {
+                edges[next[connection.node1]++] = {connection.node2, connection.door1, connection.door2};
+                edges[next[connection.node2]++] = {connection.node1, connection.door2, connection.door1};
+            }
+        }
+
+        const auto rootIndex = nodeIndex.find(rootGuid);
+
+        if (rootIndex == nodeIndex.end()) { return 0; }
+
+        // every node is placed by whichever connection reaches it first
+        std::vector<uint32_t> queue;
+        queue.reserve(count);
+        queue.push_back(rootIndex->second);
+
+        transforms[rootIndex->second] = root;
+        placed[rootIndex->second] = true;
+
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const uint32_t node = queue[head];
+
+            for (uint32_t edge = offsets[node]; edge < offsets[node + 1]; ++edge)
+            {
+                const Edge& e = edges[edge];
+
+                if (placed[e.node]) { continue; }
+
+                transforms[e.node] = through(transforms[node], e.door, e.otherDoor);
+                placed[e.node] = true;
+
+                queue.push_back(e.node);
+            }
+        }
+
+        // the connections the walk didn't take have to agree with where it put their nodes
+        for (const Connection& connection : resolved)
+        {
+            if (!placed[connection.node1] || !placed[connection.node2]) { continue; }
+
+            const vsg::dmat4 expected = through(transforms[connection.node1], connection.door1, connection.door2);
+            const vsg::dmat4& actual = transforms[connection.node2];
+
+            const double distance = std::sqrt(std::pow(expected[3][0] - actual[3][0], 2) + std::pow(expected[3][1] - actual[3][1], 2) + std::pow(expected[3][2] - actual[3][2], 2));
+
+            double rotation = 0.0;
+
+            for (int column = 0; column < 3; ++column)
+            {
+                for (int row = 0; row < 3; ++row)
+                {
+                    rotation = std::max(rotation, std::abs(expected[column][row] - actual[column][row]));
+                }
+            }
+
+            if (distance > Tolerance || rotation > Tolerance) { inconsistent.push_back({nodeGuids[connection.node1], nodeGuids[connection.node2], distance, rotation}); }
+        }
+
+        return queue.size();
+    }
+
+    const vsg::dmat4* PlacementSolver::transform(uint32_t guid) const
+    {
+        if (const auto itr = nodeIndex.find(guid); itr != nodeIndex.end() && itr->second < placed.size() && placed[itr->second]) { return &transforms[itr->second]; }
+
+        return nullptr;
+    }
+
+    uint32_t PlacementSolver::findDoor(uint32_t node, uint32_t id) const
+    {
+        if (nodeMeshes[node] < meshes.size())
+        {
+            const Mesh& mesh = meshes[nodeMeshes[node]];
+
+            for (uint32_t door = mesh.firstDoor; door < mesh.firstDoor + mesh.numDoors; ++door)
+            {
+                if (doors[door].id == id) { return door; }
+            }
+        }
+
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    vsg::dmat4 PlacementSolver::through(const vsg::dmat4& parent, uint32_t door1, uint32_t door2) const
+    {
+        return parent * doors[door1].transform * doors[door2].connect;
+    }
+} // namespace ehb
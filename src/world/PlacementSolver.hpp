@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <vsg/maths/mat4.h>
+
+#include "world/SiegeMesh.hpp"
+
+namespace ehb
+{
+    /**
+     * places nodes by walking the doors they are connected through, breadth first from a root node. the graph is
+     * kept in flat arrays and the inverse of every door is taken once per mesh instead of once per connection, which
+     * is what SiegeNode::connect ends up doing. connections that disagree with where the walk put their nodes are
+     * reported as inconsistent cycles
+     */
+    class PlacementSolver final
+    {
+    public:
+        //! a connection whose doors don't line up once both of its nodes are placed
+        struct Inconsistency
+        {
+            uint32_t node1, node2;
+            double distance; //! between where the second node is and where the connection would put it
+            double rotation; //! largest difference between the rotations, 0 to 2
+        };
+
+        //! @return the index of the mesh, nodes that share a mesh share its doors
+        uint32_t addMesh(const SiegeMesh::SiegeMeshDoorList& doors);
+        uint32_t addMesh(const std::vector<std::pair<uint32_t, vsg::dmat4>>& doors);
+
+        //! adding a node that already exists changes its mesh
+        void addNode(uint32_t guid, uint32_t mesh);
+
+        //! connect two doors, the order of the nodes doesn't matter and a connection added twice is only walked once
+        void addConnection(uint32_t node1, uint32_t door1, uint32_t node2, uint32_t door2);
+
+        /**
+         * place everything that can be reached from the root, nodes that can't be reached keep no transform
+         * @return the number of nodes placed
+         */
+        size_t solve(uint32_t rootGuid, const vsg::dmat4& root = {});
+
+        //! @return the transform of a placed node or nullptr
+        const vsg::dmat4* transform(uint32_t guid) const;
+
+        const std::vector<Inconsistency>& inconsistencies() const;
+
+        size_t nodeCount() const;
+
+        //! connections that name a node or door that doesn't exist, found by solve
+        size_t unresolvedCount() const;
+
+        //! an error smaller than this is left to floating point and isn't reported
+        static constexpr double Tolerance = 0.01;
+
+    private:
+        //! the inverse and the flip onto the other side are done once up front
+        struct Door
+        {
+            uint32_t id;
+            vsg::dmat4 transform;
+            vsg::dmat4 connect; //! rotate(180) * inverse(transform)
+        };
+
+        struct Mesh
+        {
+            uint32_t firstDoor, numDoors;
+        };
+
+        struct Connection
+        {
+            uint32_t node1, door1, node2, door2; // guids and door ids until solve resolves them to indices
+        };
+
+        //! @return the index of the door in the mesh of the node or UINT32_MAX
+        uint32_t findDoor(uint32_t node, uint32_t id) const;
+
+        //! where going through door1 of a node at parent onto door2 of another puts the other one
+        vsg::dmat4 through(const vsg::dmat4& parent, uint32_t door1, uint32_t door2) const;
+
+        std::vector<Door> doors;
+        std::vector<Mesh> meshes;
+
+        std::vector<uint32_t> nodeGuids, nodeMeshes;
+        std::unordered_map<uint32_t, uint32_t> nodeIndex;
+
+        std::vector<Connection> connections;
+
+        std::vector<vsg::dmat4> transforms;
+        std::vector<bool> placed;
+
+        std::vector<Inconsistency> inconsistent;
+        size_t unresolved = 0;
+    };
+
+    inline const std::vector<PlacementSolver::Inconsistency>& PlacementSolver::inconsistencies() const { return inconsistent; }
+
+    inline size_t PlacementSolver::nodeCount() const { return nodeGuids.size(); }
+
+    inline size_t PlacementSolver::unresolvedCount() const { return unresolved; }
+} // namespace ehb
@@ -1,6 +1,8 @@
 
 #include "Region.hpp"
 
+#include <unordered_set>
+
 namespace ehb
 {
 
@@ -67,4 +69,45 @@ namespace ehb
         addChild(objects);
     }
 
+    Region::Residency Region::computeResidency() const
+    {
+        Residency residency;
+
+        std::unordered_set<const SiegeMesh*> meshes;
+        std::unordered_set<std::string> textures;
+
+        for (const auto& [guid, xform] : placedNodeXformMap)
+        {
+            for (const auto& child : xform->children)
+            {
+                auto node = child.cast<SiegeNode>();
+                if (node == nullptr || node->mesh() == nullptr || !meshes.insert(node->mesh()).second) { continue; }
+
+                auto renderObject = node->mesh()->renderObject();
+                if (renderObject == nullptr) { continue; }
+
+                const size_t numVertices = static_cast<size_t>(renderObject->numVertices());
+
+                // the interleaved vertex buffer, it stays around on the cpu side as well
+                residency.meshBytes += numVertices * sizeof(sVertex);
+
+                // the render object reads the same buffer so only the normals of the mesh are extra
+                residency.cpuBytes += numVertices * sizeof(vsg::vec3);
+
+                for (const auto& stage : renderObject->stageList())
+                {
+                    residency.meshBytes += stage.numVIndices * sizeof(uint16_t);
+                    residency.cpuBytes += stage.numVIndices * sizeof(uint16_t) + stage.numLIndices * sizeof(uint32_t);
+
+                    if (stage.textureBytes != 0 && textures.insert(stage.name).second) { residency.textureBytes += stage.textureBytes; }
+                }
+            }
+        }
+
+        residency.meshes = static_cast<uint32_t>(meshes.size());
+        residency.textures = static_cast<uint32_t>(textures.size());
+
+        return residency;
+    }
+
 } // namespace ehb
\ No newline at end of file
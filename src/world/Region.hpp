@@ -26,6 +26,22 @@ namespace ehb
 
         void setObjects(vsg::ref_ptr<vsg::Group> objects);
 
+        //! estimated memory held by the region, a mesh or texture shared with another region counts for both
+        struct Residency
+        {
+            size_t meshBytes = 0;    //! vertex and index arrays handed to the gpu
+            size_t textureBytes = 0; //! texture data of the stages that are drawn
+            size_t cpuBytes = 0;     //! what the meshes keep around on the cpu side
+
+            uint32_t meshes = 0;
+            uint32_t textures = 0;
+
+            size_t total() const { return meshBytes + textureBytes + cpuBytes; }
+        };
+
+        //! walks the nodes of the region, every mesh and texture is counted once no matter how many nodes use it
+        Residency computeResidency() const;
+
         //! loaded from main.gas
         uint32_t guid = 0;
 
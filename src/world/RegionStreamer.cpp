@@ -0,0 +1,514 @@
+#include "RegionStreamer.hpp"
+
+#include "world/Region.hpp"
+#include "world/SiegeNode.hpp"
+#include "world/WorldPlacement.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <vsg/io/read.h>
+#include <vsg/maths/transform.h>
+#include <vsg/utils/SharedObjects.h>
+
+namespace ehb
+{
+    RegionStreamer::RegionStreamer(const WorldMapDataCache::WorldMapData& world, vsg::ref_ptr<vsg::Options> options, vsg::ref_ptr<vsg::Group> parent, const Settings& settings, const WorldPlacement* worldPlacement) :
+        world(world), worldPlacement(worldPlacement), options(options), parent(parent), settings(settings), log(spdlog::get("log"))
+    {
+        // a stitch is walked from whichever side ends up placed first
+        for (const auto& [region1, stitches] : world.stitchIndex.data)
+        {
+            for (const auto& [region2, stitch] : stitches)
+            {
+                auto link = [this](uint32_t from, Neighbour neighbour) {
+                    auto& neighbours = adjacency[from];
+
+                    if (std::none_of(neighbours.begin(), neighbours.end(), [&neighbour](const Neighbour& n) { return n.region == neighbour.region; })) { neighbours.push_back(neighbour); }
+                };
+
+                link(region1, {region2, stitch.node1, stitch.door1, stitch.node2, stitch.door2});
+                link(region2, {region1, stitch.node2, stitch.door2, stitch.node1, stitch.door1});
+            }
+        }
+
+        for (unsigned int i = 0; i < std::max(1u, settings.threads); ++i)
+        {
+            workers.emplace_back(&RegionStreamer::work, this);
+        }
+    }
+
+    RegionStreamer::~RegionStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            stopping = true;
+            queue.clear();
+        }
+
+        condition.notify_all();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    bool RegionStreamer::start(uint32_t regionGuid)
+    {
+        auto region = read(regionGuid);
+
+        if (region == nullptr)
+        {
+            log->critical("unable to load the starting region 0x{:x}", regionGuid);
+
+            return false;
+        }
+
+        insert(regionGuid, region, vsg::MatrixTransform::create());
+
+        current = regionGuid;
+
+        return true;
+    }
+
+    bool RegionStreamer::update(const vsg::dvec3& camera, const vsg::dvec3& forward, double deltaTime)
+    {
+        bool changed = false;
+
+        ++frame;
+
+        // whatever was taken out long enough ago can't be drawn anymore, the shared objects only it used go with it
+        if (!retired.empty() && retired.front().frame + settings.framesInFlight <= frame)
+        {
+            while (!retired.empty() && retired.front().frame + settings.framesInFlight <= frame)
+            {
+                retired.pop_front();
+            }
+
+            if (options->sharedObjects) { options->sharedObjects->prune(); }
+        }
+
+        // stitch in whatever the workers are done with
+        std::vector<std::pair<uint32_t, vsg::ref_ptr<Region>>> loaded;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            loaded.swap(finished);
+        }
+
+        for (auto& [guid, region] : loaded)
+        {
+            requested.erase(guid);
+
+            if (region == nullptr)
+            {
+                // not worth trying again every frame
+                failed.insert(guid);
+
+                continue;
+            }
+
+            if (placed.count(guid) != 0) { continue; }
+
+            if (place(guid, region)) { changed = true; }
+            else
+            {
+                // the neighbours it came in for were dropped while it was loading, it gets requested again if it's still wanted
+                log->debug("region 0x{:x} has no placed neighbour left to be stitched to", guid);
+            }
+        }
+
+        if (placed.empty()) { return changed; }
+
+        // distances are taken from where the camera is and where it is heading
+        vsg::dvec3 predicted = camera;
+
+        if (hasLastCamera && deltaTime > 0.0)
+        {
+            const vsg::dvec3 velocity = (camera - lastCamera) / deltaTime;
+
+            predicted = camera + velocity * settings.prefetchSeconds;
+        }
+
+        lastCamera = camera;
+        hasLastCamera = true;
+
+        // the region the camera is in, with overlapping spheres the one with the closest center wins
+        {
+            double best = std::numeric_limits<double>::max(), bestCenter = best;
+
+            for (const auto& [guid, entry] : placed)
+            {
+                const double d = distance(entry, camera), center = vsg::length(entry.center - camera);
+
+                if (d < best || (d == best && center < bestCenter))
+                {
+                    best = d;
+                    bestCenter = center;
+                    current = guid;
+                }
+            }
+        }
+
+        const auto hops = hopsFrom(current, settings.hops + 1);
+
+        // drop what has moved out of range, the region the camera is in always stays
+        std::vector<uint32_t> drop;
+
+        for (const auto& [guid, entry] : placed)
+        {
+            if (guid == current) { continue; }
+
+            const auto hop = hops.find(guid);
+            const double d = std::min(distance(entry, camera), distance(entry, predicted));
+
+            if (hop == hops.end() || hop->second > settings.hops + 1 || d > settings.radius * settings.unloadFactor) { drop.push_back(guid); }
+        }
+
+        for (uint32_t guid : drop)
+        {
+            remove(guid);
+
+            changed = true;
+        }
+
+        const double forwardLength = vsg::length(forward);
+        const vsg::dvec3 direction = forwardLength > 0.0 ? forward / forwardLength : forward;
+
+        for (auto& [guid, entry] : placed)
+        {
+            if (guid == current || visible(entry.center, entry.radius, camera, direction)) { entry.lastVisible = frame; }
+        }
+
+        if (evict()) { changed = true; }
+
+        // whatever is still queued is taken back and queued again below if it is still wanted
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (uint32_t guid : queue)
+            {
+                requested.erase(guid);
+            }
+
+            queue.clear();
+        }
+
+        // when what's visible doesn't fit on its own nothing else is loaded until the camera moves
+        if (settings.budget != 0 && resident > settings.budget)
+        {
+            log->debug("the visible regions hold {} bytes which is over the budget of {}", resident, settings.budget);
+
+            return changed;
+        }
+
+        // the regions that aren't placed yet are only known by the doors they share with the ones that are
+        std::unordered_map<uint32_t, double> wanted;
+
+        for (const auto& [guid, entry] : placed)
+        {
+            const auto neighbours = adjacency.find(guid);
+
+            if (neighbours == adjacency.end()) { continue; }
+
+            for (const Neighbour& neighbour : neighbours->second)
+            {
+                const uint32_t region = neighbour.region;
+
+                if (placed.count(region) != 0 || requested.count(region) != 0 || failed.count(region) != 0) { continue; }
+
+                if (const auto hop = hops.find(region); hop == hops.end() || hop->second > settings.hops) { continue; }
+
+                const vsg::dvec3 door = nodePosition(entry, neighbour.node);
+                const double d = std::min(vsg::length(door - camera), vsg::length(door - predicted));
+
+                // regions that aren't visible are only loaded while they fit, otherwise they would just push out the
+                // next one. a region that has been placed before is known by its sphere and size, others by the door
+                if (settings.budget != 0)
+                {
+                    const auto placement = placements.find(region);
+                    const bool known = placement != placements.end();
+
+                    if (!(known ? visible(placement->second.center, placement->second.radius, camera, direction) : visible(door, 0.0, camera, direction)))
+                    {
+                        if (resident + (known ? placement->second.bytes : 0) >= settings.budget) { continue; }
+                    }
+                }
+
+                if (d <= settings.radius)
+                {
+                    if (auto itr = wanted.find(region); itr == wanted.end() || d < itr->second) { wanted[region] = d; }
+                }
+            }
+        }
+
+        // closest first
+        std::vector<std::pair<double, uint32_t>> order;
+
+        for (const auto& [guid, d] : wanted)
+        {
+            order.emplace_back(d, guid);
+        }
+
+        std::sort(order.begin(), order.end());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (const auto& [d, guid] : order)
+            {
+                queue.push_back(guid);
+                requested.insert(guid);
+            }
+        }
+
+        if (!order.empty()) { condition.notify_all(); }
+
+        return changed;
+    }
+
+    vsg::ref_ptr<Region> RegionStreamer::read(uint32_t regionGuid) const
+    {
+        const auto& path = world.regionNameAndPathFromRegionGuid(regionGuid).first;
+
+        if (path.empty()) { return {}; }
+
+        auto region = vsg::read_cast<Region>(path, options);
+
+        if (region == nullptr) { log->error("unable to load region 0x{:x} from {}", regionGuid, path); }
+
+        return region;
+    }
+
+    bool RegionStreamer::place(uint32_t regionGuid, vsg::ref_ptr<Region> region)
+    {
+        auto transform = vsg::MatrixTransform::create();
+
+        auto nodeIn = [](const Region& region, uint32_t nodeGuid) -> vsg::MatrixTransform* {
+            const auto itr = region.placedNodeXformMap.find(nodeGuid);
+            return itr != region.placedNodeXformMap.end() ? itr->second.get() : nullptr;
+        };
+
+        bool stitched = false;
+
+        // it has been placed before, stitching it again could put it somewhere slightly different
+        if (const auto placement = placements.find(regionGuid); placement != placements.end())
+        {
+            transform->matrix = placement->second.matrix;
+            stitched = true;
+        }
+        else if (auto matrix = worldPlacement ? worldPlacement->regionTransform(regionGuid) : nullptr)
+        {
+            transform->matrix = *matrix;
+            stitched = true;
+        }
+        else if (const auto neighbours = adjacency.find(regionGuid); neighbours != adjacency.end())
+        {
+            for (const Neighbour& neighbour : neighbours->second)
+            {
+                const auto target = placed.find(neighbour.region);
+
+                if (target == placed.end()) { continue; }
+
+                if (auto targetNode = nodeIn(*target->second.region, neighbour.otherNode), connectNode = nodeIn(*region, neighbour.node); targetNode && connectNode)
+                {
+                    SiegeNode::connect(target->second.transform, targetNode, neighbour.otherDoor, transform, connectNode, neighbour.door);
+                    stitched = true;
+
+                    break;
+                }
+            }
+        }
+
+        if (!stitched) { return false; }
+
+        insert(regionGuid, region, transform);
+
+        return true;
+    }
+
+    void RegionStreamer::insert(uint32_t regionGuid, vsg::ref_ptr<Region> region, vsg::ref_ptr<vsg::MatrixTransform> transform)
+    {
+        // a region is just a group and not a transform
+        transform->children.push_back(region);
+
+        Placed entry;
+        entry.transform = transform;
+        entry.region = region;
+
+        if (!region->placedNodeXformMap.empty())
+        {
+            for (const auto& [guid, node] : region->placedNodeXformMap)
+            {
+                entry.center = entry.center + nodePosition(entry, guid);
+            }
+
+            entry.center = entry.center / static_cast<double>(region->placedNodeXformMap.size());
+
+            for (const auto& [guid, node] : region->placedNodeXformMap)
+            {
+                entry.radius = std::max(entry.radius, vsg::length(nodePosition(entry, guid) - entry.center));
+            }
+        }
+
+        for (const auto& [guid, node] : region->placedNodeXformMap)
+        {
+            for (const auto& child : node->children)
+            {
+                if (auto siegeNode = child.cast<SiegeNode>(); siegeNode != nullptr && siegeNode->mesh() != nullptr)
+                {
+                    nodeTree.insert(guid, NodeBVH::transform(transform->matrix * node->matrix, siegeNode->mesh()->bounds()));
+                }
+            }
+        }
+
+        entry.residency = region->computeResidency();
+        entry.lastVisible = frame;
+
+        placements[regionGuid] = {transform->matrix, entry.center, entry.radius, entry.residency.total()};
+        resident += entry.residency.total();
+
+        parent->addChild(transform);
+        placed.emplace(regionGuid, std::move(entry));
+
+        log->info("placed region 0x{:x}, {} regions holding {} bytes are in the graph", regionGuid, placed.size(), resident);
+    }
+
+    void RegionStreamer::remove(uint32_t regionGuid)
+    {
+        if (auto itr = placed.find(regionGuid); itr != placed.end())
+        {
+            auto& children = parent->children;
+            children.erase(std::remove(children.begin(), children.end(), itr->second.transform), children.end());
+
+            resident -= std::min(resident, itr->second.residency.total());
+            retired.push_back({frame, itr->second.transform});
+
+            for (const auto& [guid, node] : itr->second.region->placedNodeXformMap)
+            {
+                nodeTree.remove(guid);
+            }
+
+            placed.erase(itr);
+
+            log->info("dropped region 0x{:x}, {} regions holding {} bytes are in the graph", regionGuid, placed.size(), resident);
+        }
+    }
+
+    bool RegionStreamer::evict()
+    {
+        if (settings.budget == 0 || resident <= settings.budget) { return false; }
+
+        // least recently visible first, the one the camera is in and the ones visible right now are never evicted
+        std::vector<std::pair<uint64_t, uint32_t>> candidates;
+
+        for (const auto& [guid, entry] : placed)
+        {
+            if (guid != current && entry.lastVisible != frame) { candidates.emplace_back(entry.lastVisible, guid); }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+
+        bool changed = false;
+
+        for (const auto& [lastVisible, guid] : candidates)
+        {
+            if (resident <= settings.budget) { break; }
+
+            log->debug("evicting region 0x{:x}, last visible {} updates ago", guid, frame - lastVisible);
+
+            remove(guid);
+
+            ++evicted;
+            changed = true;
+        }
+
+        return changed;
+    }
+
+    double RegionStreamer::distance(const Placed& placed, const vsg::dvec3& point)
+    {
+        return std::max(0.0, vsg::length(point - placed.center) - placed.radius);
+    }
+
+    bool RegionStreamer::visible(const vsg::dvec3& center, double radius, const vsg::dvec3& camera, const vsg::dvec3& forward) const
+    {
+        const vsg::dvec3 offset = center - camera;
+        const double d = vsg::length(offset);
+
+        if (d <= radius) { return true; }
+
+        // the angle to the center less the angle the sphere takes up
+        const double angle = std::acos(std::clamp(vsg::dot(offset, forward) / d, -1.0, 1.0)) - std::asin(radius / d);
+
+        return angle <= vsg::radians(settings.fieldOfView * 0.5);
+    }
+
+    vsg::dvec3 RegionStreamer::nodePosition(const Placed& placed, uint32_t nodeGuid) const
+    {
+        const auto& nodes = placed.region->placedNodeXformMap;
+
+        if (const auto itr = nodes.find(nodeGuid); itr != nodes.end())
+        {
+            const vsg::dmat4 matrix = placed.transform->matrix * itr->second->matrix;
+
+            return vsg::dvec3(matrix[3][0], matrix[3][1], matrix[3][2]);
+        }
+
+        return placed.center;
+    }
+
+    std::unordered_map<uint32_t, uint32_t> RegionStreamer::hopsFrom(uint32_t regionGuid, uint32_t limit) const
+    {
+        std::unordered_map<uint32_t, uint32_t> hops = {{regionGuid, 0}};
+        std::vector<uint32_t> frontier = {regionGuid}, next;
+
+        for (uint32_t hop = 1; hop <= limit && !frontier.empty(); ++hop)
+        {
+            for (uint32_t guid : frontier)
+            {
+                if (const auto neighbours = adjacency.find(guid); neighbours != adjacency.end())
+                {
+                    for (const Neighbour& neighbour : neighbours->second)
+                    {
+                        if (hops.emplace(neighbour.region, hop).second) { next.push_back(neighbour.region); }
+                    }
+                }
+            }
+
+            frontier.swap(next);
+            next.clear();
+        }
+
+        return hops;
+    }
+
+    void RegionStreamer::work()
+    {
+        for (;;)
+        {
+            uint32_t guid = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                condition.wait(lock, [this]() { return stopping || !queue.empty(); });
+
+                if (stopping) { return; }
+
+                guid = queue.front();
+                queue.pop_front();
+            }
+
+            auto region = read(guid);
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            finished.emplace_back(guid, std::move(region));
+        }
+    }
+} // namespace ehb
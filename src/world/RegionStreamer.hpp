@@ -0,0 +1,190 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <vsg/io/Options.h>
+#include <vsg/maths/vec3.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/nodes/MatrixTransform.h>
+
+#include <spdlog/spdlog.h>
+
+#include "world/NodeBVH.hpp"
+#include "world/Region.hpp"
+#include "world/WorldMapData.hpp"
+
+namespace ehb
+{
+    class WorldPlacement;
+
+    /**
+     * keeps the regions around the camera in the graph. starting from a single region the ones next to it are read on
+     * background threads and stitched onto whichever of their neighbours is already placed as they come in, regions
+     * that end up too far away in distance or in stitches are taken out again. with a memory budget the regions that
+     * haven't been visible for the longest are evicted to stay under it, wherever a region was placed is remembered so
+     * it comes back in exactly the same spot when it is loaded again
+     */
+    class RegionStreamer final
+    {
+    public:
+        struct Settings
+        {
+            double radius = 150.0;        //! regions closer than this to the camera are loaded
+            uint32_t hops = 2;            //! as long as they are at most this many stitches from the one the camera is in
+            double prefetchSeconds = 2.0; //! distances are also measured from where the camera will be if it keeps moving
+            double unloadFactor = 1.5;    //! keeps a region from being dropped and loaded again at the edge of the radius
+            unsigned int threads = 2;
+            size_t budget = 0;            //! bytes the placed regions may hold, see Region::Residency, 0 for no limit
+            double fieldOfView = 90.0;    //! degrees, a region inside of it counts as visible
+            uint32_t framesInFlight = 3;  //! updates a taken out region is held on to, the gpu may still be drawing it
+        };
+
+        //! with a world placement regions go where it says instead of being stitched onto a neighbour, it has to outlive the streamer
+        RegionStreamer(const WorldMapDataCache::WorldMapData& world, vsg::ref_ptr<vsg::Options> options, vsg::ref_ptr<vsg::Group> parent, const Settings& settings, const WorldPlacement* worldPlacement = nullptr);
+        ~RegionStreamer();
+
+        //! load the region the camera starts in and place it at the origin, this blocks until it is read
+        bool start(uint32_t regionGuid);
+
+        /**
+         * stitch in what has finished loading, take out what's out of range and queue what's coming into range
+         * @param forward the direction the camera is looking in, used to tell which regions are visible
+         * @return whether the graph changed and has to be compiled
+         */
+        bool update(const vsg::dvec3& camera, const vsg::dvec3& forward, double deltaTime);
+
+        size_t placedCount() const;
+        size_t requestedCount() const;
+
+        //! the estimated bytes held by the placed regions
+        size_t residentBytes() const;
+
+        //! regions taken out to stay under the budget since the streamer started
+        size_t evictedCount() const;
+
+        //! the world space boxes of the nodes of every placed region, kept up to date as they come and go
+        const NodeBVH& nodes() const;
+
+    private:
+        //! one side of a stitch, the index only lists some of them under both regions
+        struct Neighbour
+        {
+            uint32_t region;
+            uint32_t node, door;           //! on this side
+            uint32_t otherNode, otherDoor; //! in the neighbouring region
+        };
+
+        struct Placed
+        {
+            vsg::ref_ptr<vsg::MatrixTransform> transform;
+            vsg::ref_ptr<Region> region;
+
+            //! a sphere around the origins of the nodes, in world space
+            vsg::dvec3 center;
+            double radius = 0.0;
+
+            Region::Residency residency;
+            uint64_t lastVisible = 0; //! the update it was last seen in
+        };
+
+        //! where a region was placed, kept after it is taken out
+        struct Placement
+        {
+            vsg::dmat4 matrix;
+            vsg::dvec3 center;
+            double radius = 0.0;
+            size_t bytes = 0;
+        };
+
+        //! taken out of the graph but held on to until the frames that might still draw it are done
+        struct Retired
+        {
+            uint64_t frame;
+            vsg::ref_ptr<vsg::Node> node;
+        };
+
+        vsg::ref_ptr<Region> read(uint32_t regionGuid) const;
+
+        //! @return false when none of the regions it is stitched to are placed anymore
+        bool place(uint32_t regionGuid, vsg::ref_ptr<Region> region);
+
+        void insert(uint32_t regionGuid, vsg::ref_ptr<Region> region, vsg::ref_ptr<vsg::MatrixTransform> transform);
+        void remove(uint32_t regionGuid);
+
+        //! evict the regions that haven't been visible for the longest until the placed ones fit the budget
+        bool evict();
+
+        //! @return the distance from the point to the sphere of a placed region, 0 when inside of it
+        static double distance(const Placed& placed, const vsg::dvec3& point);
+
+        //! @return whether any of the sphere is inside of the field of view, the forward direction has to be normalized
+        bool visible(const vsg::dvec3& center, double radius, const vsg::dvec3& camera, const vsg::dvec3& forward) const;
+
+        //! @return the world position of a node in a placed region
+        vsg::dvec3 nodePosition(const Placed& placed, uint32_t nodeGuid) const;
+
+        //! number of stitches from the region to every other one within the limit
+        std::unordered_map<uint32_t, uint32_t> hopsFrom(uint32_t regionGuid, uint32_t limit) const;
+
+        void work();
+
+        const WorldMapDataCache::WorldMapData& world;
+        const WorldPlacement* worldPlacement;
+        vsg::ref_ptr<vsg::Options> options;
+        vsg::ref_ptr<vsg::Group> parent;
+        Settings settings;
+
+        std::unordered_map<uint32_t, std::vector<Neighbour>> adjacency;
+
+        std::unordered_map<uint32_t, Placed> placed;
+        uint32_t current = 0; //! the region the camera is in or closest to
+
+        //! queued or being read by a worker
+        std::unordered_set<uint32_t> requested;
+
+        //! couldn't be read, these aren't asked for again
+        std::unordered_set<uint32_t> failed;
+
+        //! every region that has been placed, reloaded regions go back to the same matrix instead of being stitched again
+        std::unordered_map<uint32_t, Placement> placements;
+
+        std::deque<Retired> retired;
+
+        NodeBVH nodeTree;
+
+        uint64_t frame = 0;
+        size_t resident = 0;
+        size_t evicted = 0;
+
+        vsg::dvec3 lastCamera;
+        bool hasLastCamera = false;
+
+        // shared with the workers
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<uint32_t> queue;
+        std::vector<std::pair<uint32_t, vsg::ref_ptr<Region>>> finished;
+        bool stopping = false;
+
+        std::vector<std::thread> workers;
+
+        std::shared_ptr<spdlog::logger> log;
+    };
+
+    inline size_t RegionStreamer::placedCount() const { return placed.size(); }
+
+    inline size_t RegionStreamer::requestedCount() const { return requested.size(); }
+
+    inline size_t RegionStreamer::residentBytes() const { return resident; }
+
+    inline size_t RegionStreamer::evictedCount() const { return evicted; }
+
+    inline const NodeBVH& RegionStreamer::nodes() const { return nodeTree; }
+} // namespace ehb
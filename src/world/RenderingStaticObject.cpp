@@ -7,8 +7,10 @@
 #include <vsg/commands/DrawIndexed.h>
 #include <vsg/io/read.h>
 #include <vsg/nodes/Group.h>
+#include <vsg/nodes/StateGroup.h>
 #include <vsg/state/BindDescriptorSet.h>
 #include <vsg/state/DescriptorImage.h>
+#include <vsg/state/GraphicsPipeline.h>
 #include <vsg/utils/SharedObjects.h>
 
 namespace ehb
@@ -17,31 +19,17 @@ namespace ehb
     {
         auto sharedObjects = options->sharedObjects;
 
-        auto group = vsg::Group::create();
+        // the vertices are interleaved so the siege nodes bind their own pipeline, the state group puts back whatever
+        // was bound before for the rest of the graph
+        auto group = vsg::StateGroup::create();
 
-        // create our GPU arrays
-        // TODO: can we just setup sVertex in the pipeline rather than the individual components?
-        auto vertices = vsg::vec3Array::create(m_numVertices);
-        auto colors = vsg::uintArray::create(m_numVertices);
-        auto tcoords = vsg::vec2Array::create(m_numVertices);
-
-        for (auto i = 0; i < m_numVertices; ++i)
+        if (auto pipeline = options->getObject<vsg::BindGraphicsPipeline>("SiegeNodeInterleavedGraphicsPipeline"))
         {
-            auto softwareVertex = m_pVertices[i];
-
-            (*vertices)[i].x = softwareVertex.x;
-            (*vertices)[i].y = softwareVertex.y;
-            (*vertices)[i].z = softwareVertex.z;
-
-            (*tcoords)[i].x = softwareVertex.uv.u;
-            (*tcoords)[i].y = softwareVertex.uv.v;
+            group->stateCommands.push_back(vsg::ref_ptr<vsg::StateCommand>(const_cast<vsg::BindGraphicsPipeline*>(pipeline)));
         }
 
-        std::fill(std::begin(*colors), std::end(*colors), 0xFFFFFFFF);
-
-        sharedObjects->share(vertices);
-        sharedObjects->share(colors);
-        sharedObjects->share(tcoords);
+        // the buffer the mesh decoded its vertices into is handed over as it is
+        vsg::DataList vertexBuffers{m_vertexData};
 
         for (auto i = m_TexStageList.begin(); i != m_TexStageList.end(); ++i)
         {
@@ -52,6 +40,8 @@ namespace ehb
                 auto textureData = vsg::read_cast<vsg::Data>((*i).name, options);
                 sharedObjects->share(textureData);
 
+                (*i).textureBytes = textureData ? textureData->dataSize() : 0;
+
                 auto texture = vsg::DescriptorImage::create(vsg::Sampler::create(), textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
                 sharedObjects->share(texture);
 
@@ -67,15 +57,13 @@ namespace ehb
                 auto indices = vsg::ushortArray::create((*i).numVIndices);
                 indices->assign((*i).numVIndices, (*i).pVIndices);
 
-                // offset our indices since we are using a global vertex pool
-                std::transform(std::begin(*indices), std::end(*indices), std::begin(*indices), [&i](uint16_t v) -> uint16_t { return v + (*i).startIndex; });
-
                 sharedObjects->share(indices);
 
+                // the stages share one vertex buffer, the draw offsets into it so the indices don't have to be
                 auto commands = vsg::Commands::create();
-                commands->addChild(vsg::BindVertexBuffers::create(0, vsg::DataList{vertices, colors, tcoords}));
+                commands->addChild(vsg::BindVertexBuffers::create(0, vertexBuffers));
                 commands->addChild(vsg::BindIndexBuffer::create(indices));
-                commands->addChild(vsg::DrawIndexed::create(static_cast<uint32_t>(indices->valueCount()), 1, 0, 0, 0));
+                commands->addChild(vsg::DrawIndexed::create(static_cast<uint32_t>(indices->valueCount()), 1, 0, static_cast<int32_t>((*i).startIndex), 0));
 
                 sharedObjects->share(commands);
 
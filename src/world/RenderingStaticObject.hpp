@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <vsg/commands/Commands.h>
+#include <vsg/core/Array.h>
 #include <vsg/io/Options.h>
 
 namespace ehb
@@ -17,7 +18,7 @@ namespace ehb
         float u, v;
     };
 
-    // untransformed vertex with color and texture
+    // untransformed vertex with color and texture, this is also the layout of the interleaved vertex buffer
     struct sVertex
     {
         float x, y, z;
@@ -40,6 +41,9 @@ namespace ehb
         uint32_t numVIndices; // Number of indices in this stage
         uint32_t* pLIndices;  // Pointer to the lighting indices
         uint32_t numLIndices; // Number of lighting indices
+
+        // size of the texture data once it has been read, regions add these up to see how much memory they hold
+        size_t textureBytes = 0;
     };
 
     // static object texture info
@@ -70,7 +74,7 @@ namespace ehb
 
     public:
         RenderingStaticObject(sVertex* vertices, int32_t numVertices, uint16_t* indices, int32_t numIndices, uint32_t* textureTriCount, TexList& textureList);
-        RenderingStaticObject(vsg::ref_ptr<const vsg::Options> options, sVertex* pVertices, int32_t numVertices, int32_t numTriangles, TexStageList& stageList);
+        RenderingStaticObject(vsg::ref_ptr<const vsg::Options> options, vsg::ref_ptr<vsg::ubyteArray> vertexData, int32_t numVertices, int32_t numTriangles, TexStageList& stageList);
 
         ~RenderingStaticObject();
 
@@ -83,6 +87,9 @@ namespace ehb
 
         sVertex* vertices() { return m_pVertices; }
 
+        //! the vertices as they are handed to the gpu, vertices() points into it
+        vsg::ref_ptr<vsg::ubyteArray> vertexData() { return m_vertexData; }
+
         // VSG specific
         vsg::ref_ptr<vsg::Group> createOrShareBuildCommands();
 
@@ -97,6 +104,7 @@ namespace ehb
 
         TexStageList m_TexStageList;
         TexList m_texlist;
+        vsg::ref_ptr<vsg::ubyteArray> m_vertexData;
         sVertex* m_pVertices;
     };
 
@@ -106,8 +114,8 @@ namespace ehb
         organizeInformation(vertices, indices, textureTriCount);
     }
 
-    inline RenderingStaticObject::RenderingStaticObject(vsg::ref_ptr<const vsg::Options> options, sVertex* pVertices, int32_t numVertices, int32_t numTriangles, TexStageList& stageList) :
-        options(options), m_numVertices(numVertices), m_numTriangles(numTriangles), m_pVertices(pVertices), m_TexStageList(stageList)
+    inline RenderingStaticObject::RenderingStaticObject(vsg::ref_ptr<const vsg::Options> options, vsg::ref_ptr<vsg::ubyteArray> vertexData, int32_t numVertices, int32_t numTriangles, TexStageList& stageList) :
+        options(options), m_numVertices(numVertices), m_numTriangles(numTriangles), m_TexStageList(stageList), m_vertexData(vertexData), m_pVertices(reinterpret_cast<sVertex*>(vertexData->data()))
     {
         // Build up a default texture list
         StaticObjectTex tex;
@@ -129,8 +137,6 @@ namespace ehb
         }
 
         m_TexStageList.clear();
-
-        delete[] m_pVertices;
     }
 
     inline void RenderingStaticObject::organizeInformation(sVertex* verts, uint16_t* indices, uint32_t* textureTriCount)
@@ -180,7 +186,8 @@ namespace ehb
         }
 
         // Build vertices
-        m_pVertices = new sVertex[totalVertCount];
+        m_vertexData = vsg::ubyteArray::create(static_cast<uint32_t>(sizeof(sVertex) * totalVertCount));
+        m_pVertices = reinterpret_cast<sVertex*>(m_vertexData->data());
         memset(m_pVertices, 0, sizeof(sVertex) * totalVertCount);
 
         // Get a pointer to our vertex listing that we can fill up
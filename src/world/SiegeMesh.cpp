@@ -7,9 +7,10 @@
 
 namespace ehb
 {
-    bool SiegeMesh::load(BinaryReader& reader, SiegeMeshHeader const& header, vsg::ref_ptr<const vsg::Options> options)
+    SiegeMesh::SiegeMeshDoorList SiegeMesh::readDoors(BinaryReader& reader, SiegeMeshHeader const& header)
     {
-        // read door data
+        SiegeMeshDoorList doorList;
+
         for (uint32_t index = 0; index < header.m_numDoors; index++)
         {
             auto id = reader.read<uint32_t>();
@@ -35,6 +36,17 @@ namespace ehb
             doorList.emplace_back(std::make_unique<SiegeMeshDoor>(id, pos, orient));
         }
 
+        return doorList;
+    }
+
+    bool SiegeMesh::load(BinaryReader& reader, SiegeMeshHeader const& header, vsg::ref_ptr<const vsg::Options> options)
+    {
+        boundingBox = vsg::box(header.m_minBBox, header.m_maxBBox);
+        centroidOffset = header.m_centroidOffset;
+
+        // read door data
+        doorList = readDoors(reader, header);
+
         // read spot data
         for (uint32_t index = 0; index < header.m_numSpots; index++)
         {
@@ -43,18 +55,12 @@ namespace ehb
             auto tmp = reader.readString();
         }
 
-        m_pColors = new uint32_t[header.m_numVertices];
-
-        // experimental: create software mesh for easier lookup later
-        sVertex* pVertices = new sVertex[header.m_numVertices];
+        // the vertices are decoded once straight into the buffer the gpu draws from, which is also what the cpu side
+        // reads them from later. only the normals are kept on the side since they are only needed for lighting
+        auto vertexData = vsg::ubyteArray::create(static_cast<uint32_t>(header.m_numVertices * sizeof(sVertex)));
+        sVertex* pVertices = reinterpret_cast<sVertex*>(vertexData->data());
         m_pNormals = new vsg::vec3[header.m_numVertices];
 
-        // create vertex data per entire mesh
-        auto vertices = vsg::vec3Array::create(header.m_numVertices);
-        auto normals = vsg::vec3Array::create(header.m_numVertices);
-        auto colors = vsg::uintArray::create(header.m_numVertices);
-        auto tcoords = vsg::vec2Array::create(header.m_numVertices);
-
         // read in our vertex data
         for (uint32_t index = 0; index < header.m_numVertices; index++)
         {
@@ -64,23 +70,13 @@ namespace ehb
             nVertex.x = buildVertex.x;
             nVertex.y = buildVertex.y;
             nVertex.z = buildVertex.z;
+            nVertex.color = buildVertex.color;
             nVertex.uv = buildVertex.uv;
 
             vsg::vec3& nNormal = m_pNormals[index];
             nNormal.x = buildVertex.nx;
             nNormal.y = buildVertex.ny;
             nNormal.z = buildVertex.nz;
-
-            m_pColors[index] = buildVertex.color;
-
-            (*vertices)[index].x = nVertex.x;
-            (*vertices)[index].y = nVertex.y;
-            (*vertices)[index].z = nVertex.z;
-            (*normals)[index].x = nNormal.x;
-            (*normals)[index].y = nNormal.y;
-            (*normals)[index].z = nNormal.z;
-            (*tcoords)[index].x = nVertex.uv.u;
-            (*tcoords)[index].y = nVertex.uv.v;
         }
 
         TexStageList stageList;
@@ -104,7 +100,7 @@ namespace ehb
             stageList.push_back(nStage);
         }
 
-        m_pRenderObject = std::make_unique<RenderingStaticObject>(options, pVertices, header.m_numVertices, header.m_numTriangles, stageList);
+        m_pRenderObject = std::make_unique<RenderingStaticObject>(options, vertexData, header.m_numVertices, header.m_numTriangles, stageList);
 
         numLogicalMeshes = reader.read<uint32_t>();
         m_pLogicalMeshes = new SiegeLogicalMesh[numLogicalMeshes];
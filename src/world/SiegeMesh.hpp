@@ -86,9 +86,14 @@ namespace ehb
 
         bool load(BinaryReader& reader, SiegeMeshHeader const& header, vsg::ref_ptr<const vsg::Options> options);
 
+        //! the doors come right after the header so they can be read without the rest of the mesh
+        static SiegeMeshDoorList readDoors(BinaryReader& reader, SiegeMeshHeader const& header);
+
         RenderingStaticObject* renderObject() { return m_pRenderObject.get(); }
         vsg::vec3* normals() { return m_pNormals; }
-        uint32_t* colors() { return m_pColors; }
+
+        //! the box out of the header, in the space of the node
+        const vsg::box& bounds() const { return boundingBox; }
 
         const SiegeMeshDoorList& doors() const { return doorList; };
         SiegeMeshDoor* doorByIndex(uint32_t index) const;
@@ -118,19 +123,16 @@ namespace ehb
 
         uint32_t numLogicalMeshes;
         SiegeLogicalMesh* m_pLogicalMeshes;
-
-        uint32_t* m_pColors;
     };
 
     inline SiegeMesh::SiegeMesh() :
-        numDoors(0), numSpots(0), m_pNormals(nullptr), numStages(0), tiled(false), m_pColors(nullptr)
+        numDoors(0), numSpots(0), m_pNormals(nullptr), numStages(0), tiled(false)
     {
     }
 
     inline SiegeMesh::~SiegeMesh()
     {
         delete[] m_pNormals;
-        delete[] m_pColors;
         delete[] m_pLogicalMeshes;
     }
 
@@ -52,24 +52,37 @@ namespace ehb
 
         std::string address;
 
-        if (auto found = m_NodeGuidToNodeInfoDb.find(guid); found != m_NodeGuidToNodeInfoDb.end())
+        if (auto region = m_NodeDb.regionOf(guid))
         {
-            auto regionId = m_RegionIdToNameDb.find(found->second.m_RegionIndex); auto regionName = regionId->second;
             address = MakeMapDirAddress();
             address += "/regions/";
-            address += regionName;
+            address += region->name;
             address += "/terrain_nodes/siege_node_list/";
         }
 
         return address;
     }
 
+    RegionId WorldMap::GetNodeRegion(database_guid guid) const
+    {
+        const_cast <WorldMap*>(this)->CheckIndexesLoaded();
+
+        return m_NodeDb.regionForNode(guid);
+    }
+
+    const NodeDatabase& WorldMap::GetNodeDb() const
+    {
+        const_cast <WorldMap*>(this)->CheckIndexesLoaded();
+
+        return m_NodeDb;
+    }
+
     const std::string WorldMap::GetRegionName(RegionId id) const
     {
         const_cast <WorldMap*>(this)->CheckIndexesLoaded();
 
-        RegionIdToNameDb::const_iterator found = m_RegionIdToNameDb.find(id);
-        return ((found != m_RegionIdToNameDb.end()) ? found->second : "");
+        auto region = m_NodeDb.findRegion(id);
+        return ((region != nullptr) ? region->name : "");
     }
 
     std::string WorldMap::MakeRegionDirAddress(RegionId id) const
@@ -87,61 +100,30 @@ namespace ehb
 
     bool WorldMap::loadDatabases()
     {
+        std::vector<NodeDatabase::Region> regions;
+
         { // region guid to region name loading
             auto regionFolder = MakeMapDirAddress() + "/regions";
             for (auto region : fileSys.getDirectoryContents(regionFolder))
             {
-                if (auto doc = fileSys.openGasFile(region + "/main.gas"))
+                // only the guid is needed out of each region
+                if (auto doc = fileSys.openGasFile(region + "/main.gas", GasLoad::Lazy))
                 {
                     if (auto&& root = doc->child("region"))
                     {
-                        auto regionGuid = root->valueAsUInt("guid");
+                        auto regionGuid = root->valueAsGuid("guid");
                         auto regionName = region.substr(region.find_last_of("/") + 1, region.size());
 
-                        auto rc = m_RegionIdToNameDb.insert(std::make_pair(regionGuid, regionName));
-
-                        if (!rc.second)
-                        {
-                            spdlog::get("log")->error("Redefined region id {:08x}", regionGuid);
-                        }
+                        regions.push_back({regionGuid, regionName, region});
                     }
                 }
             }
         }
 
-        {
-            for (auto i = m_RegionIdToNameDb.begin(); i != m_RegionIdToNameDb.end(); ++i)
-            {
-                if (m_ClampingRegionGUID == i->first)
-                {
-                    loadNodeInfoDb(i->first);
-                }
-            }
-        }
-
-        return true;
-    }
-
-    bool WorldMap::loadNodeInfoDb(RegionId regionId)
-    {
-        auto nodeIndex = MakeRegionDirAddress(regionId) + "/index/streamer_node_index.gas";
-
-        if (auto doc = fileSys.openGasFile(nodeIndex))
-        {
-            auto streamer_index = doc->child("streamer_node_index");
-            for (auto&& index : streamer_index->eachAttribute())
-            {
-                auto nodeGuid = std::strtoul(index.value.c_str(), nullptr, 0);
-                
-                auto pair = std::make_pair(database_guid(nodeGuid), NodeInfo());
-                auto rc = m_NodeGuidToNodeInfoDb.emplace(pair);
-                if (!rc.second)
-                {
-                    spdlog::get("log")->error("nodeGuid {:08x} already exists for this region", nodeGuid);
-                }
-            }
-        }
+        // every region is indexed, even while streaming is clamped, so a node can be found no matter which region
+        // references it. the streamer_node_index.gas of each region is read on a worker thread
+        m_NodeDb.init(fileSys, std::move(regions));
 
         return true;
     }
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 
+#include "NodeDatabase.hpp"
 #include "SiegePos.hpp"
 
 namespace ehb
@@ -89,6 +90,9 @@ namespace ehb
 		std::string		MakeRegionDirAddress(RegionId id) const;
 
 		std::string		MakeNodeAddress(database_guid guid) const;
+		RegionId		GetNodeRegion(database_guid guid) const;
+
+		const NodeDatabase& GetNodeDb() const;
 
 		void RestrictStreamingToRegion(RegionId id) { m_ClampingRegionGUID = id; }
 		void UnrestrictStreaming() { RestrictStreamingToRegion(0); }
@@ -98,34 +102,11 @@ namespace ehb
 
 		bool loadDatabases();
 
-		bool loadNodeInfoDb(RegionId regionId);
-		
 		IFileSys& fileSys;
 
 		std::string m_MapName;
 
-		using RegionIdToNameDb = std::map <RegionId, std::string>;
-
-		// holds info about a node in the map
-		struct NodeInfo
-		{
-			uint32_t m_ScidIndex;								// starting index into m_ScidColl for
-			uint16_t  m_ScidCount;								// number of scids in this node
-			uint16_t  m_RegionIndex;							// index into m_RegionIdToNameDb for this node
-
-			NodeInfo ()
-			{
-				m_ScidIndex = 0xFFFFFFFF;
-				m_ScidCount = 0;
-				m_RegionIndex = 0xFFFF;
-			}
-		};
-		static_assert(sizeof(NodeInfo) == 8);			// guarantee i'm getting the size i want
-
-		using NodeGuidToNodeInfoDb = std::map <database_guid, NodeInfo>;
-
-		RegionIdToNameDb       m_RegionIdToNameDb;			// map of region id's to their internal region names
-		NodeGuidToNodeInfoDb   m_NodeGuidToNodeInfoDb;		// map of node guid's to node infoz
+		NodeDatabase m_NodeDb;								// every region and node of the map, sorted by guid
 
 		bool m_IndexesLoaded;
 		RegionId m_ClampingRegionGUID; // clamp streaming to this region (set to invalid region id when normal gameplay)
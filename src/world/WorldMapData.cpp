@@ -1,74 +1,97 @@
 
 #include "WorldMapData.hpp"
 
+#include "gas/FuelNumeric.hpp"
+#include "gas/FuelReader.hpp"
 #include "io/IFileSys.hpp"
 
+#include <vector>
+
 namespace ehb
 {
     void StitchIndex::init(IFileSys& fileSys, const std::string& path)
     {
         auto log = spdlog::get("log");
 
+        struct Entry
+        {
+            uint32_t region1;
+            Data stitch;
+        };
+
         std::unordered_map<uint32_t, uint32_t> node2region;
+        std::vector<Entry> entries;
 
-        if (auto doc = fileSys.openGasFile(path))
+        if (auto stream = fileSys.createInputStream(path))
         {
             log->info("parsing {}", path);
 
-            const auto root = doc->child("stitch_index");
+            // the regions are the stitch_index blocks inside the [stitch_index] root block
+            size_t depth = 0, regionDepth = 0;
+            uint32_t regionGuid = 0;
 
-            // first pass
-            for (const auto node : root->eachChild())
-            {
-                if (node->type() == "stitch_index")
-                {
-                    const uint32_t regionGuid = std::stoul(node->name(), nullptr, 16);
+            FuelReader reader;
 
-                    for (const auto entry : node->eachAttribute())
-                    {
-                        if (const auto itr = entry.value.find(','); itr != std::string::npos)
-                        {
-                            const uint32_t nodeGuid = std::stoul(entry.value.substr(0, itr), nullptr, 16);
+            reader.beginBlock = [&](std::string_view name, std::string_view type) {
+                if (depth == 0 && name != "stitch_index") { return FuelReader::Next::Skip; }
 
-                            node2region.emplace(nodeGuid, regionGuid);
+                if (depth == 1 && type == "stitch_index")
+                {
+                    if (const auto error = numeric::parseGuid(name, regionGuid); error != numeric::ParseError::None)
+                    {
+                        log->error("{}: skipping region '{}', {}", path, name, numeric::describe(error));
 
-                            // log->info("pairing {} with region {}", nodeGuid, regionGuid);
-                        }
+                        return FuelReader::Next::Skip;
                     }
+
+                    regionDepth = depth + 1;
                 }
-            }
 
-            // second pass
-            for (auto node : root->eachChild())
-            {
-                if (node->type() == "stitch_index")
+                ++depth;
+
+                return FuelReader::Next::Continue;
+            };
+
+            reader.endBlock = [&]() {
+                if (depth-- == regionDepth) { regionDepth = 0; }
+
+                return FuelReader::Next::Continue;
+            };
+
+            reader.attribute = [&](std::string_view, std::string_view, std::string_view value) {
+                if (regionDepth == 0 || depth != regionDepth) { return FuelReader::Next::Continue; }
+
+                // node1, door1, node2, door2 where the guids may be written with 64 bits of which only the low 32 are kept
+                Data stitch = {};
+
+                numeric::TupleReader tuple(value);
+                tuple.readGuid(stitch.node1).read(stitch.door1).readGuid(stitch.node2).read(stitch.door2);
+
+                if (const auto error = tuple.finish(); error != numeric::ParseError::None)
                 {
-                    const uint32_t regionGuid = std::stoul(node->name(), nullptr, 16);
+                    log->error("{}: skipping stitch '{}' in region {:08x}, {}", path, value, regionGuid, numeric::describe(error));
 
-                    for (const auto entry : node->eachAttribute())
-                    {
-                        const auto i1 = entry.value.find(',', 0);
-                        const auto i2 = entry.value.find(',', i1 + 1);
-                        const auto i3 = entry.value.find(',', i2 + 1);
-
-                        // we read this as a 64 bit value but only store 32, this was to workaround some weird errors in gas files
-                        const uint32_t node1 = std::stoul(entry.value.substr(0, i1), nullptr, 16);
-                        const uint32_t door1 = std::stoi(entry.value.substr(i1 + 1, i2 - i1 - 1));
-                        const uint32_t node2 = std::stoul(entry.value.substr(i2 + 1, i3 - i2 - 1), nullptr, 16);
-                        const uint32_t door2 = std::stoi(entry.value.substr(i3 + 1, std::string::npos));
-
-                        if (const auto itr = node2region.find(node2); itr != node2region.end())
-                        {
-                            const uint32_t region1 = regionGuid;
-                            const uint32_t region2 = itr->second;
-
-                            data[region1].emplace(region2, Data{node1, node2, door1, door2});
-                        }
-                        else
-                        {
-                            log->critical("invalid stitch map");
-                        }
-                    }
+                    return FuelReader::Next::Continue;
+                }
+
+                node2region.emplace(stitch.node1, regionGuid);
+                entries.push_back({regionGuid, stitch});
+
+                return FuelReader::Next::Continue;
+            };
+
+            if (!reader.read(*stream)) { log->error("{}: syntax error", path); }
+
+            // the region on the other side of a stitch may only show up further down the file
+            for (const auto& entry : entries)
+            {
+                if (const auto itr = node2region.find(entry.stitch.node2); itr != node2region.end())
+                {
+                    data[entry.region1].emplace(itr->second, entry.stitch);
+                }
+                else
+                {
+                    log->critical("invalid stitch map");
                 }
             }
         }
@@ -92,7 +115,7 @@ namespace ehb
 
         stitchIndex.init(fileSys, path + "/index/stitch_index.gas");
 
-        if (auto doc = fileSys.openGasFile(path + "/main.gas"))
+        if (auto doc = fileSys.openGasFile(path + "/main.gas", GasLoad::Lazy))
         {
             log->info("parsing main.gas for {}", path + "/main.gas");
 
@@ -101,16 +124,18 @@ namespace ehb
             screen_name = doc->valueOf("map:screen_name");
         }
 
+        std::vector<NodeDatabase::Region> regions;
+
         // handle each region
         for (auto regionfolder : fileSys.getDirectoryContents(path + "/regions"))
         {
             uint32_t regionGuid = 0;
 
-            if (auto doc = fileSys.openGasFile(regionfolder + "/main.gas"))
+            if (auto doc = fileSys.openGasFile(regionfolder + "/main.gas", GasLoad::Lazy))
             {
                 if (const auto root = doc->child("region"))
                 {
-                    regionGuid = root->valueAsUInt("guid");
+                    regionGuid = root->valueAsGuid("guid");
 
                     auto regionName = regionfolder.substr(regionfolder.find_last_of("/") + 1, regionfolder.size());
 
@@ -118,23 +143,14 @@ namespace ehb
                     nameMap.emplace(regionName, std::make_pair(regionfolder + ".region", regionGuid));
 
                     log->info("added {} - {} to the name map with path {}", regionName, regionGuid, regionfolder + ".region");
-                }
-            }
 
-            if (auto stream = fileSys.createInputStream(regionfolder + "/terrain_nodes/nodes.gas"))
-            {
-                std::string line;
-                while (std::getline(*stream, line))
-                {
-                    if (line.compare(1, 11, "[t:snode,n:") == 0)
-                    {
-                        const uint32_t nodeGuid = std::stoul(line.substr(12, 10), nullptr, 16);
-
-                        nodeMap.emplace(nodeGuid, regionGuid);
-                    }
+                    regions.push_back({regionGuid, regionName, regionfolder});
                 }
             }
         }
+
+        // the nodes of all the regions are read together on worker threads
+        nodes.init(fileSys, std::move(regions));
     }
 
     const std::pair<std::string, uint32_t>& WorldMapDataCache::WorldMapData::regionNameAndPathFromRegionGuid(uint32_t guid) const
@@ -159,8 +175,7 @@ namespace ehb
 
     uint32_t WorldMapDataCache::WorldMapData::regionForNode(uint32_t nodeGuid) const
     {
-        const auto itr = nodeMap.find(nodeGuid);
-        return itr != nodeMap.end() ? itr->second : 0;
+        return nodes.regionForNode(nodeGuid);
     }
 
     void WorldMapDataCache::init(IFileSys& fileSys)
@@ -7,6 +7,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include "world/NodeDatabase.hpp"
+
 namespace ehb
 {
     class IFileSys;
@@ -49,8 +51,8 @@ namespace ehb
             //! key: human readable name of the region, value: a pair that contains the main.gas path and the region guid
             std::unordered_map<std::string, std::pair<std::string, uint32_t>> nameMap;
 
-            //! key: a node guid, value: the region the guid belongs to
-            std::unordered_map<uint32_t, uint32_t> nodeMap;
+            //! every node of every region of the map
+            NodeDatabase nodes;
         };
 
         void init(IFileSys& fileSys);
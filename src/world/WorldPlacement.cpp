@@ -0,0 +1,144 @@
+#include "WorldPlacement.hpp"
+
+#include "io/IFileSys.hpp"
+#include "vsg/ReaderWriterSiegeMesh.hpp"
+#include "world/MeshDatabase.hpp"
+
+#include <limits>
+
+#include <vsg/io/FileSystem.h>
+
+namespace ehb
+{
+    bool WorldPlacement::init(IFileSys& fileSys, const WorldMapDataCache::WorldMapData& world, vsg::ref_ptr<const vsg::Options> options, uint32_t rootRegion)
+    {
+        auto log = spdlog::get("log");
+
+        solver = {};
+        targetNodes.clear();
+        meshBoxes.clear();
+
+        auto meshDatabase = options->getObject<MeshDatabase>("MeshDatabase");
+
+        if (meshDatabase == nullptr)
+        {
+            log->critical("WorldPlacement needs the MeshDatabase to find the doors of the nodes");
+
+            return false;
+        }
+
+        // the same keys ReaderWriterSiegeNodeList reads
+        static const struct
+        {
+            FuelPath siegeNodeList{"siege_node_list"}, targetNode{"siege_node_list:targetnode"};
+            FuelPath guid{"guid"}, meshGuid{"mesh_guid"};
+            FuelPath id{"id"}, farDoor{"fardoor"}, farGuid{"farguid"};
+        } keys;
+
+        // key: mesh guid, value: the index of its doors in the solver, a mesh that couldn't be read has none
+        std::unordered_map<uint32_t, uint32_t> meshIndex;
+
+        auto doorsOf = [&](uint32_t meshGuid) -> uint32_t {
+            if (auto itr = meshIndex.find(meshGuid); itr != meshIndex.end()) { return itr->second; }
+
+            uint32_t index = std::numeric_limits<uint32_t>::max();
+
+            if (auto filename = meshDatabase->FindFileName(meshGuid))
+            {
+                // only the doors are read, the rest of the mesh isn't needed to place it
+                if (auto fullFilePath = vsg::findFile(filename, options); !fullFilePath.empty())
+                {
+                    if (auto stream = fileSys.createInputStream(fullFilePath.string() + ".sno"))
+                    {
+                        SiegeMesh::SiegeMeshDoorList doors;
+                        SiegeMeshHeader header;
+
+                        if (ReaderWriterSiegeMesh::readDoors(*stream, doors, &header))
+                        {
+                            index = solver.addMesh(doors);
+                            meshBoxes.emplace(meshGuid, vsg::box(header.m_minBBox, header.m_maxBBox));
+                        }
+                    }
+                }
+            }
+
+            if (index == std::numeric_limits<uint32_t>::max()) { log->error("unable to read the doors of mesh 0x{:x}", meshGuid); }
+
+            return meshIndex[meshGuid] = index;
+        };
+
+        for (const auto& [name, entry] : world.nameMap)
+        {
+            const auto& [path, regionGuid] = entry;
+
+            auto nodesdotgas = vsg::removeExtension(vsg::Path(path)) + "/terrain_nodes/nodes.gas";
+
+            auto doc = fileSys.openGasFile(nodesdotgas.string());
+
+            if (doc == nullptr)
+            {
+                log->error("unable to read the nodes of region {}", name);
+
+                continue;
+            }
+
+            for (const auto node : doc->eachChildOf(keys.siegeNodeList))
+            {
+                const uint32_t nodeGuid = node->valueAsGuid(keys.guid);
+
+                solver.addNode(nodeGuid, doorsOf(node->valueAsGuid(keys.meshGuid)));
+
+                for (const auto door : node->eachChild())
+                {
+                    solver.addConnection(nodeGuid, door->valueAsInt(keys.id), door->valueAsGuid(keys.farGuid), door->valueAsInt(keys.farDoor));
+                }
+            }
+
+            targetNodes.emplace(regionGuid, doc->valueAsGuid(keys.targetNode));
+        }
+
+        // the stitches are what connects the regions to each other
+        for (const auto& [region1, stitches] : world.stitchIndex.data)
+        {
+            for (const auto& [region2, stitch] : stitches)
+            {
+                solver.addConnection(stitch.node1, stitch.door1, stitch.node2, stitch.door2);
+            }
+        }
+
+        const auto root = targetNodes.find(rootRegion);
+
+        if (root == targetNodes.end())
+        {
+            log->critical("the root region 0x{:x} of the world placement wasn't read", rootRegion);
+
+            return false;
+        }
+
+        const size_t placed = solver.solve(root->second);
+
+        for (const auto& cycle : solver.inconsistencies())
+        {
+            log->warn("nodes 0x{:x} and 0x{:x} don't line up through their doors, off by {} and {} in rotation", cycle.node1, cycle.node2, cycle.distance, cycle.rotation);
+        }
+
+        log->info("placed {} of {} nodes in {} regions, {} connections couldn't be resolved and {} are inconsistent", placed, solver.nodeCount(), targetNodes.size(), solver.unresolvedCount(), solver.inconsistencies().size());
+
+        return true;
+    }
+
+    const vsg::dmat4* WorldPlacement::regionTransform(uint32_t regionGuid) const
+    {
+        // a region is read with its target node at the origin so the node is where the region goes
+        if (const auto itr = targetNodes.find(regionGuid); itr != targetNodes.end()) { return solver.transform(itr->second); }
+
+        return nullptr;
+    }
+
+    const vsg::box* WorldPlacement::meshBounds(uint32_t meshGuid) const
+    {
+        if (const auto itr = meshBoxes.find(meshGuid); itr != meshBoxes.end()) { return &itr->second; }
+
+        return nullptr;
+    }
+} // namespace ehb
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <vsg/io/Options.h>
+#include <vsg/maths/box.h>
+#include <vsg/maths/mat4.h>
+
+#include <spdlog/spdlog.h>
+
+#include "world/PlacementSolver.hpp"
+#include "world/WorldMapData.hpp"
+
+namespace ehb
+{
+    class IFileSys;
+
+    /**
+     * where every node and region of a world ends up, worked out up front from the nodes.gas of every region and the
+     * doors of the meshes they use. nothing has to be loaded to find out where a region goes, which lets any part of
+     * the world be placed without its neighbours
+     */
+    class WorldPlacement final
+    {
+    public:
+        /**
+         * the root region is placed at the origin the same way a region is when it is loaded on its own
+         * @return false when the root region couldn't be read
+         */
+        bool init(IFileSys& fileSys, const WorldMapDataCache::WorldMapData& world, vsg::ref_ptr<const vsg::Options> options, uint32_t rootRegion);
+
+        //! @return the matrix the region goes under or nullptr if it couldn't be placed
+        const vsg::dmat4* regionTransform(uint32_t regionGuid) const;
+
+        //! @return the world transform of a node or nullptr if it couldn't be placed
+        const vsg::dmat4* nodeTransform(uint32_t nodeGuid) const;
+
+        //! @return the bounding box of a mesh whose doors were read or nullptr
+        const vsg::box* meshBounds(uint32_t meshGuid) const;
+
+        const std::vector<PlacementSolver::Inconsistency>& inconsistencies() const;
+
+        size_t regionCount() const;
+
+    private:
+        PlacementSolver solver;
+
+        //! key: the region guid, value: the node that is at the origin of the region when it is loaded
+        std::unordered_map<uint32_t, uint32_t> targetNodes;
+
+        //! key: mesh guid, value: the bounding box out of its header
+        std::unordered_map<uint32_t, vsg::box> meshBoxes;
+    };
+
+    inline const vsg::dmat4* WorldPlacement::nodeTransform(uint32_t nodeGuid) const { return solver.transform(nodeGuid); }
+
+    inline const std::vector<PlacementSolver::Inconsistency>& WorldPlacement::inconsistencies() const { return solver.inconsistencies(); }
+
+    inline size_t WorldPlacement::regionCount() const { return targetNodes.size(); }
+} // namespace ehb